@@ -15,6 +15,7 @@ import random      # Random number generation for obstacles and clouds
 import serial      # Serial communication with STM32
 import threading   # Multi-threading for serial communication
 import os          # Operating system interface for file operations
+import dino_protocol  # Binary frame protocol shared with the STM32 firmware
 
 # ======================= SCREEN CONFIGURATION =======================
 SCREEN_WIDTH = 800    # Game window width in pixels
@@ -550,8 +551,11 @@ class Serial:
         self.COM_port = COM_port               # Serial port identifier
         self.baud_rate = baud_rate             # Communication baud rate
         self.serial_thread_running = False     # Thread control flag
-        self.received_data = ""                # Buffer for incoming data
+        self.received_messages = []            # Decoded (msg_id, payload) messages
+        self.decoder = dino_protocol.Decoder() # Streaming frame decoder
         self.COM_jump = False                  # Jump command flag from MCU
+        self.telemetry = None                  # Last telemetry counters from MCU
+        self.power = None                      # Last power report from MCU
         self.serial_port = None                # Serial port object
         
         # Thread safety: Lock for COM_jump variable access
@@ -620,47 +624,72 @@ class Serial:
         Read incoming data from serial port
         
         Non-blocking read that processes any available data.
-        Data is expected to be newline-terminated strings.
+        Data is a stream of COBS encoded frames (see dino_protocol.py).
         """
         if self.serial_port and self.serial_port.in_waiting > 0:
-            # Read one line of data
-            data = self.serial_port.readline()
-            # Decode and clean the received data
-            self.received_data = data.decode('utf-8').strip()
+            # Read everything available and decode the complete frames
+            data = self.serial_port.read(self.serial_port.in_waiting)
+            self.received_messages += self.decoder.feed(data)
 
     def decode_data_from_com_port(self):
         """
-        Process and interpret received serial data
+        Process and interpret received serial messages
         
         Current protocol:
-        - "J" = Jump command from microcontroller
+        - MSG_JUMP = Jump command from microcontroller
+        - MSG_TELEMETRY = Button to TX latency report (last us, max us, presses, bounces)
+        - MSG_POWER = Idle report (sleep ms, STOP count, last/max wake latency us)
         - Can be extended for other commands (pause, restart, etc.)
         
         Thread-safe implementation with lock protection for COM_jump.
         """
-        if self.received_data == "J":
-            # Thread-safe write to COM_jump flag
-            with self.com_jump_lock:
-                self.COM_jump = True           # Set jump flag for game loop
-            self.received_data = ''            # Clear buffer after processing
+        for msg_id, payload in self.received_messages:
+            if msg_id == dino_protocol.MSG_JUMP:
+                # Thread-safe write to COM_jump flag
+                with self.com_jump_lock:
+                    self.COM_jump = True       # Set jump flag for game loop
+            elif msg_id == dino_protocol.MSG_TELEMETRY:
+                self.telemetry = dino_protocol.decode_telemetry(payload)
+                if len(self.telemetry) >= 2:
+                    print(f"Jump latency: {self.telemetry[0]} us (max {self.telemetry[1]} us)")
+            elif msg_id == dino_protocol.MSG_POWER:
+                self.power = dino_protocol.decode_telemetry(payload)
+                if len(self.power) >= 4:
+                    print(f"MCU idle: {self.power[0]} ms asleep, {self.power[1]} STOP, "
+                          f"wake latency {self.power[2]} us (max {self.power[3]} us)")
+        self.received_messages = []            # Clear buffer after processing
     
-    def send_to_com_port(self, data):
+    def send_to_com_port(self, frame):
         """
-        Send data to the serial port
-        
-        Transmits data to connected microcontroller. Used primarily
-        for sending real-time jump height percentage.
+        Send a frame to the serial port
         
         Args:
-            data: Data to send (will be converted to string and newline-terminated)
+            frame (bytes): Encoded frame built by dino_protocol
         """
         if self.serial_port and self.serial_port.is_open:
             try:
-                # Send data with newline terminator
-                self.serial_port.write(f"{data}\n".encode('utf-8'))
+                self.serial_port.write(frame)
             except serial.SerialException as e:
                 print(f"Error sending data to serial port {self.COM_port}: {e}")
 
+    def send_height(self, height_perc):
+        """
+        Send the real-time jump height to the microcontroller
+        
+        Args:
+            height_perc (int): Jump height percentage (0..100)
+        """
+        self.send_to_com_port(dino_protocol.encode_height(height_perc))
+
+    def send_score(self, score):
+        """
+        Send the current score to the microcontroller
+        
+        Args:
+            score (int): Current score
+        """
+        self.send_to_com_port(dino_protocol.encode_score(score))
+
 class Dropdown:
     """
     Dropdown menu UI component for serial port configuration
@@ -1001,7 +1030,8 @@ class DinoGame:
         
         # Initialize jump analytics and send initial data to STM32
         self.dino.Init_highest_jumping_position()
-        self.COM_port.send_to_com_port(self.dino.dino_jump_height_perc)
+        self.COM_port.send_height(self.dino.dino_jump_height_perc)
+        self.COM_port.send_score(self.score)
     
     def handle_game_state(self):
         """
@@ -1183,6 +1213,7 @@ class DinoGame:
                 # Check for score progression (when dino passes obstacles)
                 if self.obstacles.obstacle_removed == True:
                     self.score += 1
+                    self.COM_port.send_score(self.score)
                     
                     # Increase difficulty every 5 points
                     if self.score % 5 == 0:
@@ -1205,7 +1236,7 @@ class DinoGame:
                     self.dino.jump_Dino_jump(self.screen)
                     # Calculate and send jump height percentage to STM32
                     self.dino.Dino_jump_height_perc()
-                    self.COM_port.send_to_com_port(self.dino.dino_jump_height_perc)
+                    self.COM_port.send_height(self.dino.dino_jump_height_perc)
 
                 # Update and draw obstacles
                 self.obstacles.draw_obstacles(self.screen)
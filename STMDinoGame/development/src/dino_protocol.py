@@ -0,0 +1,149 @@
+"""
+Binary frame protocol between STMDinoGame and the STM32 firmware
+
+This module mirrors header/dino_protocol.h and src/dino_protocol.c of the firmware:
+- Frame (before encoding): header | payload (0..16 bytes) | CRC-8
+- Header = (PROTOCOL_VERSION << 5) | message ID
+- CRC-8/SMBUS (poly 0x07, init 0x00) over header and payload
+- On the wire the frame is COBS encoded and terminated by a single 0x00 byte
+"""
+
+import struct
+
+# ======================= PROTOCOL CONSTANTS =======================
+PROTOCOL_VERSION = 1     # Carried in the 3 upper bits of the header
+MAX_PAYLOAD      = 16    # Maximum payload size in bytes
+
+# Message IDs (must match DINO_MSG_* in dino_protocol.h)
+MSG_JUMP      = 0x01     # Board to host, no payload
+MSG_HEIGHT    = 0x02     # Host to board, uint8: 0 (ground) to 255 (highest point)
+MSG_SCORE     = 0x03     # Host to board, uint32 little endian
+MSG_TELEMETRY = 0x04     # Board to host, up to 4 uint32 little endian counters
+MSG_POWER     = 0x05     # Board to host, 4 uint32 little endian: sleep ms, STOP count, last/max wake latency (us)
+
+
+def _make_crc8_table():
+    """Build the CRC-8/SMBUS lookup table"""
+    table = []
+    for i in range(256):
+        crc = i
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+        table.append(crc)
+    return table
+
+_CRC8_TABLE = _make_crc8_table()
+
+
+def crc8(data):
+    """Compute the CRC-8/SMBUS of a bytes-like object"""
+    crc = 0
+    for byte in data:
+        crc = _CRC8_TABLE[crc ^ byte]
+    return crc
+
+
+def cobs_encode(data):
+    """COBS encode data (without the trailing 0x00 delimiter)"""
+    out = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+        else:
+            out.append(byte)
+            code += 1
+            if code == 0xFF:
+                out[code_index] = code
+                code_index = len(out)
+                out.append(0)
+                code = 1
+    out[code_index] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """COBS decode data (without the delimiter), returns None on error"""
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0:
+            return None
+        index += 1
+        block = data[index:index + code - 1]
+        if len(block) != code - 1 or 0 in block:
+            return None
+        out += block
+        index += code - 1
+        if code != 0xFF and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode(msg_id, payload=b""):
+    """Build a complete frame (COBS encoded, 0x00 terminated) ready to be written to the serial port"""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    raw = bytes([(PROTOCOL_VERSION << 5) | (msg_id & 0x1F)]) + bytes(payload)
+    raw += bytes([crc8(raw)])
+    return cobs_encode(raw) + b"\x00"
+
+
+def encode_height(height_perc):
+    """Build a HEIGHT frame from a jump height percentage (0..100)"""
+    height_perc = max(0, min(100, int(height_perc)))
+    return encode(MSG_HEIGHT, bytes([(height_perc * 255 + 50) // 100]))
+
+
+def encode_score(score):
+    """Build a SCORE frame"""
+    return encode(MSG_SCORE, struct.pack("<I", score & 0xFFFFFFFF))
+
+
+def decode_telemetry(payload):
+    """Decode a TELEMETRY payload into a tuple of uint32 counters"""
+    count = len(payload) // 4
+    return struct.unpack("<%dI" % count, bytes(payload[:count * 4]))
+
+
+class Decoder:
+    """
+    Streaming frame decoder
+
+    Feed it the bytes read from the serial port, it returns the complete
+    (msg_id, payload) messages. Invalid frames are counted and dropped.
+    """
+
+    def __init__(self):
+        self.buffer = bytearray()   # Bytes of the frame being received
+        self.overflow = False       # The frame being received is too long
+        self.frame_count = 0        # Number of valid frames
+        self.error_count = 0        # Number of discarded frames
+
+    def feed(self, data):
+        """Decode data, returns a list of (msg_id, payload) tuples"""
+        messages = []
+        for byte in data:
+            if byte != 0:
+                if len(self.buffer) < MAX_PAYLOAD + 3:
+                    self.buffer.append(byte)
+                else:
+                    self.overflow = True
+                continue
+            frame, overflow = bytes(self.buffer), self.overflow
+            self.buffer, self.overflow = bytearray(), False
+            if not frame:
+                continue  # Empty frame, used to resynchronize
+            raw = None if overflow else cobs_decode(frame)
+            if (raw is None or len(raw) < 2 or len(raw) > MAX_PAYLOAD + 2
+                    or (raw[0] >> 5) != PROTOCOL_VERSION or crc8(raw) != 0):
+                self.error_count += 1
+                continue
+            self.frame_count += 1
+            messages.append((raw[0] & 0x1F, raw[1:-1]))
+        return messages
@@ -0,0 +1,80 @@
+#ifndef BOARD_H
+#define BOARD_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_rcc_driver.h"
+#include "timebase.h"
+
+/*  Table driven board bring-up.
+    The board is described by const tables (kept in flash): peripheral clocks, pins and EXTI interrupts.
+    Board_Init merges them before touching the hardware:
+    - one write per RCC enable register, the port clocks of the pins and SYSCFG (EXTI) are added automatically,
+    - one read-modify-write per GPIO register of each used port (AFRL/AFRH, OTYPER, OSPEEDR, PUPDR, then MODER),
+    - one write per SYSCFG_EXTICR and EXTI register, then the priority and enable of each EXTI interrupt.
+    The interrupts of the other peripherals are set by their drivers (e.g, USART_IT_Init), which keep the priority.
+    Adding a pin is one table entry. The init duration is measured, Timebase_Init must be called first. */
+
+/*Board_Port: GPIO port index*/
+#define BOARD_PORT_A                0U
+#define BOARD_PORT_B                1U
+#define BOARD_PORT_C                2U
+#define BOARD_PORT_D                3U
+#define BOARD_PORT_E                4U
+#define BOARD_PORT_F                5U
+#define BOARD_PORT_G                6U
+#define BOARD_PORT_H                7U
+#define BOARD_PORT_I                8U
+#define BOARD_PORT_NUM              9U
+
+/*Board_Bus: RCC enable register of a peripheral clock*/
+#define BOARD_BUS_AHB1              0U      /*RCC_AHB1ENR*/
+#define BOARD_BUS_APB1              1U      /*RCC_APB1ENR*/
+#define BOARD_BUS_APB2              2U      /*RCC_APB2ENR*/
+#define BOARD_BUS_NUM               3U
+
+/*Number of entries of a board table*/
+#define BOARD_TABLE_SIZE(Table)     ((uint8_t)(sizeof(Table) / sizeof((Table)[0])))
+
+/*Peripheral clock*/
+typedef struct
+{
+    uint8_t Bus;                        /*@ref Board_Bus*/
+    uint8_t Bit;                        /*Enable bit in the bus register (e.g, RCC_APB1ENR_USART3EN)*/
+} Board_ClockDesc_t;
+
+/*Pin configuration*/
+typedef struct
+{
+    uint8_t Port;                       /*@ref Board_Port*/
+    uint8_t Pin;                        /*GPIO pin number*/
+    uint8_t Mode;                       /*GPIO pin mode*/
+    uint8_t OutType;                    /*GPIO output type*/
+    uint8_t PUPD;                       /*Pull-up/pull-down resistor selection*/
+    uint8_t Speed;                      /*GPIO output speed*/
+    uint8_t AltFunc;                    /*Alternate function*/
+} Board_PinDesc_t;
+
+/*EXTI interrupt of a pin*/
+typedef struct
+{
+    uint8_t Port;                       /*@ref Board_Port*/
+    uint8_t Pin;                        /*GPIO pin number, it is also the EXTI line*/
+    uint8_t EdgeTrigger;                /*Edge trigger selection, GPIO_IT_EDGE_FT, GPIO_IT_EDGE_RT or both (any other value)*/
+    uint8_t Priority;                   /*Priority of the EXTI interrupt*/
+} Board_ExtiDesc_t;
+
+/*Board description*/
+typedef struct
+{
+    const Board_ClockDesc_t * pClocks;
+    uint8_t ClockNum;
+    const Board_PinDesc_t * pPins;
+    uint8_t PinNum;
+    const Board_ExtiDesc_t * pExtis;
+    uint8_t ExtiNum;
+} Board_Conf_t;
+
+uint8_t Board_Init(const Board_Conf_t * pConf);
+uint32_t Board_GetInitCycles(void);
+uint32_t Board_GetInitUs(void);
+#endif
@@ -0,0 +1,48 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+#include "stm32f407xx.h"
+#include "ring_buffer.h"
+
+/*  Sampling debouncer for several buttons.
+    Buttons_Tick reads the IDR of each configured port once per tick and runs a 2 bit vertical counter
+    for all 16 pins of the port at the same time: a pin changes its debounced state after
+    BUTTONS_INTEGRATOR_SAMPLES consecutive samples at the new level. The integrator cost does not depend
+    on the number of buttons, only the pins with a pending long press are looked at one by one.
+    The events are queued as one byte each in a ring buffer: Buttons_Tick is the producer and
+    the application (e.g, the main loop) the consumer. */
+
+/*Buttons configuration structure*/
+typedef struct
+{
+    uint16_t TickPeriod;        /*  Period of the Buttons_Tick calls in ms, the debounce time is
+                                    BUTTONS_INTEGRATOR_SAMPLES * TickPeriod*/
+    uint16_t LongPressTime;     /*  Time in ms a button must be held to report a long press*/
+    uint16_t DoublePressTime;   /*  Maximum time in ms between a release and the next press to report a double press*/
+} Buttons_Conf_t;
+
+/*Number of consecutive samples needed to change the debounced state of a pin*/
+#define BUTTONS_INTEGRATOR_SAMPLES  4U
+
+/*Maximum number of ports*/
+#define BUTTONS_PORT_MAX            4U
+
+/*Returned by Buttons_AddPort when the port can not be added*/
+#define BUTTONS_PORT_INVALID        0xFFU
+
+/*Buttons_Event_Type*/
+#define BUTTONS_EVT_PRESS           0U      /*The button is pressed*/
+#define BUTTONS_EVT_RELEASE         1U      /*The button is released*/
+#define BUTTONS_EVT_LONG            2U      /*The button is held for LongPressTime*/
+#define BUTTONS_EVT_DOUBLE          3U      /*Second press within DoublePressTime, reported after its PRESS event*/
+
+/*  Event byte: | Port [7:6] | Type [5:4] | Pin [3:0] | */
+#define BUTTONS_EVT(Port, Type, Pin)    ((uint8_t)(((Port) << 6) | ((Type) << 4) | (Pin)))
+#define BUTTONS_EVT_PORT(Event)         (((Event) >> 6) & 0x03U)
+#define BUTTONS_EVT_TYPE(Event)         (((Event) >> 4) & 0x03U)
+#define BUTTONS_EVT_PIN(Event)          ((Event) & 0x0FU)
+
+uint8_t Buttons_Init(Buttons_Conf_t Buttons_Conf, RingBuf_t * pEventQueue);
+uint8_t Buttons_AddPort(GPIO_RegDef_t * GPIOx, uint16_t PinMask, uint16_t ActiveLowMask);
+void Buttons_Tick(void);
+uint16_t Buttons_GetState(uint8_t Port);
+#endif
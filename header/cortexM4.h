@@ -22,21 +22,239 @@ typedef struct
 /*NVIC base address*/
 #define NVIC    ((NVIC_RegDef_t *) (0xE000E100UL))
 
+/*Number of priority bits implemented by the STM32F4 (bits [7:4] of each priority field), priorities are in [0..15]*/
+#define NVIC_PRIO_BITS      4U
+
+typedef struct
+{
+    volatile uint32_t CTRL;             /*Control register*/
+    volatile uint32_t CYCCNT;           /*Cycle count register*/
+    volatile uint32_t CPICNT;           /*CPI count register*/
+    volatile uint32_t EXCCNT;           /*Exception overhead count register*/
+    volatile uint32_t SLEEPCNT;         /*Sleep count register*/
+    volatile uint32_t LSUCNT;           /*LSU count register*/
+    volatile uint32_t FOLDCNT;          /*Folded-instruction count register*/
+} DWT_RegDef_t;
+
+/*Data watchpoint and trace unit base address*/
+#define DWT     ((DWT_RegDef_t *) (0xE0001000UL))
+
+typedef struct
+{
+    volatile uint32_t CPUID;            /*CPUID base register*/
+    volatile uint32_t ICSR;             /*Interrupt control and state register*/
+    volatile uint32_t VTOR;             /*Vector table offset register*/
+    volatile uint32_t AIRCR;            /*Application interrupt and reset control register*/
+    volatile uint32_t SCR;              /*System control register*/
+    volatile uint32_t CCR;              /*Configuration and control register*/
+    volatile uint32_t SHPR[3];          /*System handler priority registers*/
+    volatile uint32_t SHCSR;            /*System handler control and state register*/
+    volatile uint32_t CFSR;             /*Configurable fault status register*/
+    volatile uint32_t HFSR;             /*HardFault status register*/
+    volatile uint32_t DFSR;             /*Debug fault status register*/
+    volatile uint32_t MMFAR;            /*MemManage fault address register*/
+    volatile uint32_t BFAR;             /*BusFault address register*/
+    volatile uint32_t AFSR;             /*Auxiliary fault status register*/
+} SCB_RegDef_t;
+
+/*System control block base address*/
+#define SCB     ((SCB_RegDef_t *) (0xE000ED00UL))
+
+/*SCB_ICSR register bits*/
+#define SCB_ICSR_PENDSTCLR  25U         /*PENDSTCLR: Clear the pending SysTick exception*/
+#define SCB_ICSR_PENDSTSET  26U         /*PENDSTSET: Pend the SysTick exception*/
+#define SCB_ICSR_PENDSVCLR  27U         /*PENDSVCLR: Clear the pending PendSV exception*/
+#define SCB_ICSR_PENDSVSET  28U         /*PENDSVSET: Pend the PendSV exception*/
+
+/*SCB_SHPR3 priority fields (SCB->SHPR[2])*/
+#define SCB_SHPR3_PRI_PENDSV    16U     /*PRI_14[7:0]: PendSV priority*/
+#define SCB_SHPR3_PRI_SYSTICK   24U     /*PRI_15[7:0]: SysTick priority*/
+
+/*SCB_AIRCR register bits*/
+#define SCB_AIRCR_PRIGROUP  8U          /*PRIGROUP[2:0]: Priority grouping*/
+#define SCB_AIRCR_VECTKEY   16U         /*VECTKEY[15:0]: Register key, 0x05FA must be written*/
+#define SCB_AIRCR_VECTKEY_VALUE 0x05FAU
+
+/*NVIC_Priority_Group: number of preemption priority bits / subpriority bits (PRIGROUP values)*/
+#define NVIC_PRIORITYGROUP_0    7U      /*0 bits of preemption priority, 4 bits of subpriority*/
+#define NVIC_PRIORITYGROUP_1    6U      /*1 bit of preemption priority, 3 bits of subpriority*/
+#define NVIC_PRIORITYGROUP_2    5U      /*2 bits of preemption priority, 2 bits of subpriority*/
+#define NVIC_PRIORITYGROUP_3    4U      /*3 bits of preemption priority, 1 bit of subpriority*/
+#define NVIC_PRIORITYGROUP_4    3U      /*4 bits of preemption priority, 0 bits of subpriority (reset value)*/
+
+/*SCB_SCR register bits*/
+#define SCB_SCR_SLEEPONEXIT 1U          /*SLEEPONEXIT: Sleep when returning from the handler mode to the thread mode*/
+#define SCB_SCR_SLEEPDEEP   2U          /*SLEEPDEEP: Deep sleep (STOP/STANDBY) on WFI/WFE*/
+#define SCB_SCR_SEVONPEND   4U          /*SEVONPEND: A new pending interrupt is a WFE wakeup event*/
+
+typedef struct
+{
+    volatile uint32_t CTRL;             /*SysTick control and status register*/
+    volatile uint32_t LOAD;             /*SysTick reload value register*/
+    volatile uint32_t VAL;              /*SysTick current value register*/
+    volatile uint32_t CALIB;            /*SysTick calibration value register*/
+} SYSTICK_RegDef_t;
+
+/*SysTick base address*/
+#define SYSTICK ((SYSTICK_RegDef_t *) (0xE000E010UL))
+
+/*SYSTICK_CTRL register bits*/
+#define SYSTICK_CTRL_ENABLE     0U      /*ENABLE: Counter enable*/
+#define SYSTICK_CTRL_TICKINT    1U      /*TICKINT: SysTick exception request on the count to 0*/
+#define SYSTICK_CTRL_CLKSOURCE  2U      /*CLKSOURCE: 1 = processor clock (HCLK), 0 = HCLK / 8*/
+#define SYSTICK_CTRL_COUNTFLAG  16U     /*COUNTFLAG: The counter reached 0 since the last read*/
+/*Maximum reload value (24 bit counter)*/
+#define SYSTICK_LOAD_MAX        0x00FFFFFFUL
+
+/*Floating point context control register*/
+#define FPU_FPCCR   (*((volatile uint32_t *) (0xE000EF34UL)))
+#define FPU_FPCCR_LSPEN     30U         /*LSPEN: Lazy stacking of the FP context on exception entry*/
+#define FPU_FPCCR_ASPEN     31U         /*ASPEN: Automatic FP context stacking (CONTROL.FPCA set on FP instructions)*/
+
+/*Debug exception and monitor control register*/
+#define DEMCR   (*((volatile uint32_t *) (0xE000EDFCUL)))
+
+/*DWT and DEMCR register bits*/
+#define DWT_CTRL_CYCCNTENA  0U          /*CYCCNTENA: Enable the cycle counter*/
+#define DEMCR_TRCENA        24U         /*TRCENA: Enable the DWT and ITM units*/
+
 /*Interrupt request number (IRQn)*/
 #define IRQ_NO_EXTI0        6U
 #define IRQ_NO_EXTI1        7U
 #define IRQ_NO_EXTI2        8U
 #define IRQ_NO_EXTI3        9U
 #define IRQ_NO_EXTI4        10U
+#define IRQ_NO_DMA1_STREAM0 11U
+#define IRQ_NO_DMA1_STREAM1 12U
+#define IRQ_NO_DMA1_STREAM2 13U
+#define IRQ_NO_DMA1_STREAM3 14U
+#define IRQ_NO_DMA1_STREAM4 15U
+#define IRQ_NO_DMA1_STREAM5 16U
+#define IRQ_NO_DMA1_STREAM6 17U
 #define IRQ_NO_EXTI9_5      23U
+#define IRQ_NO_TIM2         28U
+#define IRQ_NO_TIM3         29U
+#define IRQ_NO_TIM4         30U
+#define IRQ_NO_I2C1_EV      31U
+#define IRQ_NO_I2C1_ER      32U
+#define IRQ_NO_I2C2_EV      33U
+#define IRQ_NO_I2C2_ER      34U
+#define IRQ_NO_SPI1         35U
+#define IRQ_NO_SPI2         36U
+#define IRQ_NO_USART1       37U
+#define IRQ_NO_USART2       38U
 #define IRQ_NO_USART3       39U
 #define IRQ_NO_EXTI10_15    40U
+#define IRQ_NO_DMA1_STREAM7 47U
+#define IRQ_NO_TIM5         50U
+#define IRQ_NO_SPI3         51U
+#define IRQ_NO_UART4        52U
+#define IRQ_NO_UART5        53U
 #define IRQ_NO_TIM6_DAC     54U
 #define IRQ_NO_TIM7         55U
+#define IRQ_NO_DMA2_STREAM0 56U
+#define IRQ_NO_DMA2_STREAM1 57U
+#define IRQ_NO_DMA2_STREAM2 58U
+#define IRQ_NO_DMA2_STREAM3 59U
+#define IRQ_NO_DMA2_STREAM4 60U
+#define IRQ_NO_DMA2_STREAM5 68U
+#define IRQ_NO_DMA2_STREAM6 69U
+#define IRQ_NO_DMA2_STREAM7 70U
+#define IRQ_NO_USART6       71U
+#define IRQ_NO_I2C3_EV      72U
+#define IRQ_NO_I2C3_ER      73U
 
 
 #define NULL ((void *)0)
 
+/*Data memory barrier, completes the memory accesses before it prior to the memory accesses after it*/
+#define CM4_DMB()       __asm volatile ("dmb 0xF" ::: "memory")
+
+/*Interrupt masking (PRIMASK) and sleep instructions*/
+#define CM4_DISABLE_IRQ()   __asm volatile ("cpsid i" ::: "memory")
+#define CM4_ENABLE_IRQ()    __asm volatile ("cpsie i" ::: "memory")
+#define CM4_WFI()           __asm volatile ("wfi" ::: "memory")
+
+/*Data and instruction synchronization barriers, used after the NVIC and system control changes*/
+#define CM4_DSB()           __asm volatile ("dsb 0xF" ::: "memory")
+#define CM4_ISB()           __asm volatile ("isb 0xF" ::: "memory")
+
+/*Save PRIMASK and mask the interrupts, the saved value is given back to CM4_IRQRestore (nesting is allowed)*/
+static inline uint32_t CM4_IRQSave(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+/*Restore the PRIMASK value saved by CM4_IRQSave*/
+static inline void CM4_IRQRestore(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+/*  Raise BASEPRI to mask the interrupts of priority Priority and lower (priority values >= Priority),
+    the higher priority interrupts keep running. BASEPRI_MAX only raises the mask, so the sections nest.
+    Priority must be in [1..15]: BASEPRI can not mask the priority 0, use CM4_IRQSave for it.
+    The saved value is given back to CM4_BasePriRestore.*/
+static inline uint32_t CM4_BasePriSave(uint8_t Priority)
+{
+    uint32_t basepri;
+    __asm volatile ("mrs %0, basepri\n\tmsr basepri_max, %1"
+                    : "=&r" (basepri) : "r" ((uint32_t)Priority << (8U - NVIC_PRIO_BITS)) : "memory");
+    return basepri;
+}
+
+/*Restore the BASEPRI value saved by CM4_BasePriSave*/
+static inline void CM4_BasePriRestore(uint32_t basepri)
+{
+    __asm volatile ("msr basepri, %0" :: "r" (basepri) : "memory");
+}
+
+/*Marks a critical section state saved from PRIMASK, BASEPRI values only use bits [7:0]*/
+#define CM4_CRITICAL_PRIMASK    0x80000000UL
+
+/*  Critical section against the interrupts of priority Priority and lower: BASEPRI for Priority in [1..15],
+    PRIMASK for Priority 0. Nestable, the saved state is given back to CM4_CriticalExit.*/
+static inline uint32_t CM4_CriticalEnter(uint8_t Priority)
+{
+    if (Priority == 0U)
+    {
+        return CM4_IRQSave() | CM4_CRITICAL_PRIMASK;
+    }
+    return CM4_BasePriSave(Priority);
+}
+
+/*Leave the critical section entered by CM4_CriticalEnter*/
+static inline void CM4_CriticalExit(uint32_t State)
+{
+    if ((State & CM4_CRITICAL_PRIMASK) != 0U)
+    {
+        CM4_IRQRestore(State & ~CM4_CRITICAL_PRIMASK);
+    }
+    else
+    {
+        CM4_BasePriRestore(State);
+    }
+}
+
+/*Check if the core runs an exception handler (IPSR is not 0)*/
+static inline uint32_t CM4_InHandlerMode(void)
+{
+    uint32_t ipsr;
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return (ipsr != 0U);
+}
+
 void NVIC_SetPriority(uint8_t IRQNumber, uint8_t Priority);
+uint8_t NVIC_GetPriority(uint8_t IRQNumber);
 void NVIC_EnableIRQ(uint8_t IRQNumber);
+void NVIC_DisableIRQ(uint8_t IRQNumber);
+void NVIC_SetPendingIRQ(uint8_t IRQNumber);
+void NVIC_ClearPendingIRQ(uint8_t IRQNumber);
+uint8_t NVIC_GetPendingIRQ(uint8_t IRQNumber);
+uint8_t NVIC_GetActive(uint8_t IRQNumber);
+void NVIC_SetPriorityGrouping(uint8_t PriorityGroup);
+uint8_t NVIC_GetPriorityGrouping(void);
+void DWT_CycleCounterInit(void);
 #endif
@@ -0,0 +1,65 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_timer_driver.h"
+#include "timebase.h"
+#include "soft_timer.h"
+
+/*  Edge debouncer for buttons on EXTI lines.
+    The first edge of a press is reported at once from the EXTI callback (Debounce_EdgeIRQ), then the EXTI line is masked:
+    1. Lockout: the press bounces are ignored for LockoutTime ms.
+    2. Release integrator: the line stays masked until the pin has been read at the released level
+       for LockoutTime consecutive ms, so the release bounces are not taken for a new press.
+    Debounce_Tick is run every 1 ms by a software timer while a line is masked, the software timer
+    priority must not be higher than the EXTI interrupts of the buttons. */
+
+/*Number of EXTI lines handled by the debouncer*/
+#define DEBOUNCE_LINE_NUM           16U
+
+/*Debounce_State*/
+#define DEBOUNCE_STATE_IDLE         0U      /*The EXTI line is armed*/
+#define DEBOUNCE_STATE_LOCKOUT      1U      /*A press was reported, the press bounces are ignored*/
+#define DEBOUNCE_STATE_RELEASE      2U      /*Waiting for the pin to be stable at the released level*/
+
+/*Debounce state of an EXTI line*/
+typedef struct
+{
+    GPIO_RegDef_t * GPIOx;              /*Port of the button, the EXTI line number is the pin number*/
+    uint8_t ActiveLevel;                /*Pin level when the button is pressed, BIT_SET or BIT_RESET*/
+    uint16_t LockoutTime;               /*Press lockout and release stable time in ms*/
+    volatile uint8_t State;             /*@ref Debounce_State*/
+    volatile uint16_t Timer;            /*Lockout: ms remaining, release: consecutive released ms*/
+    volatile uint32_t PressStamp;       /*Timebase_NowCycles value at the EXTI dispatch of the last reported press*/
+    volatile uint32_t PressCount;       /*Number of reported presses*/
+    volatile uint32_t BounceCount;      /*Number of bounces seen while waiting for the release*/
+} Debounce_Line_t;
+
+/*  Input capture button, an alternative to the EXTI lines.
+    The timer input of the button is captured on two channels: the press edges on PressChannel
+    (e.g, IC1 on TI1, direct) and the release edges on ReleaseChannel (e.g, IC2 on TI1, indirect).
+    The input filter (ICxF) removes the glitches shorter than about 12 us, the longer bounces are rejected
+    in Debounce_CaptureIRQ: a press edge is a new press when no edge was captured during QuietTime before it.
+    The press timestamp is the counter value latched by the hardware, so the interrupt latency does not
+    change it. The timer must be a free running 32 bit timer (TIM2 or TIM5) with its update interrupt enabled. */
+typedef struct
+{
+    TIM_RegDef_t * TIMx;                /*Timer capturing the button input*/
+    uint8_t PressChannel;               /*Channel capturing the press edges*/
+    uint8_t ReleaseChannel;             /*Channel capturing the release edges*/
+    uint16_t QuietTime;                 /*Time in ms without edges needed before a new press*/
+    volatile uint8_t IdlePeriods;       /*Counter periods (update events) since the last edge, saturated at 2*/
+    volatile uint32_t LastEdge;         /*Timer counter at the last edge*/
+    volatile uint32_t PressStamp;       /*Timer counter at the last reported press*/
+    volatile uint32_t PressCount;       /*Number of reported presses*/
+    volatile uint32_t BounceCount;      /*Number of rejected press edges*/
+} Debounce_Capture_t;
+
+uint8_t Debounce_Init(GPIO_RegDef_t * GPIOx, uint8_t PinNumber, uint8_t ActiveLevel, uint16_t LockoutTime);
+uint8_t Debounce_EdgeIRQ(uint8_t PinNumber);
+void Debounce_Tick(void);
+const Debounce_Line_t * Debounce_GetLine(uint8_t PinNumber);
+void Debounce_CaptureInit(Debounce_Capture_t * pButton, TIM_RegDef_t * TIMx, uint8_t PressChannel,
+                          uint8_t ReleaseChannel, uint16_t QuietTime);
+uint8_t Debounce_CaptureIRQ(Debounce_Capture_t * pButton);
+#endif
@@ -0,0 +1,60 @@
+#ifndef DINO_PROTOCOL_H
+#define DINO_PROTOCOL_H
+#include <stdint.h>
+
+/*  Binary frame format between the firmware and STMDinoGame.
+    This module does not access any register, it is built unchanged for the firmware and for host tools.
+    STMDinoGame/development/src/dino_protocol.py implements the same format for the game.
+
+    Frame (before encoding):  | Header | Payload (0..DINO_PROTO_MAX_PAYLOAD) | CRC-8 |
+        Header  = (DINO_PROTO_VERSION << 5) | Message ID
+        CRC-8   = CRC-8/SMBUS (poly 0x07, init 0x00) of Header and Payload
+    On the wire the frame is COBS encoded and terminated by a single 0x00 byte,
+    so a receiver resynchronizes on the next 0x00 after any error. */
+
+/*Protocol version carried in the 3 upper bits of the header*/
+#define DINO_PROTO_VERSION          1U
+
+/*Maximum payload size*/
+#define DINO_PROTO_MAX_PAYLOAD      16U
+
+/*Maximum size of an encoded frame: COBS overhead byte + header + payload + CRC + delimiter*/
+#define DINO_PROTO_MAX_FRAME        (DINO_PROTO_MAX_PAYLOAD + 4U)
+
+/*Message IDs*/
+#define DINO_MSG_JUMP               0x01U   /*Board to host, no payload: the jump button was pressed*/
+#define DINO_MSG_HEIGHT             0x02U   /*Host to board, uint8: jump height, 0 (ground) to 255 (highest point)*/
+#define DINO_MSG_SCORE              0x03U   /*Host to board, uint32 little endian: current score*/
+#define DINO_MSG_TELEMETRY          0x04U   /*Board to host, up to 4 uint32 little endian counters*/
+#define DINO_MSG_POWER              0x05U   /*Board to host, 4 uint32 little endian: sleep ms, STOP count, last and max wake latency (us)*/
+
+/*Decoder status returned by DinoProto_Decode*/
+#define DINO_PROTO_BUSY             0U      /*Frame not complete yet*/
+#define DINO_PROTO_FRAME_OK         1U      /*A valid frame is available in the message*/
+#define DINO_PROTO_FRAME_ERROR      2U      /*A frame was received but discarded*/
+
+/*Decoded message*/
+typedef struct
+{
+    uint8_t Id;                                 /*Message ID, @ref Message IDs*/
+    uint8_t Length;                             /*Payload length*/
+    uint8_t Payload[DINO_PROTO_MAX_PAYLOAD];    /*Payload*/
+} DinoProto_Msg_t;
+
+/*Streaming decoder state*/
+typedef struct
+{
+    uint8_t Buffer[DINO_PROTO_MAX_PAYLOAD + 2U];/*Decoded header, payload and CRC*/
+    uint8_t Length;                             /*Number of decoded bytes*/
+    uint8_t Code;                               /*Current COBS code byte*/
+    uint8_t Remaining;                          /*Data bytes remaining in the current COBS block*/
+    uint8_t Overflow;                           /*The current frame is too long and is discarded*/
+    uint32_t FrameCount;                        /*Number of valid frames*/
+    uint32_t ErrorCount;                        /*Number of discarded frames (COBS, CRC, version or length error)*/
+} DinoProto_Decoder_t;
+
+uint8_t DinoProto_Crc8(const uint8_t * Data, uint16_t Length);
+uint16_t DinoProto_Encode(uint8_t Id, const uint8_t * Payload, uint8_t Length, uint8_t * Frame, uint16_t FrameSize);
+void DinoProto_DecoderInit(DinoProto_Decoder_t * pDecoder);
+uint8_t DinoProto_Decode(DinoProto_Decoder_t * pDecoder, uint8_t Byte, DinoProto_Msg_t * pMsg);
+#endif
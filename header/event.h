@@ -0,0 +1,59 @@
+#ifndef EVENT_H
+#define EVENT_H
+#include "stm32f407xx.h"
+#include "timebase.h"
+#include "mpsc_queue.h"
+
+/*  Run-to-completion event loop.
+    Any context posts typed events with Event_Post, the main loop calls Event_Dispatch which takes the oldest event
+    of the highest priority not empty and calls the handler subscribed to its type, one event at a time.
+    - One lock-free multi producer queue (mpsc_queue.h) per priority, posting never masks the interrupts.
+    - The handlers run in thread mode, they can post events. A new input or output adds an event type and a handler.
+    - The dispatch cost (handler cycles) and the post to dispatch latency are measured per event type. */
+
+/*Event_Type, add the new event types here*/
+#define EVENT_BUTTON                0U      /*Button press, Param: press count*/
+#define EVENT_UART_FRAME            1U      /*Frame received, Code: message ID, Param: first 4 payload bytes (LE)*/
+#define EVENT_TIMER                 2U      /*Software timer expired, Param: application defined*/
+#define EVENT_DISPLAY_DONE          3U      /*Display transfer completed*/
+#define EVENT_TYPE_NUM              8U
+
+/*Event_Priority*/
+#define EVENT_PRIO_HIGH             0U
+#define EVENT_PRIO_NORMAL           1U
+#define EVENT_PRIO_LOW              2U
+#define EVENT_PRIO_NUM              3U
+
+/*Number of events per priority queue, this must be a power of two*/
+#define EVENT_QUEUE_SIZE            16U
+
+/*Event*/
+typedef struct
+{
+    uint8_t Type;                       /*@ref Event_Type*/
+    uint8_t Code;                       /*Type specific code*/
+    uint32_t Param;                     /*Type specific parameter*/
+    uint32_t PostStamp;                 /*Timebase_NowCycles value when the event was posted*/
+} Event_t;
+
+/*Event handler type*/
+typedef void (*Event_Handler_t)(const Event_t * pEvent);
+
+/*Dispatch statistics of an event type*/
+typedef struct
+{
+    uint32_t Count;                     /*Number of dispatched events*/
+    uint32_t Cycles;                    /*Handler cycles of the last event*/
+    uint32_t MaxCycles;                 /*Worst case handler cycles*/
+    uint64_t TotalCycles;               /*Handler cycles of all the events, the average is TotalCycles / Count*/
+    uint32_t MaxLatency;                /*Worst case cycles from the post to the start of the handler*/
+} Event_TypeStats_t;
+
+void Event_Init(void);
+uint8_t Event_Subscribe(uint8_t Type, Event_Handler_t Handler);
+uint8_t Event_Post(uint8_t Type, uint8_t Code, uint32_t Param, uint8_t Priority);
+uint8_t Event_IsPending(void);
+uint8_t Event_Dispatch(void);
+const Event_TypeStats_t * Event_GetTypeStats(uint8_t Type);
+uint32_t Event_GetDropped(uint8_t Priority);
+#endif
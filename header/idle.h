@@ -0,0 +1,49 @@
+#ifndef IDLE_H
+#define IDLE_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_rcc_driver.h"
+#include "timebase.h"
+#include "soft_timer.h"
+
+/*  Idle manager, Idle_Enter is called by the main loop when it has nothing to do.
+    - SLEEP: WFI with PRIMASK set, so an interrupt arriving after the HasWork check still ends the WFI.
+      The pending interrupt is served when Idle_Enter returns. TIM2 keeps running, the sleep time is measured.
+    - STOP: used instead of SLEEP after StopDelay ms without activity, when no software timer is armed and
+      CanStop allows it. The clocks are stopped (regulator in low-power mode), only the EXTI lines wake the core up:
+      the enabled EXTI interrupts (e.g, buttons) and the WakeLines (e.g, USART RX pin), which are unmasked during STOP only.
+      The core wakes up on the HSI, the clock tree is restored before the pending interrupt is served.
+      The GPIO driver EXTI dispatch clears the pending wake line, a callback can be registered on it (GPIO_EXTI_Register).
+      TIM2 and DWT_CYCCNT are stopped during STOP: the time base does not count the STOP time.
+    Wake latency: time from the STOP exit to the interrupts enable, i.e, the HSE, PLL and clock switch time.
+    It is measured with DWT_CYCCNT (HSI cycles up to the clock switch, HCLK cycles after it).
+    The USART can not receive during STOP and the wakeup: the first frame received after a STOP is lost. */
+
+/*Work check, called with the interrupts masked, it must return TRUE if the main loop has work to do*/
+typedef uint8_t (*Idle_Check_t)(void);
+
+/*Idle configuration structure*/
+typedef struct
+{
+    Idle_Check_t HasWork;               /*  Pending work of the main loop (e.g, received bytes)*/
+    Idle_Check_t CanStop;               /*  TRUE if STOP is allowed (e.g, no transmission running), NULL: STOP never used*/
+    const RCC_ClkConf_t * pClkConf;     /*  Clock tree restored after STOP*/
+    uint32_t StopDelay;                 /*  Time without activity in ms before STOP is used.
+                                            0 disables STOP, the input latency stays minimal*/
+    uint32_t WakeLines;                 /*  EXTI lines (bit mask) unmasked during STOP only, configured by the application*/
+} Idle_Conf_t;
+
+/*Idle statistics*/
+typedef struct
+{
+    uint32_t SleepCount;                /*Number of SLEEP entries*/
+    uint32_t SleepTime;                 /*Time spent in SLEEP in ms*/
+    uint32_t StopCount;                 /*Number of STOP entries*/
+    uint32_t WakeLatencyLast;           /*Last STOP wake latency in us*/
+    uint32_t WakeLatencyMax;            /*Maximum STOP wake latency in us*/
+} Idle_Stats_t;
+
+void Idle_Init(Idle_Conf_t IdleConf);
+void Idle_NotifyActivity(void);
+void Idle_Enter(void);
+const Idle_Stats_t * Idle_GetStats(void);
+#endif
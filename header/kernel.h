@@ -0,0 +1,126 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+#include "stm32f407xx.h"
+
+/*  Minimal fixed-priority preemptive kernel.
+    - Priorities: 0 is the highest, KERNEL_PRIO_NUM - 1 is the idle task. The highest priority ready task runs,
+      the tasks of the same priority share the CPU by time slices of KERNEL_TIME_SLICE ticks.
+    - The tasks, their stacks, the semaphores and the message queues are allocated by the application.
+    - Semaphores and message queues: the waiting tasks are woken up by priority, with an optional timeout.
+      Kernel_SemGive and the calls with a 0 timeout can be used from the interrupts whose priority is not higher
+      than KERNEL_SYSCALL_PRIORITY.
+    - Statistics: context switch count and latency (switch request to switch), CPU time of each task.
+    The context switches and the tick are done by a port (kernel_port.h):
+    - kernel_port_cm4.c: PendSV switches the context (lazy FPU stacking), a SysTick hook (systick.h) gives the tick.
+      KERNEL_ENABLE must be 1 for it to own PendSV_Handler.
+    - kernel_port_host.c: simulation on Linux (ucontext, build with KERNEL_PORT_HOST), the ticks are simulated
+      so the scheduling can be tested step by step. */
+
+/*Set to 1 (e.g, in the project defines) to let the kernel own the PendSV handler*/
+#ifndef KERNEL_ENABLE
+#define KERNEL_ENABLE               0U
+#endif
+
+/*Number of priorities, the lowest one is reserved for the idle task*/
+#define KERNEL_PRIO_NUM             8U
+#define KERNEL_PRIO_IDLE            (KERNEL_PRIO_NUM - 1U)
+/*Tick frequency in Hz*/
+#define KERNEL_TICK_HZ              1000U
+/*Time slice of the tasks of the same priority, in ticks*/
+#define KERNEL_TIME_SLICE           10U
+/*Highest interrupt priority allowed to call the kernel, the kernel critical sections mask it (BASEPRI)*/
+#define KERNEL_SYSCALL_PRIORITY     1U
+/*Idle task stack size in words*/
+#define KERNEL_IDLE_STACK_SIZE      128U
+/*Minimum task stack size in words*/
+#define KERNEL_STACK_MIN            64U
+/*Value written in the free stack words, used to measure the stack usage*/
+#define KERNEL_STACK_FILL           0xDEADBEEFU
+
+/*Timeout values*/
+#define KERNEL_NO_WAIT              0U
+#define KERNEL_WAIT_FOREVER         0xFFFFFFFFU
+
+/*Kernel_Task_State*/
+#define KERNEL_TASK_READY           0U      /*Running or ready to run*/
+#define KERNEL_TASK_DELAYED         1U      /*Waiting for WakeTick*/
+#define KERNEL_TASK_BLOCKED         2U      /*Waiting for a semaphore, until WakeTick if Timed*/
+#define KERNEL_TASK_DORMANT         3U      /*The task function returned*/
+
+/*Task function type*/
+typedef void (*Kernel_TaskEntry_t)(void * Arg);
+
+/*Task control block*/
+typedef struct Kernel_Task
+{
+    uint32_t * Sp;                      /*Saved stack pointer, must stay the first member (port assembly)*/
+    struct Kernel_Task * Next;          /*Next task in the ready list (circular) or in the wait list*/
+    struct Kernel_Task * Prev;          /*Previous task in the ready list*/
+    struct Kernel_Task * AllNext;       /*Next created task*/
+    const char * Name;                  /*Task name*/
+    Kernel_TaskEntry_t Entry;           /*Task function*/
+    void * Arg;                         /*Given to the task function*/
+    uint32_t * Stack;                   /*Lowest address of the stack*/
+    uint32_t StackSize;                 /*Stack size in words*/
+    void * PortData;                    /*Port specific data*/
+    void * WaitObject;                  /*Semaphore the blocked task waits for*/
+    uint8_t Priority;                   /*Task priority, 0 is the highest*/
+    uint8_t State;                      /*@ref Kernel_Task_State*/
+    uint8_t Timed;                      /*TRUE if the blocked task waits until WakeTick*/
+    uint8_t WaitResult;                 /*TRUE if the wait ended by a give, FALSE on timeout*/
+    uint16_t Slice;                     /*Ticks left in the time slice*/
+    uint32_t WakeTick;                  /*End of the delay or of the timeout*/
+    uint32_t SwitchCount;               /*Number of times the task was switched in*/
+    uint64_t RunCycles;                 /*CPU time of the task in port cycles*/
+} Kernel_Task_t;
+
+/*Counting semaphore*/
+typedef struct
+{
+    volatile uint32_t Count;            /*Number of available units*/
+    Kernel_Task_t * WaitList;           /*Waiting tasks, highest priority first*/
+} Kernel_Sem_t;
+
+/*Message queue of fixed size items*/
+typedef struct
+{
+    uint8_t * Buffer;                   /*Storage, Capacity * ItemSize bytes*/
+    uint16_t ItemSize;                  /*Item size in bytes*/
+    uint16_t Capacity;                  /*Number of items*/
+    uint16_t Head;                      /*Index of the oldest item*/
+    uint16_t Count;                     /*Number of queued items*/
+    Kernel_Sem_t Items;                 /*Queued items, the receivers wait on it*/
+    Kernel_Sem_t Spaces;                /*Free items, the senders wait on it*/
+} Kernel_Queue_t;
+
+/*Kernel statistics*/
+typedef struct
+{
+    uint32_t SwitchCount;               /*Number of context switches*/
+    uint32_t LastSwitchLatency;         /*Port cycles from the switch request to the switch, last switch*/
+    uint32_t MaxSwitchLatency;          /*Worst case of LastSwitchLatency*/
+    uint64_t TotalCycles;               /*Port cycles since Kernel_Start, sum of the RunCycles of the tasks*/
+} Kernel_Stats_t;
+
+void Kernel_Init(void);
+uint8_t Kernel_TaskCreate(Kernel_Task_t * pTask, const char * Name, Kernel_TaskEntry_t Entry, void * Arg,
+                          uint8_t Priority, uint32_t * Stack, uint32_t StackSize);
+void Kernel_Start(void);
+void Kernel_Yield(void);
+void Kernel_Delay(uint32_t Ticks);
+uint32_t Kernel_GetTick(void);
+Kernel_Task_t * Kernel_GetCurrent(void);
+void Kernel_SetPendSVHook(void (*Hook)(void));
+
+void Kernel_SemInit(Kernel_Sem_t * pSem, uint32_t Count);
+uint8_t Kernel_SemTake(Kernel_Sem_t * pSem, uint32_t Timeout);
+void Kernel_SemGive(Kernel_Sem_t * pSem);
+
+uint8_t Kernel_QueueInit(Kernel_Queue_t * pQueue, void * Buffer, uint16_t ItemSize, uint16_t Capacity);
+uint8_t Kernel_QueueSend(Kernel_Queue_t * pQueue, const void * Item, uint32_t Timeout);
+uint8_t Kernel_QueueReceive(Kernel_Queue_t * pQueue, void * Item, uint32_t Timeout);
+
+const Kernel_Stats_t * Kernel_GetStats(void);
+uint32_t Kernel_GetTaskLoad(const Kernel_Task_t * pTask);
+uint32_t Kernel_GetStackFree(const Kernel_Task_t * pTask);
+#endif
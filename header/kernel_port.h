@@ -0,0 +1,31 @@
+#ifndef KERNEL_PORT_H
+#define KERNEL_PORT_H
+#include "kernel.h"
+
+/*  Interface between the kernel core (kernel.c) and its port (kernel_port_cm4.c or kernel_port_host.c). */
+
+/*Running task, read and written by the port context switch*/
+extern Kernel_Task_t * volatile Kernel_Current;
+
+/*Port functions called by the kernel core*/
+void Kernel_PortInitStack(Kernel_Task_t * pTask);
+void Kernel_PortStart(void);
+void Kernel_PortRequestSwitch(void);
+uint32_t Kernel_PortEnterCritical(void);
+void Kernel_PortExitCritical(uint32_t State);
+uint32_t Kernel_PortCycles(void);
+void Kernel_PortIdle(void);
+
+/*Kernel core functions called by the port*/
+void Kernel_TickHandler(void);
+void Kernel_SwitchContext(void);
+void Kernel_RunPendSVHook(void);
+void Kernel_TaskExit(void);
+
+#if defined(KERNEL_PORT_HOST)
+/*Host simulation: run the kernel for the given number of ticks, then return to the caller*/
+void Kernel_PortSimRun(uint32_t Ticks);
+/*Host simulation: tick interrupt at this point of the current task, it can preempt it*/
+void Kernel_PortSimTick(void);
+#endif
+#endif
@@ -0,0 +1,34 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+#include "stm32f407xx.h"
+
+/*  Bounded lock-free multi producer, single consumer queue (one sequence number per cell).
+    The queue only handles the positions, the items are stored by the user in an array indexed by
+    MPSC_QUEUE_INDEX(pQueue, Pos):
+    - Producer (any context): MpscQueue_Reserve, write the item, MpscQueue_Publish.
+      The reservation is a compare and swap on the head, the interrupts are never masked.
+    - Consumer (one context): MpscQueue_Peek, read the item, MpscQueue_Release.
+    A producer preempted between Reserve and Publish only delays the items reserved after it:
+    the consumer stops at the first cell not published yet, so the items are consumed in the reservation order. */
+
+/*Queue state, the statistics are updated by the producers*/
+typedef struct
+{
+    volatile uint32_t * Sequence;       /*Sequence number of each cell: Pos when free for Pos, Pos + 1 when published*/
+    uint32_t Mask;                      /*Number of cells - 1, the number of cells must be a power of two*/
+    uint32_t Head;                      /*Next position to be reserved*/
+    uint32_t Tail;                      /*Next position to be consumed*/
+    uint32_t Dropped;                   /*Number of failed reservations, the queue was full*/
+    uint32_t HighWater;                 /*Maximum number of positions reserved and not consumed, seen when publishing*/
+} MpscQueue_t;
+
+/*Index of the item of a position in the user array*/
+#define MPSC_QUEUE_INDEX(pQueue, Pos)   ((Pos) & (pQueue)->Mask)
+
+uint8_t MpscQueue_Init(MpscQueue_t * pQueue, volatile uint32_t * Sequence, uint32_t Size);
+uint8_t MpscQueue_Reserve(MpscQueue_t * pQueue, uint32_t * pPos);
+void MpscQueue_Publish(MpscQueue_t * pQueue, uint32_t Pos);
+uint8_t MpscQueue_Peek(MpscQueue_t * pQueue, uint32_t * pPos);
+void MpscQueue_Release(MpscQueue_t * pQueue, uint32_t Pos);
+uint32_t MpscQueue_GetDepth(const MpscQueue_t * pQueue);
+#endif
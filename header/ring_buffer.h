@@ -0,0 +1,26 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+#include "stm32f407xx.h"
+
+/*  Single-producer/single-consumer byte queue.
+    One context (e.g, an interrupt) only calls the Put/Write functions and one other context
+    (e.g, the main loop) only calls the Get/Read functions, no interrupt masking is needed.
+    Head and Tail are free running indexes, the number of queued bytes is Head - Tail. */
+typedef struct
+{
+    uint8_t * Buffer;               /*Storage of the queue*/
+    uint16_t Size;                  /*Size of the storage, a power of two in [1..32768]*/
+    volatile uint16_t Head;         /*Write index, only written by the producer*/
+    volatile uint16_t Tail;         /*Read index, only written by the consumer*/
+    volatile uint16_t HighWater;    /*Highest number of queued bytes seen, only written by the producer*/
+    volatile uint32_t Dropped;      /*Number of bytes rejected because the queue was full, only written by the producer*/
+} RingBuf_t;
+
+uint8_t RingBuf_Init(RingBuf_t * pRing, uint8_t * Storage, uint16_t Size);
+uint8_t RingBuf_Put(RingBuf_t * pRing, uint8_t Data);
+uint16_t RingBuf_Write(RingBuf_t * pRing, const uint8_t * Data, uint16_t Length);
+uint8_t RingBuf_Get(RingBuf_t * pRing, uint8_t * Data);
+uint16_t RingBuf_Read(RingBuf_t * pRing, uint8_t * Data, uint16_t Length);
+uint16_t RingBuf_Count(const RingBuf_t * pRing);
+uint16_t RingBuf_Free(const RingBuf_t * pRing);
+#endif
@@ -0,0 +1,60 @@
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_timer_driver.h"
+#include "timebase.h"
+
+/*  Software timers on a hierarchical timing wheel, 1 tick = 1 ms.
+    - 4 levels of 64 slots, level L slots are 64^L ticks wide, timeouts up to 2^31 ticks
+      (the timers beyond 64^4 ticks wait in the last slot of level 3 and are placed again when it is cascaded).
+    - Each slot is an intrusive doubly linked list and each level has a 64 bit occupancy bitmap:
+      start, stop and expiry are O(1), the next deadline is found with a few CTZ.
+    - Tickless: TIM7 is a one-shot alarm programmed to the next slot needing work (at most
+      SOFTTIMER_MAX_ALARM ticks ahead), the elapsed time is read from the time base (TIM2), so the wheel does not drift.
+    The callbacks run from the TIM7 interrupt with the interrupts enabled, they can start and stop timers.
+    TIM7_IRQHandler must call SoftTimer_IRQHandling, Timebase_Init must be called before SoftTimer_Init. */
+
+/*Timer used as the alarm of the wheel*/
+#define SOFTTIMER_TIM               TIM7
+/*Alarm counter clock: 10 kHz, 100 us resolution and 6.5 s range with the 16 bit counter*/
+#define SOFTTIMER_COUNTER_CLOCK     10000U
+#define SOFTTIMER_US_PER_COUNT      (1000000U / SOFTTIMER_COUNTER_CLOCK)
+/*Tick period in microseconds*/
+#define SOFTTIMER_US_PER_TICK       1000U
+/*Maximum number of ticks between two alarms*/
+#define SOFTTIMER_MAX_ALARM         6000U
+
+/*Wheel geometry*/
+#define SOFTTIMER_LEVELS            4U
+#define SOFTTIMER_SLOT_BITS         6U
+#define SOFTTIMER_SLOTS             (1U << SOFTTIMER_SLOT_BITS)
+#define SOFTTIMER_SLOT_MASK         (SOFTTIMER_SLOTS - 1U)
+
+/*Maximum timeout and period in ticks*/
+#define SOFTTIMER_MAX_TIMEOUT       0x7FFFFFFFU
+
+/*Software timer callback type*/
+typedef void (*SoftTimer_Callback_t)(void * Context);
+
+/*Software timer, the storage is owned by the application*/
+typedef struct SoftTimer
+{
+    struct SoftTimer * Next;            /*Next timer in the slot*/
+    struct SoftTimer * Prev;            /*Previous timer in the slot*/
+    uint32_t Expires;                   /*Expiry tick*/
+    uint32_t Period;                    /*Period in ticks, 0 for a one-shot timer*/
+    SoftTimer_Callback_t Callback;      /*Called when the timer expires*/
+    void * Context;                     /*Given to the callback*/
+    uint8_t Level;                      /*Wheel level of the timer*/
+    uint8_t Slot;                       /*Slot of the timer in its level*/
+    volatile uint8_t Armed;             /*TRUE while the timer is in the wheel*/
+} SoftTimer_t;
+
+void SoftTimer_Init(uint8_t Priority);
+void SoftTimer_Create(SoftTimer_t * pTimer, SoftTimer_Callback_t Callback, void * Context);
+uint8_t SoftTimer_Start(SoftTimer_t * pTimer, uint32_t Timeout, uint32_t Period);
+void SoftTimer_Stop(SoftTimer_t * pTimer);
+uint8_t SoftTimer_IsArmed(const SoftTimer_t * pTimer);
+uint32_t SoftTimer_GetArmedCount(void);
+void SoftTimer_IRQHandling(void);
+#endif
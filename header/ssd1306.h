@@ -0,0 +1,165 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_i2c_driver.h"
+#include "stm32f407xx_spi_driver.h"
+#include "timebase.h"
+
+/*  SSD1306 128x64 OLED driver.
+    The frame is drawn in RAM in the controller layout: 8 pages of 128 bytes, bit n of a byte is the row
+    (page * 8 + n) of its column. The controller is used in horizontal addressing mode, a full frame is the
+    column and page window commands followed by the 1024 bytes of the frame in one data transfer.
+    Two buffers are used: the application draws in the draw buffer, SSD1306_UpdateScreen copies it to the transfer
+    buffer and starts the transfer, the next frame can be drawn while the bus sends it.
+    Partial updates: the drawing functions keep a dirty column range per page. SSD1306_UpdateScreen trims each
+    range to the bytes that differ from the transfer buffer (which holds the display RAM content), then sends one
+    address window and its bytes per changed page. The whole frame is sent when the spans would cost more, after
+    the init, after a bus error and after SSD1306_Invalidate (needed when the draw buffer is written directly).
+    The driver does not access the bus itself, the bus interface (I2C or SPI driver) sends the bytes,
+    by DMA for the frame data. Full frame time: about 23 ms on I2C at 400 kHz (the STM32F407 I2C has no
+    Fast-mode Plus, 40 FPS at most), under 1 ms on SPI at 10 MHz. SSD1306_I2C_Write and SSD1306_SPI_Write are
+    the I2C and SPI bus interfaces. */
+
+/*Display geometry*/
+#define SSD1306_WIDTH               128U
+#define SSD1306_HEIGHT              64U
+#define SSD1306_PAGES               (SSD1306_HEIGHT / 8U)
+#define SSD1306_FRAME_SIZE          (SSD1306_WIDTH * SSD1306_PAGES)
+/*Bytes of the address window commands sent before each span of a partial update*/
+#define SSD1306_WINDOW_SIZE         6U
+/*Size of the command buffer, the longest command sequence is the init sequence*/
+#define SSD1306_CMD_MAX             32U
+
+/*SSD1306_Control: kind of the bytes given to the bus, it is the I2C control byte (Co = 0, D/C#)*/
+#define SSD1306_CTRL_CMD            0x00U   /*Command bytes (SPI: D/C# low)*/
+#define SSD1306_CTRL_DATA           0x40U   /*Display RAM bytes (SPI: D/C# high)*/
+
+/*SSD1306_State*/
+#define SSD1306_STATE_IDLE          0U      /*No transfer running*/
+#define SSD1306_STATE_CMD           1U      /*Command transfer (init, contrast, on/off)*/
+#define SSD1306_STATE_WINDOW        2U      /*Flush: address window commands of a span*/
+#define SSD1306_STATE_DATA          3U      /*Flush: display RAM bytes of a span*/
+
+/*SSD1306 commands*/
+#define SSD1306_SET_MEMORY_MODE     0x20U   /*1 byte: 0x00 horizontal addressing*/
+#define SSD1306_SET_COLUMN_ADDR     0x21U   /*2 bytes: start, end column*/
+#define SSD1306_SET_PAGE_ADDR       0x22U   /*2 bytes: start, end page*/
+#define SSD1306_DEACTIVATE_SCROLL   0x2EU
+#define SSD1306_SET_START_LINE      0x40U   /*Ored with the line (0 to 63)*/
+#define SSD1306_SET_CONTRAST        0x81U   /*1 byte: contrast*/
+#define SSD1306_CHARGE_PUMP         0x8DU   /*1 byte: 0x14 enabled, 0x10 disabled*/
+#define SSD1306_SEG_REMAP           0xA0U   /*Ored with 1: column 127 is SEG0*/
+#define SSD1306_DISPLAY_RAM         0xA4U   /*Output follows the RAM content*/
+#define SSD1306_NORMAL_DISPLAY      0xA6U
+#define SSD1306_INVERT_DISPLAY      0xA7U
+#define SSD1306_SET_MULTIPLEX       0xA8U   /*1 byte: rows - 1*/
+#define SSD1306_DISPLAY_OFF         0xAEU
+#define SSD1306_DISPLAY_ON          0xAFU
+#define SSD1306_COM_SCAN_INC        0xC0U
+#define SSD1306_COM_SCAN_DEC        0xC8U
+#define SSD1306_SET_DISPLAY_OFFSET  0xD3U   /*1 byte: vertical shift*/
+#define SSD1306_SET_CLOCK_DIV       0xD5U   /*1 byte: oscillator frequency [7:4], divide ratio - 1 [3:0]*/
+#define SSD1306_SET_PRECHARGE       0xD9U   /*1 byte: phase 2 [7:4], phase 1 [3:0]*/
+#define SSD1306_SET_COM_PINS        0xDAU   /*1 byte: 0x12 alternative COM pins (128x64)*/
+#define SSD1306_SET_VCOM_DETECT     0xDBU   /*1 byte: VCOMH deselect level*/
+
+/*Completion callback, Status is TRUE on success, FALSE on a bus error*/
+typedef void (*SSD1306_Done_t)(uint8_t Status, void * Context);
+
+/*  Bus interface. Write sends Length bytes of the kind Control (@ref SSD1306_Control) and returns at once,
+    Done is called from the bus interrupt when the bytes are sent. pData stays valid until Done is called.
+    It returns FALSE if the transfer can not be started (bus busy or error), Done is not called then. */
+typedef struct
+{
+    uint8_t (*Write)(void * pBus, uint8_t Control, const uint8_t * pData, uint16_t Length,
+                     SSD1306_Done_t Done, void * Context);
+    void * pBus;                        /*Bus instance given to Write*/
+} SSD1306_Bus_t;
+
+/*I2C bus interface (pBus of SSD1306_Bus_t), one queued transfer with the control byte as header*/
+typedef struct
+{
+    I2C_RegDef_t * I2Cx;                /*Initialized I2C*/
+    uint8_t Address;                    /*@ref SSD1306_I2C_Address*/
+    I2C_Transfer_t Xfer;                /*Used by SSD1306_I2C_Write*/
+    SSD1306_Done_t Done;
+    void * Context;
+} SSD1306_I2C_t;
+
+/*SSD1306_I2C_Address: 7 bit address, selected by the SA0 pin*/
+#define SSD1306_I2C_ADDRESS         0x3CU
+#define SSD1306_I2C_ADDRESS_ALT     0x3DU
+
+/*SPI bus interface (pBus of SSD1306_Bus_t), the D/C# pin is set when the transfer starts on the bus*/
+typedef struct
+{
+    SPI_RegDef_t * SPIx;                /*Initialized SPI*/
+    SPI_Device_t Device;                /*8 bit frames, MSB first, CPOL/CPHA 0/0 or 1/1, 10 MHz at most, chip select*/
+    GPIO_RegDef_t * pDcPort;            /*D/C# pin, GPIO output*/
+    uint8_t DcPin;
+    uint8_t Control;                    /*@ref SSD1306_Control of the queued bytes*/
+    SPI_Transfer_t Xfer;                /*Used by SSD1306_SPI_Write*/
+    SSD1306_Done_t Done;
+    void * Context;
+} SSD1306_SPI_t;
+
+/*SSD1306 configuration structure*/
+typedef struct
+{
+    SSD1306_Bus_t Bus;
+    uint8_t ExternalVcc;                /*TRUE: VCC supplied by the board, FALSE: internal charge pump*/
+    uint8_t Flip;                       /*TRUE: the image is rotated by 180 degrees*/
+    uint8_t Contrast;                   /*Initial contrast (0 to 255)*/
+    SSD1306_Done_t FlushDone;           /*Called from the bus interrupt when a flush ends, NULL: not used*/
+    void * Context;                     /*Given to FlushDone*/
+} SSD1306_Conf_t;
+
+/*SSD1306 statistics*/
+typedef struct
+{
+    uint32_t FlushCount;                /*Number of completed flushes*/
+    uint32_t FlushTimeLast;             /*Duration of the last flush in us, from SSD1306_UpdateScreen to the end of the data*/
+    uint32_t FlushTimeMax;              /*Maximum flush duration in us*/
+    uint32_t BusErrors;                 /*Number of transfers ended by a bus error*/
+    uint32_t FullFlushes;               /*Flushes sending the whole frame*/
+    uint32_t FlushBytesLast;            /*Command and data bytes of the last flush (full frame: 1030)*/
+    uint32_t FlushBytesTotal;           /*Bytes of all the completed flushes, / FlushCount: bytes per frame*/
+} SSD1306_Stats_t;
+
+/*SSD1306 display handle*/
+typedef struct
+{
+    SSD1306_Conf_t Conf;
+    volatile uint8_t State;             /*@ref SSD1306_State*/
+    uint8_t Cmd[SSD1306_CMD_MAX];       /*Command bytes of the running transfer*/
+    uint32_t FlushStart;                /*Timebase_NowCycles value at the flush start*/
+    uint32_t FlushBytes;                /*Bytes sent by the running flush*/
+    uint8_t FullFlush;                  /*TRUE: the next flush sends the whole frame*/
+    uint8_t DirtyStart[SSD1306_PAGES];  /*Dirty columns of each page of the draw buffer, clean if start > end*/
+    uint8_t DirtyEnd[SSD1306_PAGES];
+    uint8_t SpanStart[SSD1306_PAGES];   /*Changed columns of each page for the running flush, none if start > end*/
+    uint8_t SpanEnd[SSD1306_PAGES];
+    uint8_t SpanPage;                   /*Page of the span being sent*/
+    uint16_t SpanOffset;                /*Transfer buffer offset and length of the span being sent*/
+    uint16_t SpanLength;
+    SSD1306_Stats_t Stats;
+    uint8_t Frame[SSD1306_FRAME_SIZE] __attribute__((aligned(4)));      /*Draw buffer*/
+    uint8_t TxFrame[SSD1306_FRAME_SIZE] __attribute__((aligned(4)));    /*Frame being sent*/
+} SSD1306_t;
+
+uint8_t SSD1306_Init(SSD1306_t * pDisp, SSD1306_Conf_t Conf);
+uint8_t SSD1306_SetContrast(SSD1306_t * pDisp, uint8_t Contrast);
+uint8_t SSD1306_DisplayOn(SSD1306_t * pDisp, uint8_t On);
+uint8_t SSD1306_IsBusy(const SSD1306_t * pDisp);
+uint8_t SSD1306_UpdateScreen(SSD1306_t * pDisp);
+void SSD1306_Invalidate(SSD1306_t * pDisp);
+void SSD1306_Fill(SSD1306_t * pDisp, uint8_t On);
+void SSD1306_DrawPixel(SSD1306_t * pDisp, uint8_t X, uint8_t Y, uint8_t On);
+void SSD1306_DrawFilledRectangle(SSD1306_t * pDisp, uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t On);
+void SSD1306_DrawSprite(SSD1306_t * pDisp, int16_t X, int16_t Y, const uint8_t * pBitmap, uint8_t Width, uint8_t Height);
+const SSD1306_Stats_t * SSD1306_GetStats(const SSD1306_t * pDisp);
+uint8_t SSD1306_I2C_Write(void * pBus, uint8_t Control, const uint8_t * pData, uint16_t Length,
+                          SSD1306_Done_t Done, void * Context);
+uint8_t SSD1306_SPI_Write(void * pBus, uint8_t Control, const uint8_t * pData, uint16_t Length,
+                          SSD1306_Done_t Done, void * Context);
+#endif
@@ -54,6 +54,24 @@ typedef struct
     volatile uint32_t PLLI2SCFGR;
 } RCC_RegDef_t;
 
+/*FLASH interface register definition struct*/
+typedef struct
+{
+    volatile uint32_t ACR;          /*Flash access control register*/
+    volatile uint32_t KEYR;
+    volatile uint32_t OPTKEYR;
+    volatile uint32_t SR;
+    volatile uint32_t CR;
+    volatile uint32_t OPTCR;
+} FLASH_RegDef_t;
+
+/*PWR register definition struct*/
+typedef struct
+{
+    volatile uint32_t CR;           /*Power control register*/
+    volatile uint32_t CSR;          /*Power control/status register*/
+} PWR_RegDef_t;
+
 /*SYSCFG register definition struct*/
 typedef struct
 {
@@ -128,6 +146,56 @@ typedef struct
   volatile uint32_t OR;
 } TIM_RegDef_t;
 
+/*I2C register definition struct*/
+typedef struct
+{
+  volatile uint32_t CR1;        /*I2C control register 1*/
+  volatile uint32_t CR2;        /*I2C control register 2*/
+  volatile uint32_t OAR1;       /*I2C own address register 1*/
+  volatile uint32_t OAR2;       /*I2C own address register 2*/
+  volatile uint32_t DR;         /*I2C data register*/
+  volatile uint32_t SR1;        /*I2C status register 1*/
+  volatile uint32_t SR2;        /*I2C status register 2*/
+  volatile uint32_t CCR;        /*I2C clock control register*/
+  volatile uint32_t TRISE;      /*I2C rise time register*/
+  volatile uint32_t FLTR;       /*I2C filter register*/
+} I2C_RegDef_t;
+
+/*SPI register definition struct*/
+typedef struct
+{
+  volatile uint32_t CR1;        /*SPI control register 1*/
+  volatile uint32_t CR2;        /*SPI control register 2*/
+  volatile uint32_t SR;         /*SPI status register*/
+  volatile uint32_t DR;         /*SPI data register*/
+  volatile uint32_t CRCPR;      /*SPI CRC polynomial register*/
+  volatile uint32_t RXCRCR;     /*SPI RX CRC register*/
+  volatile uint32_t TXCRCR;     /*SPI TX CRC register*/
+  volatile uint32_t I2SCFGR;    /*SPI_I2S configuration register*/
+  volatile uint32_t I2SPR;      /*SPI_I2S prescaler register*/
+} SPI_RegDef_t;
+
+/*DMA stream register definition struct*/
+typedef struct
+{
+  volatile uint32_t CR;         /*DMA stream x configuration register*/
+  volatile uint32_t NDTR;       /*DMA stream x number of data register*/
+  volatile uint32_t PAR;        /*DMA stream x peripheral address register*/
+  volatile uint32_t M0AR;       /*DMA stream x memory 0 address register*/
+  volatile uint32_t M1AR;       /*DMA stream x memory 1 address register*/
+  volatile uint32_t FCR;        /*DMA stream x FIFO control register*/
+} DMA_Stream_RegDef_t;
+
+/*DMA register definition struct*/
+typedef struct
+{
+  volatile uint32_t LISR;       /*DMA low interrupt status register*/
+  volatile uint32_t HISR;       /*DMA high interrupt status register*/
+  volatile uint32_t LIFCR;      /*DMA low interrupt flag clear register*/
+  volatile uint32_t HIFCR;      /*DMA high interrupt flag clear register*/
+  DMA_Stream_RegDef_t S[8];     /*DMA stream 0..7*/
+} DMA_RegDef_t;
+
 
 #define AHB1_BASSADDR               (0x40020000U) /*AHB1 bass address*/
 #define APB1_BASEADDR               (0x40000000U) /*APB1 base address*/
@@ -145,9 +213,19 @@ typedef struct
 #define GPIOJ   ((GPIO_RegDef_t *) (AHB1_BASSADDR + 0x2400U))
 #define GPIOK   ((GPIO_RegDef_t *) (AHB1_BASSADDR + 0x2800U))
 
+/*DMA base address*/
+#define DMA1    ((DMA_RegDef_t *) (AHB1_BASSADDR + 0x6000UL))     /*DMA 1 base address*/
+#define DMA2    ((DMA_RegDef_t *) (AHB1_BASSADDR + 0x6400UL))     /*DMA 2 base address*/
+
 /*RCC base address*/
 #define RCC     ((RCC_RegDef_t *)  (AHB1_BASSADDR + 0x3800UL))
 
+/*FLASH interface base address*/
+#define FLASH   ((FLASH_RegDef_t *) (AHB1_BASSADDR + 0x3C00UL))
+
+/*PWR base address*/
+#define PWR     ((PWR_RegDef_t *) (APB1_BASEADDR + 0x7000UL))
+
 /*SYSCFG base address*/
 #define SYSCFG ((SYSCFG_RegDef_t *) (APB2_BASEADDR + 0x3800UL))
 
@@ -175,6 +253,16 @@ typedef struct
 #define TIM6    ((TIM_RegDef_t *) (APB1_BASEADDR + 0x1000UL))     /*Timer 6 peripheral base address */
 #define TIM7    ((TIM_RegDef_t *) (APB1_BASEADDR + 0x1400UL))     /*Timer 7 peripheral base address */
 
+/*I2C peripheral base address*/
+#define I2C1    ((I2C_RegDef_t *) (APB1_BASEADDR + 0x5400UL))     /*I2C 1 peripheral base address*/
+#define I2C2    ((I2C_RegDef_t *) (APB1_BASEADDR + 0x5800UL))     /*I2C 2 peripheral base address*/
+#define I2C3    ((I2C_RegDef_t *) (APB1_BASEADDR + 0x5C00UL))     /*I2C 3 peripheral base address*/
+
+/*SPI peripheral base address*/
+#define SPI1    ((SPI_RegDef_t *) (APB2_BASEADDR + 0x3000UL))     /*SPI 1 peripheral base address*/
+#define SPI2    ((SPI_RegDef_t *) (APB1_BASEADDR + 0x3800UL))     /*SPI 2 peripheral base address*/
+#define SPI3    ((SPI_RegDef_t *) (APB1_BASEADDR + 0x3C00UL))     /*SPI 3 peripheral base address*/
+
 /*GPIO clock enable*/
 #define GPIOA_CLK_ENB()     (RCC->AHB1ENR |= (0x01U << 0U)) /*GPIOA peripheral clock enable*/
 #define GPIOB_CLK_ENB()     (RCC->AHB1ENR |= (0x01U << 1U)) /*GPIOB peripheral clock enable*/ 
@@ -186,6 +274,12 @@ typedef struct
 #define GPIOH_CLK_ENB()     (RCC->AHB1ENR |= (0x01U << 7U)) /*GPIOH peripheral clock enable*/
 #define GPIOI_CLK_ENB()     (RCC->AHB1ENR |= (0x01U << 8U)) /*GPIOI peripheral clock enable*/
 
+/*DMA clock enable*/
+#define DMA1_CLK_ENB()      (RCC->AHB1ENR |= (0x01U << 21U)) /*DMA1 peripheral clock enable*/
+#define DMA2_CLK_ENB()      (RCC->AHB1ENR |= (0x01U << 22U)) /*DMA2 peripheral clock enable*/
+
+#define PWR_CLK_ENB()       (RCC->APB1ENR |= (0x01U << 28U)) /*PWR peripheral clock enable*/
+
 #define SYSCFG_CLK_ENB()    (RCC->APB2ENR |= (0x01U << 14U)) /*SYSCFG peripheral clock enable*/
 
 /* USART peripheral clock enable */
@@ -0,0 +1,116 @@
+#ifndef STM32F407XX_DMA_DRIVER_H
+#define STM32F407XX_DMA_DRIVER_H
+#include "stm32f407xx.h"
+
+/*DMA stream configuration structure*/
+typedef struct
+{
+    uint8_t Channel;            /*  Specifies the channel used for the specified stream.
+                                    This parameter can be a value of @ref DMA_Channel*/
+    uint8_t Direction;          /*  Specifies if the data will be transferred from memory to peripheral,
+                                    from memory to memory or from peripheral to memory.
+                                    This parameter can be a value of @ref DMA_Data_Transfer_Direction*/
+    uint8_t PeriphInc;          /*  Specifies whether the Peripheral address register should be incremented or not.
+                                    This parameter can be a value of @ref DMA_Increment*/
+    uint8_t MemInc;             /*  Specifies whether the memory address register should be incremented or not.
+                                    This parameter can be a value of @ref DMA_Increment*/
+    uint8_t PeriphDataSize;     /*  Specifies the Peripheral data width.
+                                    This parameter can be a value of @ref DMA_Data_Size*/
+    uint8_t MemDataSize;        /*  Specifies the Memory data width.
+                                    This parameter can be a value of @ref DMA_Data_Size*/
+    uint8_t Mode;               /*  Specifies the operation mode of the DMA stream.
+                                    This parameter can be a value of @ref DMA_Mode*/
+    uint8_t Priority;           /*  Specifies the software priority for the DMA stream.
+                                    This parameter can be a value of @ref DMA_Priority_Level*/
+} DMA_Conf_t;
+
+/*DMA stream callback, called from DMA_IRQHandling with the flags (@ref DMA_Flags) that were set*/
+typedef void (*DMA_Callback_t)(uint8_t Flags, void * Context);
+
+/*DMA stream number*/
+#define DMA_STREAM_0            0U
+#define DMA_STREAM_1            1U
+#define DMA_STREAM_2            2U
+#define DMA_STREAM_3            3U
+#define DMA_STREAM_4            4U
+#define DMA_STREAM_5            5U
+#define DMA_STREAM_6            6U
+#define DMA_STREAM_7            7U
+
+/*DMA_Channel*/
+#define DMA_CHANNEL_0           0U
+#define DMA_CHANNEL_1           1U
+#define DMA_CHANNEL_2           2U
+#define DMA_CHANNEL_3           3U
+#define DMA_CHANNEL_4           4U
+#define DMA_CHANNEL_5           5U
+#define DMA_CHANNEL_6           6U
+#define DMA_CHANNEL_7           7U
+
+/*DMA_Data_Transfer_Direction*/
+#define DMA_DIR_P2M             0U      /*Peripheral to memory direction*/
+#define DMA_DIR_M2P             1U      /*Memory to peripheral direction*/
+#define DMA_DIR_M2M             2U      /*Memory to memory direction*/
+
+/*DMA_Increment*/
+#define DMA_INC_DISABLE         0U      /*Address is fixed*/
+#define DMA_INC_ENABLE          1U      /*Address is incremented after each data transfer*/
+
+/*DMA_Data_Size*/
+#define DMA_SIZE_BYTE           0U      /*8 bit data*/
+#define DMA_SIZE_HALFWORD       1U      /*16 bit data*/
+#define DMA_SIZE_WORD           2U      /*32 bit data*/
+
+/*DMA_Mode*/
+#define DMA_MODE_NORMAL         0U      /*The stream stops when NDTR reaches 0*/
+#define DMA_MODE_CIRCULAR       1U      /*NDTR is reloaded and the transfer restarts automatically*/
+
+/*DMA_Priority_Level*/
+#define DMA_PRIORITY_LOW        0U
+#define DMA_PRIORITY_MEDIUM     1U
+#define DMA_PRIORITY_HIGH       2U
+#define DMA_PRIORITY_VERY_HIGH  3U
+
+/*DMA_Flags, normalized stream flags (same layout for every stream)*/
+#define DMA_FLAG_FE             (0x01U << 0U)   /*FIFO error*/
+#define DMA_FLAG_DME            (0x01U << 2U)   /*Direct mode error*/
+#define DMA_FLAG_TE             (0x01U << 3U)   /*Transfer error*/
+#define DMA_FLAG_HT             (0x01U << 4U)   /*Half transfer*/
+#define DMA_FLAG_TC             (0x01U << 5U)   /*Transfer complete*/
+#define DMA_FLAG_ALL            (DMA_FLAG_FE | DMA_FLAG_DME | DMA_FLAG_TE | DMA_FLAG_HT | DMA_FLAG_TC)
+
+/*DMA_SxCR register bits*/
+#define DMA_SXCR_EN             0U      /*Stream enable*/
+#define DMA_SXCR_DMEIE          1U      /*Direct mode error interrupt enable*/
+#define DMA_SXCR_TEIE           2U      /*Transfer error interrupt enable*/
+#define DMA_SXCR_HTIE           3U      /*Half transfer interrupt enable*/
+#define DMA_SXCR_TCIE           4U      /*Transfer complete interrupt enable*/
+#define DMA_SXCR_DIR            6U      /*Data transfer direction*/
+#define DMA_SXCR_CIRC           8U      /*Circular mode*/
+#define DMA_SXCR_PINC           9U      /*Peripheral increment mode*/
+#define DMA_SXCR_MINC           10U     /*Memory increment mode*/
+#define DMA_SXCR_PSIZE          11U     /*Peripheral data size*/
+#define DMA_SXCR_MSIZE          13U     /*Memory data size*/
+#define DMA_SXCR_PL             16U     /*Priority level*/
+#define DMA_SXCR_CHSEL          25U     /*Channel selection*/
+
+/*Macro to get the DMA index (0 for DMA1, 1 for DMA2)*/
+#define DMAx_TO_INDEX(DMAx)     ((DMAx == DMA2) ? 1U : 0U)
+
+/*Macro to map DMAx stream to its IRQ number*/
+#define DMA_STREAM_TO_IRQ(DMAx, Stream) \
+        ((DMAx == DMA1) ? \
+            (((Stream) < 7U) ? (IRQ_NO_DMA1_STREAM0 + (Stream)) : IRQ_NO_DMA1_STREAM7) : \
+            (((Stream) < 5U) ? (IRQ_NO_DMA2_STREAM0 + (Stream)) : (IRQ_NO_DMA2_STREAM5 + ((Stream) - 5U))))
+
+void DMA_Init(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Conf_t DMA_Conf);
+void DMA_Start(DMA_RegDef_t * DMAx, uint8_t Stream, uint32_t PeriphAddr, uint32_t MemAddr, uint16_t Length);
+void DMA_Stop(DMA_RegDef_t * DMAx, uint8_t Stream);
+void DMA_SetDataFormat(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t MemInc, uint8_t DataSize);
+uint16_t DMA_GetCounter(DMA_RegDef_t * DMAx, uint8_t Stream);
+uint8_t DMA_GetFlags(DMA_RegDef_t * DMAx, uint8_t Stream);
+void DMA_ClearFlags(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Flags);
+void DMA_IT_Init(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Flags, uint8_t Priority);
+void DMA_RegisterCallback(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Callback_t Callback, void * Context);
+void DMA_IRQHandling(DMA_RegDef_t * DMAx, uint8_t Stream);
+#endif
@@ -8,6 +8,7 @@ typedef struct
     uint8_t GPIO_PinMode;               /*GPIO pin mode*/
     uint8_t GPIO_OutType;               /*GPIO output type*/
     uint8_t GPIO_PUPD;                  /*Pull-up/pull-down resistor selection*/
+    uint8_t GPIO_Speed;                 /*Output speed*/
     uint8_t GPIO_EdgeTrigger;           /*Edge trigger selection*/
     uint8_t GPIO_AltFunc;               /*Alternate function*/
 } GPIO_PinConf_t;
@@ -40,6 +41,12 @@ typedef struct
 #define GPIO_OUT_PP             0
 #define GPIO_OUT_OD             1    
 
+/*GPIO output speed*/
+#define GPIO_SPEED_LOW          0U
+#define GPIO_SPEED_MEDIUM       1U
+#define GPIO_SPEED_FAST         2U
+#define GPIO_SPEED_HIGH         3U
+
 /*GPIO pull-up/pull-down*/
 #define GPIO_NO_PUPD            0
 #define GPIO_PU                 1
@@ -68,6 +75,11 @@ typedef struct
 #define GPIO_ALT_AF15   15U
 
 
+/*Mask of a pin for the port functions*/
+#define GPIO_PIN_MASK(PinNum)   ((uint16_t)(0x01U << (PinNum)))
+/*GPIOx_BSRR: bits [15:0] set the pins, bits [31:16] reset them*/
+#define GPIO_BSRR_RESET_POS     16U
+
 /*Macro to get GPIO port code for SYSCFG_EXTICR register configuration*/
 #define SYSCFG_EXTICR_PORTCODE(GPIOx)\
         ((GPIOx == GPIOA) ? 0U : \
@@ -90,9 +102,47 @@ typedef struct
          ((PinNum >= 5U) && (PinNum <= 9U)) ? IRQ_NO_EXTI9_5 : \
          ((PinNum >= 10U) && (PinNum <= 15U)) ? IRQ_NO_EXTI10_15 : IRQ_NO_EXTI0)
 
+/*  EXTI dispatch.
+    The driver owns the EXTI vectors of the lines 0 to 15, including the shared EXTI9_5 and EXTI15_10 ones.
+    Each vector clears the pending lines of its range in one write, then walks them (CTZ): the edge timestamp
+    (DWT_CYCCNT at the dispatch) and the hit counter of each line are updated and its callback is called.
+    An edge arriving during the callbacks pends the line again. A pending line without callback is only cleared.
+    Set GPIO_EXTI_VECTORS to 0 to write the EXTIx_IRQHandler functions in the application instead,
+    they call GPIO_EXTI_IRQHandling with the lines of the vector. */
+#ifndef GPIO_EXTI_VECTORS
+#define GPIO_EXTI_VECTORS       1U
+#endif
+
+/*Number of EXTI lines connected to the GPIO pins*/
+#define GPIO_EXTI_LINE_NUM      16U
+/*Lines of the shared EXTI vectors*/
+#define GPIO_EXTI_LINES_9_5     ((uint16_t)0x03E0U)
+#define GPIO_EXTI_LINES_15_10   ((uint16_t)0xFC00U)
+
+/*Callback of an EXTI line, called from its EXTI interrupt once the pending bit is cleared*/
+typedef void (*GPIO_EXTI_Callback_t)(uint8_t Line, void * Context);
+
+/*Dispatch state of an EXTI line*/
+typedef struct
+{
+    GPIO_EXTI_Callback_t Callback;      /*Called on each edge, NULL: the edge is only counted*/
+    void * Context;                     /*Given to the callback*/
+    volatile uint32_t EdgeStamp;        /*DWT_CYCCNT value at the dispatch of the last edge*/
+    volatile uint32_t HitCount;         /*Number of dispatched edges*/
+} GPIO_EXTI_Line_t;
+
 void GPIO_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t PinConf);
 void GPIO_PinWrite(GPIO_RegDef_t * GPIOx, uint8_t PinNumber, uint8_t Value);
 void GPIO_PinToggle(GPIO_RegDef_t * GPIOx, uint8_t PinNumber);
 uint8_t GPIO_PinRead(GPIO_RegDef_t * GPIOx, uint8_t PinNumber);
+void GPIO_PortWrite(GPIO_RegDef_t * GPIOx, uint16_t Mask, uint16_t Value);
+void GPIO_PortSetMask(GPIO_RegDef_t * GPIOx, uint16_t Mask);
+void GPIO_PortClearMask(GPIO_RegDef_t * GPIOx, uint16_t Mask);
+void GPIO_PortToggleMask(GPIO_RegDef_t * GPIOx, uint16_t Mask);
+uint16_t GPIO_PortRead(GPIO_RegDef_t * GPIOx);
 void GPIO_IT_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t GPIOPinConf, uint8_t Priority);
+uint8_t GPIO_EXTI_Register(uint8_t Line, GPIO_EXTI_Callback_t Callback, void * Context);
+uint8_t GPIO_EXTI_Unregister(uint8_t Line);
+const GPIO_EXTI_Line_t * GPIO_EXTI_GetLine(uint8_t Line);
+void GPIO_EXTI_IRQHandling(uint16_t Lines);
 #endif
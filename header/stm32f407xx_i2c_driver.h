@@ -0,0 +1,196 @@
+#ifndef STM32F407XX_I2C_DRIVER_H
+#define STM32F407XX_I2C_DRIVER_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_rcc_driver.h"
+
+/*  Interrupt and DMA driven I2C master.
+    A transfer is a write of HeaderLength + TxLength bytes (e.g, register address then data), followed by a read
+    of RxLength bytes after a repeated start. Either part can be empty, an empty transfer only probes the address.
+    The transfers are queued per bus (intrusive list, the memory belongs to the caller) and run one after the
+    other from the interrupts, so several devices share one bus without waiting for each other. Done is called
+    from the interrupt when a transfer ends, it can submit the next transfer.
+    With UseDMA, the data parts of at least I2C_DMA_MIN bytes are moved by DMA1 (see I2C_DMA_STREAMS), the
+    header bytes and the short parts by the event interrupt.
+    Errors: a NACK ends the transfer with a STOP, an arbitration loss restarts it up to I2C_RETRY_MAX times,
+    a bus error resets the peripheral and ends the transfer, the bus is then freed from PendSV (I2C_Recover:
+    9 SCL pulses and a STOP through GPIO) before the next queued transfer starts. WorkQueue_Init must be called.
+    Speed: standard mode up to 100 kHz, fast mode up to 400 kHz. The I2C peripheral of the STM32F407 has no
+    Fast-mode Plus (1 MHz), faster devices (e.g, a display at 60 FPS) must use SPI. */
+
+/*I2C configuration structure*/
+typedef struct
+{
+    uint32_t ClockSpeed;                /*SCL frequency in Hz, up to I2C_SPEED_FAST*/
+    uint8_t DutyCycle;                  /*Fast mode duty cycle, @ref I2C_Duty_Cycle*/
+    uint8_t UseDMA;                     /*TRUE: the long data parts are moved by DMA*/
+    GPIO_RegDef_t * pSclPort;           /*SCL pin, used by I2C_Recover, NULL: the bus is not freed by GPIO*/
+    uint8_t SclPin;
+    GPIO_RegDef_t * pSdaPort;           /*SDA pin, used by I2C_Recover*/
+    uint8_t SdaPin;
+} I2C_Conf_t;
+
+/*Maximum number of header bytes (e.g, register address, display control byte)*/
+#define I2C_HEADER_MAX              2U
+
+struct I2C_Transfer_s;
+/*Transfer completion callback, called from the interrupt, pXfer->Status gives the result*/
+typedef void (*I2C_Done_t)(struct I2C_Transfer_s * pXfer);
+
+/*I2C transfer, it must stay valid and unchanged until Done is called*/
+typedef struct I2C_Transfer_s
+{
+    uint8_t Address;                    /*7 bit device address*/
+    uint8_t Header[I2C_HEADER_MAX];     /*Bytes written first, by the interrupt*/
+    uint8_t HeaderLength;
+    const uint8_t * pTxData;            /*Bytes written after the header*/
+    uint16_t TxLength;
+    uint8_t * pRxData;                  /*Bytes read after a repeated start (or a start if nothing is written)*/
+    uint16_t RxLength;
+    I2C_Done_t Done;                    /*Called when the transfer ends, NULL: not used*/
+    void * Context;                     /*Application data, not used by the driver*/
+    volatile uint8_t Status;            /*@ref I2C_Status*/
+    uint8_t Retries;                    /*Restarts after an arbitration loss*/
+    struct I2C_Transfer_s * pNext;      /*Queue link, used by the driver*/
+} I2C_Transfer_t;
+
+/*I2C statistics, the throughput is (BytesTx + BytesRx) / ActiveTime*/
+typedef struct
+{
+    uint32_t Transfers;                 /*Number of completed transfers (with or without error)*/
+    uint32_t BytesTx;                   /*Bytes written, address bytes excluded*/
+    uint32_t BytesRx;                   /*Bytes read*/
+    uint32_t ActiveTime;                /*Time the bus was used by the transfers, in us*/
+    uint32_t Nacks;                     /*Transfers ended by a NACK*/
+    uint32_t ArbitrationLost;           /*Arbitration losses*/
+    uint32_t BusErrors;                 /*Misplaced START or STOP conditions*/
+    uint32_t Recoveries;                /*Peripheral resets and bus recoveries*/
+    uint16_t HighWater;                 /*Maximum number of queued transfers*/
+} I2C_Stats_t;
+
+/*I2C_Speed*/
+#define I2C_SPEED_STANDARD          100000U
+#define I2C_SPEED_FAST              400000U
+
+/*I2C_Duty_Cycle, fast mode SCL low/high ratio*/
+#define I2C_DUTY_2                  0U      /*Tlow/Thigh = 2*/
+#define I2C_DUTY_16_9               1U      /*Tlow/Thigh = 16/9, PCLK1 multiple of 10 MHz for 400 kHz*/
+
+/*I2C_Status*/
+#define I2C_STATUS_OK               0U      /*Transfer done*/
+#define I2C_STATUS_PENDING          1U      /*Queued or running*/
+#define I2C_STATUS_NACK             2U      /*The address or a data byte was not acknowledged*/
+#define I2C_STATUS_ARLO             3U      /*Arbitration lost I2C_RETRY_MAX + 1 times*/
+#define I2C_STATUS_BUS_ERROR        4U      /*Bus error, the bus was recovered*/
+
+/*Data parts moved by DMA must have at least this number of bytes*/
+#define I2C_DMA_MIN                 8U
+/*Restarts after an arbitration loss*/
+#define I2C_RETRY_MAX               3U
+/*SCL pulses of the bus recovery, enough for a slave to shift out the byte it holds SDA for*/
+#define I2C_RECOVERY_PULSES         9U
+
+/*I2C_CR1 register bits*/
+#define I2C_CR1_PE                  0U      /*Peripheral enable*/
+#define I2C_CR1_START               8U      /*Start generation*/
+#define I2C_CR1_STOP                9U      /*Stop generation*/
+#define I2C_CR1_ACK                 10U     /*Acknowledge enable*/
+#define I2C_CR1_POS                 11U     /*Acknowledge/PEC position*/
+#define I2C_CR1_SWRST               15U     /*Software reset*/
+
+/*I2C_CR2 register bits*/
+#define I2C_CR2_FREQ                0U      /*Peripheral clock frequency in MHz [5:0]*/
+#define I2C_CR2_ITERREN             8U      /*Error interrupt enable*/
+#define I2C_CR2_ITEVTEN             9U      /*Event interrupt enable*/
+#define I2C_CR2_ITBUFEN             10U     /*Buffer interrupt enable (TXE, RXNE)*/
+#define I2C_CR2_DMAEN               11U     /*DMA requests enable*/
+#define I2C_CR2_LAST                12U     /*Next DMA EOT is the last transfer (NACK)*/
+
+/*I2C_SR1 register bits*/
+#define I2C_SR1_SB                  0U      /*Start bit generated*/
+#define I2C_SR1_ADDR                1U      /*Address sent*/
+#define I2C_SR1_BTF                 2U      /*Byte transfer finished*/
+#define I2C_SR1_RXNE                6U      /*Data register not empty*/
+#define I2C_SR1_TXE                 7U      /*Data register empty*/
+#define I2C_SR1_BERR                8U      /*Bus error*/
+#define I2C_SR1_ARLO                9U      /*Arbitration lost*/
+#define I2C_SR1_AF                  10U     /*Acknowledge failure*/
+#define I2C_SR1_OVR                 11U     /*Overrun/underrun*/
+
+/*I2C_SR2 register bits*/
+#define I2C_SR2_MSL                 0U      /*Master mode*/
+#define I2C_SR2_BUSY                1U      /*Bus busy*/
+#define I2C_SR2_TRA                 2U      /*Transmitter*/
+
+/*I2C_CCR register bits*/
+#define I2C_CCR_CCR                 0U      /*Clock control [11:0]*/
+#define I2C_CCR_DUTY                14U     /*Fast mode duty cycle*/
+#define I2C_CCR_FS                  15U     /*Fast mode*/
+
+/*  DMA1 streams of each I2C (RM0090 DMA1 request mapping), TX stream, TX channel, RX stream, RX channel.
+    I2C2 and I2C3 both receive on stream 2, only one of them can use DMA. */
+#define I2C_DMA_STREAMS \
+        {{DMA_STREAM_6, DMA_CHANNEL_1, DMA_STREAM_0, DMA_CHANNEL_1}, \
+         {DMA_STREAM_7, DMA_CHANNEL_7, DMA_STREAM_2, DMA_CHANNEL_7}, \
+         {DMA_STREAM_4, DMA_CHANNEL_3, DMA_STREAM_2, DMA_CHANNEL_3}}
+
+/*Number of I2C peripherals handled by the driver*/
+#define I2C_INSTANCE_NUM            3U
+
+#if defined(I2C_HOST_MOCK)
+/*  Host build: the register blocks are memory (stm32f407xx_i2c_mock.c), the driver reports its data register
+    and ADDR accesses to the mock, which plays the bus and the devices and calls the interrupt handlers.
+    Interrupt mode only (UseDMA = FALSE). */
+extern I2C_RegDef_t I2C_MockRegs[I2C_INSTANCE_NUM];
+#undef I2C1
+#undef I2C2
+#undef I2C3
+#define I2C1    (&I2C_MockRegs[0])
+#define I2C2    (&I2C_MockRegs[1])
+#define I2C3    (&I2C_MockRegs[2])
+
+/*Device on the mock bus: the first byte written selects the register, the next bytes are written or read from it*/
+typedef struct
+{
+    uint8_t Address;                    /*7 bit address*/
+    uint8_t Regs[256];                  /*Register file*/
+    uint8_t Pointer;                    /*Register of the next access*/
+    uint32_t Writes;                    /*Number of bytes written, register selection included*/
+    uint32_t Reads;                     /*Number of bytes read*/
+} I2C_MockDevice_t;
+
+void I2C_MockAttach(I2C_RegDef_t * I2Cx, I2C_MockDevice_t * pDevice);
+void I2C_MockInjectError(I2C_RegDef_t * I2Cx, uint8_t FlagPos);
+uint32_t I2C_MockRun(I2C_RegDef_t * I2Cx);
+uint32_t I2C_MockRunWork(void);
+uint32_t I2C_MockGetProtocolErrors(I2C_RegDef_t * I2Cx);
+void I2C_MockDataWritten(I2C_RegDef_t * I2Cx);
+void I2C_MockDataRead(I2C_RegDef_t * I2Cx);
+void I2C_MockAddrCleared(I2C_RegDef_t * I2Cx);
+#endif
+
+/*Macro to map I2Cx to its index in the driver state tables, I2C_INSTANCE_NUM if the I2C is not handled.
+  I2C_Init, I2C_IT_Init and I2C_Submit reject such an I2C, the other functions must only be called for an
+  initialized one*/
+#define I2Cx_TO_INDEX(I2Cx) \
+        ((I2Cx == I2C1) ? 0U : \
+         (I2Cx == I2C2) ? 1U : \
+         (I2Cx == I2C3) ? 2U : I2C_INSTANCE_NUM)
+
+/*Macro to map I2Cx to its event IRQ number, the error IRQ number follows it. Only used for a handled I2C*/
+#define I2Cx_TO_EV_IRQ(I2Cx) \
+        ((I2Cx == I2C1) ? IRQ_NO_I2C1_EV : \
+         (I2Cx == I2C2) ? IRQ_NO_I2C2_EV : \
+         (I2Cx == I2C3) ? IRQ_NO_I2C3_EV : IRQ_NO_I2C1_EV)
+
+uint8_t I2C_Init(I2C_RegDef_t * I2Cx, I2C_Conf_t I2C_Conf);
+void I2C_IT_Init(I2C_RegDef_t * I2Cx, uint8_t Priority);
+uint8_t I2C_Submit(I2C_RegDef_t * I2Cx, I2C_Transfer_t * pXfer);
+uint8_t I2C_IsIdle(I2C_RegDef_t * I2Cx);
+uint8_t I2C_GetBusyFlag(I2C_RegDef_t * I2Cx);
+void I2C_Recover(I2C_RegDef_t * I2Cx);
+const I2C_Stats_t * I2C_GetStats(I2C_RegDef_t * I2Cx);
+void I2C_EV_IRQHandling(I2C_RegDef_t * I2Cx);
+void I2C_ER_IRQHandling(I2C_RegDef_t * I2Cx);
+#endif
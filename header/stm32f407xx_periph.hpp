@@ -0,0 +1,329 @@
+#ifndef STM32F407XX_PERIPH_HPP
+#define STM32F407XX_PERIPH_HPP
+
+/*  Optional header-only C++ (C++17) access layer over the C drivers.
+    The peripheral instance, the pin number and the configuration are template parameters: the register addresses,
+    the bit positions and the masks are compile-time constants, a pin write is one store and the configuration
+    of a pin or of a pin group folds into one read-modify-write per register.
+    - Pin<PortD, 12>, PinGroup<PortD, 12, 13, 14, 15>: GPIO, written through BSRR.
+    - Usart<3>, Timer<4>: instance constants and fast register accesses. Their initialization goes through the
+      C drivers, which keep the baud rate and the prescalers in sync with the clock changes.
+    Every type gives its registers (Regs()) and its constants, so the C drivers can be called on the same instance
+    (e.g, GPIO_IT_Init, USART_Transmit_IT, TIM_OC_Init). Nothing is instantiated, all the members are static. */
+
+extern "C"
+{
+#include "stm32f407xx.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_usart_driver.h"
+#include "stm32f407xx_timer_driver.h"
+}
+
+namespace stm32f407
+{
+
+/*GPIO port, the value is the port index (register block offset / 0x400 and RCC_AHB1ENR bit)*/
+enum Port : uint8_t
+{
+    PortA = 0U, PortB, PortC, PortD, PortE, PortF, PortG, PortH, PortI
+};
+
+/*GPIO pin*/
+template <Port P, uint8_t N>
+struct Pin
+{
+    static_assert(N < 16U, "GPIO pin number must be in [0..15]");
+
+    static constexpr uint8_t Number = N;
+    static constexpr uint16_t Mask = (uint16_t)(0x01U << N);
+    static constexpr uintptr_t Base = AHB1_BASSADDR + (0x0400U * P);
+
+    static GPIO_RegDef_t * Regs(void)
+    {
+        return reinterpret_cast<GPIO_RegDef_t *>(Base);
+    }
+
+    /*Enable the port clock and configure the pin, one read-modify-write per register*/
+    template <uint8_t Mode, uint8_t OutType = GPIO_OUT_PP, uint8_t PUPD = GPIO_NO_PUPD, uint8_t AltFunc = GPIO_ALT_AF0,
+              uint8_t Speed = GPIO_SPEED_LOW>
+    static void Init(void)
+    {
+        static_assert(Mode <= GPIO_MODE_ANALOG, "Mode must be a GPIO_MODE_x value");
+        static_assert(AltFunc <= GPIO_ALT_AF15, "AltFunc must be a GPIO_ALT_AFx value");
+        static_assert(Speed <= GPIO_SPEED_HIGH, "Speed must be a GPIO_SPEED_x value");
+
+        RCC->AHB1ENR |= (0x01UL << (RCC_AHB1ENR_GPIOAEN + P));
+        Regs()->MODER = (Regs()->MODER & ~(0x03UL << (N * 2U))) | ((uint32_t)Mode << (N * 2U));
+        Regs()->PUPDR = (Regs()->PUPDR & ~(0x03UL << (N * 2U))) | ((uint32_t)PUPD << (N * 2U));
+        if constexpr ((Mode == GPIO_MODE_OUTPUT) || (Mode == GPIO_MODE_ALT))
+        {
+            Regs()->OTYPER = (Regs()->OTYPER & ~(uint32_t)Mask) | ((uint32_t)OutType << N);
+            Regs()->OSPEEDR = (Regs()->OSPEEDR & ~(0x03UL << (N * 2U))) | ((uint32_t)Speed << (N * 2U));
+        }
+        if constexpr (Mode == GPIO_MODE_ALT)
+        {
+            if constexpr (N < 8U)
+            {
+                Regs()->AFRL = (Regs()->AFRL & ~(0x0FUL << (N * 4U))) | ((uint32_t)AltFunc << (N * 4U));
+            }
+            else
+            {
+                Regs()->AFRH = (Regs()->AFRH & ~(0x0FUL << ((N - 8U) * 4U))) | ((uint32_t)AltFunc << ((N - 8U) * 4U));
+            }
+        }
+    }
+
+    static void Set(void)
+    {
+        Regs()->BSRR = Mask;
+    }
+
+    static void Clear(void)
+    {
+        Regs()->BSRR = ((uint32_t)Mask << GPIO_BSRR_RESET_POS);
+    }
+
+    static void Write(bool Value)
+    {
+        Regs()->BSRR = Value ? (uint32_t)Mask : ((uint32_t)Mask << GPIO_BSRR_RESET_POS);
+    }
+
+    static void Toggle(void)
+    {
+        GPIO_PortToggleMask(Regs(), Mask);
+    }
+
+    static bool Read(void)
+    {
+        return (Regs()->IDR & Mask) != 0U;
+    }
+
+    /*EXTI interrupt of the pin, through the C driver*/
+    static void IT_Init(uint8_t EdgeTrigger, uint8_t Priority)
+    {
+        GPIO_PinConf_t Conf = {};
+
+        Conf.GPIO_PinNumber   = N;
+        Conf.GPIO_PinMode     = GPIO_MODE_INPUT;
+        Conf.GPIO_EdgeTrigger = EdgeTrigger;
+        GPIO_IT_Init(Regs(), Conf, Priority);
+    }
+
+    /*Callback of the EXTI line of the pin, called by the GPIO driver EXTI vectors*/
+    static bool OnEdge(GPIO_EXTI_Callback_t Callback, void * Context = nullptr)
+    {
+        return GPIO_EXTI_Register(N, Callback, Context) == TRUE;
+    }
+};
+
+/*Pins of one port updated together, each access is one register store*/
+template <Port P, uint8_t... N>
+struct PinGroup
+{
+    static_assert(sizeof...(N) > 0U, "A pin group needs at least one pin");
+    static_assert(((N < 16U) && ...), "GPIO pin number must be in [0..15]");
+
+    static constexpr uint16_t Mask = (uint16_t)((0x01U << N) | ...);
+    static constexpr uintptr_t Base = AHB1_BASSADDR + (0x0400U * P);
+
+    static GPIO_RegDef_t * Regs(void)
+    {
+        return reinterpret_cast<GPIO_RegDef_t *>(Base);
+    }
+
+    /*Same configuration for all the pins, one read-modify-write per register*/
+    template <uint8_t Mode, uint8_t OutType = GPIO_OUT_PP, uint8_t PUPD = GPIO_NO_PUPD, uint8_t Speed = GPIO_SPEED_LOW>
+    static void Init(void)
+    {
+        static_assert(Mode != GPIO_MODE_ALT, "Configure the alternate function pins one by one with Pin::Init");
+        constexpr uint32_t Mask2 = ((0x03UL << (N * 2U)) | ...);
+
+        RCC->AHB1ENR |= (0x01UL << (RCC_AHB1ENR_GPIOAEN + P));
+        Regs()->MODER = (Regs()->MODER & ~Mask2) | (((uint32_t)Mode << (N * 2U)) | ...);
+        Regs()->PUPDR = (Regs()->PUPDR & ~Mask2) | (((uint32_t)PUPD << (N * 2U)) | ...);
+        if constexpr (Mode == GPIO_MODE_OUTPUT)
+        {
+            Regs()->OTYPER = (Regs()->OTYPER & ~(uint32_t)Mask) | (((uint32_t)OutType << N) | ...);
+            Regs()->OSPEEDR = (Regs()->OSPEEDR & ~Mask2) | (((uint32_t)Speed << (N * 2U)) | ...);
+        }
+    }
+
+    /*Value is in port bit positions (bit n = pin n), the bits outside the group are ignored*/
+    static void Write(uint16_t Value)
+    {
+        Regs()->BSRR = ((uint32_t)(Mask & ~Value) << GPIO_BSRR_RESET_POS) | (uint32_t)(Mask & Value);
+    }
+
+    static void Set(void)
+    {
+        Regs()->BSRR = Mask;
+    }
+
+    static void Clear(void)
+    {
+        Regs()->BSRR = ((uint32_t)Mask << GPIO_BSRR_RESET_POS);
+    }
+
+    static void Toggle(void)
+    {
+        GPIO_PortToggleMask(Regs(), Mask);
+    }
+
+    static uint16_t Read(void)
+    {
+        return (uint16_t)(Regs()->IDR & Mask);
+    }
+};
+
+/*USART/UART instance, N in [1..6]*/
+template <uint8_t N>
+struct Usart
+{
+    static_assert((N >= 1U) && (N <= 6U), "USART number must be in [1..6]");
+
+    static constexpr uintptr_t Base =
+        (N == 1U) ? (APB2_BASEADDR + 0x1000U) : (N == 2U) ? (APB1_BASEADDR + 0x4400U) :
+        (N == 3U) ? (APB1_BASEADDR + 0x4800U) : (N == 4U) ? (APB1_BASEADDR + 0x4C00U) :
+        (N == 5U) ? (APB1_BASEADDR + 0x5000U) : (APB2_BASEADDR + 0x1400U);
+    /*USART1 and USART6 are on APB2*/
+    static constexpr bool OnAPB2 = (N == 1U) || (N == 6U);
+    static constexpr uint8_t ClockBit =
+        (N == 1U) ? RCC_APB2ENR_USART1EN : (N == 2U) ? RCC_APB1ENR_USART2EN : (N == 3U) ? RCC_APB1ENR_USART3EN :
+        (N == 4U) ? RCC_APB1ENR_UART4EN : (N == 5U) ? RCC_APB1ENR_UART5EN : RCC_APB2ENR_USART6EN;
+    static constexpr uint8_t IRQNumber =
+        (N == 1U) ? IRQ_NO_USART1 : (N == 2U) ? IRQ_NO_USART2 : (N == 3U) ? IRQ_NO_USART3 :
+        (N == 4U) ? IRQ_NO_UART4 : (N == 5U) ? IRQ_NO_UART5 : IRQ_NO_USART6;
+
+    static USART_RegDef_t * Regs(void)
+    {
+        return reinterpret_cast<USART_RegDef_t *>(Base);
+    }
+
+    static void EnableClock(void)
+    {
+        if constexpr (OnAPB2)
+        {
+            RCC->APB2ENR |= (0x01UL << ClockBit);
+        }
+        else
+        {
+            RCC->APB1ENR |= (0x01UL << ClockBit);
+        }
+    }
+
+    /*The C driver programs the frame format, follows the clock changes and owns the interrupt driven transmission*/
+    template <uint8_t Mode = USART_MODE_TX_RX, uint8_t WordLength = USART_WORDLENGTH_8B,
+              uint8_t Parity = USART_PARITY_NONE, uint8_t StopBits = USART_STOPBITS_1,
+              uint8_t OverSampling = USART_OVERSAMPLING_16>
+    static void Init(uint32_t BaudRate)
+    {
+        USART_Conf_t Conf = {};
+
+        Conf.Mode         = Mode;
+        Conf.BaudRate     = BaudRate;
+        Conf.WordLength   = WordLength;
+        Conf.StopBits     = StopBits;
+        Conf.Parity       = Parity;
+        Conf.OverSampling = OverSampling;
+        EnableClock();
+        USART_Init(Regs(), Conf);
+    }
+
+    static bool TxEmpty(void)
+    {
+        return (Regs()->SR & (0x01UL << USART_SR_TXE)) != 0U;
+    }
+
+    static bool RxNotEmpty(void)
+    {
+        return (Regs()->SR & (0x01UL << USART_SR_RXNE)) != 0U;
+    }
+
+    /*Blocking byte transmission, do not mix with USART_Transmit_IT on the same instance*/
+    static void Put(uint8_t Data)
+    {
+        while (!TxEmpty())
+        {
+        }
+        Regs()->DR = Data;
+    }
+
+    static uint8_t Get(void)
+    {
+        return (uint8_t)Regs()->DR;
+    }
+};
+
+/*Basic and general purpose timer instance, N in [2..7] as the C driver*/
+template <uint8_t N>
+struct Timer
+{
+    static_assert((N >= 2U) && (N <= 7U), "Timer number must be in [2..7]");
+
+    static constexpr uintptr_t Base = APB1_BASEADDR + (0x0400U * (N - 2U));
+    static constexpr uint8_t ClockBit = RCC_APB1ENR_TIM2EN + (N - 2U);
+    static constexpr uint8_t IRQNumber =
+        (N == 2U) ? IRQ_NO_TIM2 : (N == 3U) ? IRQ_NO_TIM3 : (N == 4U) ? IRQ_NO_TIM4 :
+        (N == 5U) ? IRQ_NO_TIM5 : (N == 6U) ? IRQ_NO_TIM6_DAC : IRQ_NO_TIM7;
+    /*Basic timers (TIM6, TIM7) have no capture/compare channel*/
+    static constexpr uint8_t Channels = (N <= 5U) ? 4U : 0U;
+
+    static TIM_RegDef_t * Regs(void)
+    {
+        return reinterpret_cast<TIM_RegDef_t *>(Base);
+    }
+
+    static void EnableClock(void)
+    {
+        RCC->APB1ENR |= (0x01UL << ClockBit);
+    }
+
+    /*The C driver derives the prescaler from CounterClock and follows the clock changes*/
+    static void Init(TIM_Base_Conf_t Conf)
+    {
+        EnableClock();
+        TIM_Base_Init(Regs(), Conf);
+    }
+
+    static void Start(void)
+    {
+        Regs()->CR1 |= (0x01UL << TIM_CR1_CEN);
+    }
+
+    static void Stop(void)
+    {
+        Regs()->CR1 &= ~(0x01UL << TIM_CR1_CEN);
+    }
+
+    static uint32_t Counter(void)
+    {
+        return Regs()->CNT;
+    }
+
+    static void SetPeriod(uint32_t Period)
+    {
+        Regs()->ARR = Period;
+    }
+
+    /*Channel in [0..3] as the C driver*/
+    template <uint8_t Channel>
+    static void SetCompare(uint32_t Value)
+    {
+        static_assert(Channel < Channels, "The timer has no such capture/compare channel");
+        Regs()->CCR[Channel] = Value;
+    }
+
+    static bool UpdatePending(void)
+    {
+        return (Regs()->SR & (0x01UL << TIM_SR_UIF)) != 0U;
+    }
+
+    /*SR bits are cleared by writing 0, the other flags are kept by writing 1*/
+    static void ClearUpdate(void)
+    {
+        Regs()->SR = ~(0x01UL << TIM_SR_UIF);
+    }
+};
+
+}
+#endif
@@ -0,0 +1,166 @@
+#ifndef STM32F407XX_RCC_DRIVER_H
+#define STM32F407XX_RCC_DRIVER_H
+#include "stm32f407xx.h"
+
+/*Oscillator frequencies, HSE_VALUE is the 8 MHz crystal of the STM32F407 Discovery board*/
+#ifndef HSI_VALUE
+#define HSI_VALUE                   16000000U
+#endif
+#ifndef HSE_VALUE
+#define HSE_VALUE                   8000000U
+#endif
+
+/*System clock configuration structure*/
+typedef struct
+{
+    uint8_t SysClkSource;       /*  Specifies the system clock source.
+                                    This parameter can be a value of @ref RCC_SysClk_Source*/
+    uint8_t PLLSource;          /*  Specifies the PLL entry clock source.
+                                    This parameter can be a value of @ref RCC_PLL_Source*/
+    uint8_t PLLM;               /*  Division factor for the PLL input clock, the PLL input must be in [1..2] MHz.
+                                    This parameter can be a number between Min_Data = 2 and Max_Data = 63*/
+    uint16_t PLLN;              /*  Multiplication factor for the VCO, the VCO output must be in [100..432] MHz.
+                                    This parameter can be a number between Min_Data = 50 and Max_Data = 432*/
+    uint8_t PLLP;               /*  Division factor for the main system clock.
+                                    This parameter can be a value of 2, 4, 6 or 8*/
+    uint8_t PLLQ;               /*  Division factor for the USB OTG FS, SDIO and RNG clocks (48 MHz).
+                                    This parameter can be a number between Min_Data = 2 and Max_Data = 15*/
+    uint8_t AHBPrescaler;       /*  Specifies the AHB clock (HCLK) divider.
+                                    This parameter can be a value of @ref RCC_AHB_Prescaler*/
+    uint8_t APB1Prescaler;      /*  Specifies the APB1 clock (PCLK1) divider, PCLK1 must not exceed 42 MHz.
+                                    This parameter can be a value of @ref RCC_APB_Prescaler*/
+    uint8_t APB2Prescaler;      /*  Specifies the APB2 clock (PCLK2) divider, PCLK2 must not exceed 84 MHz.
+                                    This parameter can be a value of @ref RCC_APB_Prescaler*/
+} RCC_ClkConf_t;
+
+/*Clock frequencies of the current clock tree, in Hz*/
+typedef struct
+{
+    uint32_t SysClk;            /*System clock*/
+    uint32_t HCLK;              /*AHB clock, core and DMA clock*/
+    uint32_t PCLK1;             /*APB1 peripheral clock*/
+    uint32_t PCLK2;             /*APB2 peripheral clock*/
+    uint32_t TimClk1;           /*Clock of the timers on APB1 (TIM2..TIM7, TIM12..TIM14)*/
+    uint32_t TimClk2;           /*Clock of the timers on APB2 (TIM1, TIM8..TIM11)*/
+} RCC_ClockState_t;
+
+/*Clock change callback, called with the new clock frequencies after each clock tree change*/
+typedef void (*RCC_ClockChangeCallback_t)(const RCC_ClockState_t * pClocks);
+
+/*Maximum number of clock change callbacks*/
+#define RCC_CLOCK_CALLBACK_MAX      8U
+
+/*RCC_SysClk_Source*/
+#define RCC_SYSCLK_HSI              0U      /*HSI oscillator used as the system clock*/
+#define RCC_SYSCLK_HSE              1U      /*HSE oscillator used as the system clock*/
+#define RCC_SYSCLK_PLL              2U      /*PLL used as the system clock*/
+
+/*RCC_PLL_Source*/
+#define RCC_PLLSOURCE_HSI           0U      /*HSI clock selected as PLL entry clock source*/
+#define RCC_PLLSOURCE_HSE           1U      /*HSE clock selected as PLL entry clock source*/
+
+/*RCC_AHB_Prescaler, values of the CFGR HPRE bit field*/
+#define RCC_AHB_DIV1                0U
+#define RCC_AHB_DIV2                8U
+#define RCC_AHB_DIV4                9U
+#define RCC_AHB_DIV8                10U
+#define RCC_AHB_DIV16               11U
+#define RCC_AHB_DIV64               12U
+#define RCC_AHB_DIV128              13U
+#define RCC_AHB_DIV256              14U
+#define RCC_AHB_DIV512              15U
+
+/*RCC_APB_Prescaler, values of the CFGR PPRE1/PPRE2 bit fields*/
+#define RCC_APB_DIV1                0U
+#define RCC_APB_DIV2                4U
+#define RCC_APB_DIV4                5U
+#define RCC_APB_DIV8                6U
+#define RCC_APB_DIV16               7U
+
+/* RCC register bits ---------------------------------------------------------------*/
+/* RCC_CR */
+#define RCC_CR_HSION                0U      /*Internal high-speed clock enable*/
+#define RCC_CR_HSIRDY               1U      /*Internal high-speed clock ready flag*/
+#define RCC_CR_HSEON                16U     /*HSE clock enable*/
+#define RCC_CR_HSERDY               17U     /*HSE clock ready flag*/
+#define RCC_CR_PLLON                24U     /*Main PLL enable*/
+#define RCC_CR_PLLRDY               25U     /*Main PLL clock ready flag*/
+
+/* RCC_PLLCFGR */
+#define RCC_PLLCFGR_PLLM            0U      /*PLLM[5:0]*/
+#define RCC_PLLCFGR_PLLN            6U      /*PLLN[14:6]*/
+#define RCC_PLLCFGR_PLLP            16U     /*PLLP[17:16]*/
+#define RCC_PLLCFGR_PLLSRC          22U     /*PLLSRC*/
+#define RCC_PLLCFGR_PLLQ            24U     /*PLLQ[27:24]*/
+
+/* RCC_CFGR */
+#define RCC_CFGR_SW                 0U      /*SW[1:0]: System clock switch*/
+#define RCC_CFGR_SWS                2U      /*SWS[1:0]: System clock switch status*/
+#define RCC_CFGR_HPRE               4U      /*HPRE[3:0]: AHB prescaler*/
+#define RCC_CFGR_PPRE1              10U     /*PPRE1[2:0]: APB1 prescaler*/
+#define RCC_CFGR_PPRE2              13U     /*PPRE2[2:0]: APB2 prescaler*/
+
+/* RCC_AHB1ENR, the GPIOx clock enable bit is the port index (GPIOA = 0 .. GPIOI = 8) */
+#define RCC_AHB1ENR_GPIOAEN         0U      /*IO port A clock enable*/
+#define RCC_AHB1ENR_DMA1EN          21U     /*DMA1 clock enable*/
+#define RCC_AHB1ENR_DMA2EN          22U     /*DMA2 clock enable*/
+
+/* RCC_APB1ENR */
+#define RCC_APB1ENR_TIM2EN          0U      /*TIM2 clock enable, TIMx (x = 2..7) is bit x - 2*/
+#define RCC_APB1ENR_TIM3EN          1U      /*TIM3 clock enable*/
+#define RCC_APB1ENR_TIM4EN          2U      /*TIM4 clock enable*/
+#define RCC_APB1ENR_TIM5EN          3U      /*TIM5 clock enable*/
+#define RCC_APB1ENR_TIM6EN          4U      /*TIM6 clock enable*/
+#define RCC_APB1ENR_TIM7EN          5U      /*TIM7 clock enable*/
+#define RCC_APB1ENR_SPI2EN          14U     /*SPI2 clock enable*/
+#define RCC_APB1ENR_SPI3EN          15U     /*SPI3 clock enable*/
+#define RCC_APB1ENR_USART2EN        17U     /*USART2 clock enable*/
+#define RCC_APB1ENR_USART3EN        18U     /*USART3 clock enable*/
+#define RCC_APB1ENR_UART4EN         19U     /*UART4 clock enable*/
+#define RCC_APB1ENR_UART5EN         20U     /*UART5 clock enable*/
+#define RCC_APB1ENR_I2C1EN          21U     /*I2C1 clock enable*/
+#define RCC_APB1ENR_I2C2EN          22U     /*I2C2 clock enable*/
+#define RCC_APB1ENR_I2C3EN          23U     /*I2C3 clock enable*/
+#define RCC_APB1ENR_PWREN           28U     /*Power interface clock enable*/
+
+/* RCC_APB2ENR */
+#define RCC_APB2ENR_USART1EN        4U      /*USART1 clock enable*/
+#define RCC_APB2ENR_USART6EN        5U      /*USART6 clock enable*/
+#define RCC_APB2ENR_SPI1EN          12U     /*SPI1 clock enable*/
+#define RCC_APB2ENR_SYSCFGEN        14U     /*System configuration controller clock enable*/
+
+/* FLASH_ACR */
+#define FLASH_ACR_LATENCY           0U      /*LATENCY[2:0]: Wait states*/
+#define FLASH_ACR_PRFTEN            8U      /*Prefetch enable*/
+#define FLASH_ACR_ICEN              9U      /*Instruction cache enable*/
+#define FLASH_ACR_DCEN              10U     /*Data cache enable*/
+#define FLASH_ACR_ICRST             11U     /*Instruction cache reset*/
+#define FLASH_ACR_DCRST             12U     /*Data cache reset*/
+
+/* PWR_CR */
+#define PWR_CR_LPDS                 0U      /*Low-power regulator in STOP mode*/
+#define PWR_CR_PDDS                 1U      /*Power down deepsleep: STANDBY instead of STOP*/
+#define PWR_CR_CWUF                 2U      /*Clear the wakeup flag*/
+#define PWR_CR_FPDS                 9U      /*Flash power down in STOP mode*/
+#define PWR_CR_VOS                  14U     /*Regulator voltage scaling output selection*/
+
+/*Maximum HCLK for each flash wait state (2.7 V - 3.6 V supply)*/
+#define RCC_FLASH_WS_STEP           30000000U
+
+/*Number of polling loops before an oscillator or the PLL is considered failed*/
+#define RCC_STARTUP_TIMEOUT         0x50000U
+
+/*Macro to check if TIMx is clocked by APB2*/
+#define TIMx_ON_APB2(TIMx)          (((uint32_t)(TIMx)) >= APB2_BASEADDR)
+
+uint8_t RCC_SysClkConfig(RCC_ClkConf_t RCC_ClkConf);
+uint32_t RCC_GetSysClkVal(void);
+uint32_t RCC_GetPLLOutputClock(void);
+uint32_t RCC_GetHCLKVal(void);
+uint32_t RCC_GetPCLK1Val(void);
+uint32_t RCC_GetPCLK2Val(void);
+uint32_t RCC_GetTIMxClkVal(TIM_RegDef_t * TIMx);
+void RCC_UpdateClockState(void);
+const RCC_ClockState_t * RCC_GetClockState(void);
+uint8_t RCC_RegisterClockChangeCallback(RCC_ClockChangeCallback_t Callback);
+#endif
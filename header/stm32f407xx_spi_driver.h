@@ -0,0 +1,158 @@
+#ifndef STM32F407XX_SPI_DRIVER_H
+#define STM32F407XX_SPI_DRIVER_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_rcc_driver.h"
+
+/*  Interrupt and DMA driven SPI master, full duplex.
+    Each device on the bus has its settings (clock polarity and phase, baud prescaler, frame size, bit order)
+    and its chip select pin, driven by the driver (software NSS). A transfer sends and receives Length frames
+    with one device, the settings are applied when it starts.
+    The transfers are queued per bus (intrusive list, the memory belongs to the caller) and run one after the
+    other from the interrupts, e.g, a display flush and the accelerometer reads share SPI1 without waiting for
+    each other. Done is called from the interrupt when a transfer ends, it can submit the next transfer.
+    With UseDMA, the transfers of at least SPI_DMA_MIN frames are moved by DMA (see SPI_DMA_STREAMS), the
+    reception stream always runs so the data register never overruns, the shorter transfers use the RXNE
+    interrupt (one frame in flight).
+    Speed: SPI1 runs from PCLK2 (84 MHz, 10.5 MHz with SPI_BAUD_DIV8), SPI2 and SPI3 from PCLK1 (42 MHz),
+    a full SSD1306 frame (1 KB) takes about 0.8 ms at 10.5 MHz. On the Discovery board the LIS3DSH
+    accelerometer is on SPI1 (PA5 SCK, PA6 MISO, PA7 MOSI, AF5), chip select PE3, mode 3, 10 MHz at most. */
+
+/*Device on an SPI bus*/
+typedef struct
+{
+    uint8_t BaudPrescaler;              /*@ref SPI_Baud, see SPI_GetBaudPrescaler*/
+    uint8_t CPOL;                       /*@ref SPI_CPOL*/
+    uint8_t CPHA;                       /*@ref SPI_CPHA*/
+    uint8_t FrameFormat;                /*@ref SPI_Frame_Format*/
+    uint8_t LsbFirst;                   /*TRUE: least significant bit first*/
+    GPIO_RegDef_t * pCsPort;            /*Chip select (active low), NULL: not driven by the driver*/
+    uint8_t CsPin;
+} SPI_Device_t;
+
+/*SPI configuration structure*/
+typedef struct
+{
+    uint8_t UseDMA;                     /*TRUE: the long transfers are moved by DMA*/
+} SPI_Conf_t;
+
+struct SPI_Transfer_s;
+/*Transfer callback, called from the interrupt (Done) or from the context starting the transfer (Begin)*/
+typedef void (*SPI_Callback_t)(struct SPI_Transfer_s * pXfer);
+
+/*SPI transfer, it must stay valid and unchanged until Done is called*/
+typedef struct SPI_Transfer_s
+{
+    const SPI_Device_t * pDevice;
+    const void * pTxData;               /*Frames sent (uint8_t or uint16_t), NULL: SPI_DUMMY_FRAME is sent*/
+    void * pRxData;                     /*Frames received, NULL: dropped*/
+    uint16_t Length;                    /*Number of frames*/
+    SPI_Callback_t Begin;               /*Called before the chip select is driven low (e.g, to set a D/C pin), NULL: not used*/
+    SPI_Callback_t Done;                /*Called when the transfer ends and the chip select is high, NULL: not used*/
+    void * Context;                     /*Application data, not used by the driver*/
+    volatile uint8_t Status;            /*@ref SPI_Status*/
+    struct SPI_Transfer_s * pNext;      /*Queue link, used by the driver*/
+} SPI_Transfer_t;
+
+/*SPI statistics, the throughput is Frames / ActiveTime*/
+typedef struct
+{
+    uint32_t Transfers;                 /*Number of completed transfers (with or without error)*/
+    uint32_t Frames;                    /*Frames exchanged*/
+    uint32_t DMATransfers;              /*Transfers moved by DMA*/
+    uint32_t ActiveTime;                /*Time the bus was used by the transfers, in us*/
+    uint32_t Errors;                    /*Overruns and DMA transfer errors*/
+    uint16_t HighWater;                 /*Maximum number of queued transfers*/
+} SPI_Stats_t;
+
+/*SPI_Baud: SCK = PCLK / 2^(n + 1)*/
+#define SPI_BAUD_DIV2               0U
+#define SPI_BAUD_DIV4               1U
+#define SPI_BAUD_DIV8               2U
+#define SPI_BAUD_DIV16              3U
+#define SPI_BAUD_DIV32              4U
+#define SPI_BAUD_DIV64              5U
+#define SPI_BAUD_DIV128             6U
+#define SPI_BAUD_DIV256             7U
+
+/*SPI_CPOL: clock level when idle*/
+#define SPI_CPOL_LOW                0U
+#define SPI_CPOL_HIGH               1U
+
+/*SPI_CPHA: data captured on the first or the second clock edge*/
+#define SPI_CPHA_FIRST              0U
+#define SPI_CPHA_SECOND             1U
+
+/*SPI_Frame_Format*/
+#define SPI_FRAME_8BIT              0U
+#define SPI_FRAME_16BIT             1U
+
+/*SPI_Status*/
+#define SPI_STATUS_OK               0U      /*Transfer done*/
+#define SPI_STATUS_PENDING          1U      /*Queued or running*/
+#define SPI_STATUS_ERROR            2U      /*Overrun or DMA transfer error*/
+
+/*Transfers of at least this number of frames are moved by DMA*/
+#define SPI_DMA_MIN                 8U
+/*Frame sent when a transfer has no transmit data*/
+#define SPI_DUMMY_FRAME             0xFFFFU
+
+/*SPI_CR1 register bits*/
+#define SPI_CR1_CPHA                0U      /*Clock phase*/
+#define SPI_CR1_CPOL                1U      /*Clock polarity*/
+#define SPI_CR1_MSTR                2U      /*Master selection*/
+#define SPI_CR1_BR                  3U      /*Baud rate control [5:3]*/
+#define SPI_CR1_SPE                 6U      /*SPI enable*/
+#define SPI_CR1_LSBFIRST            7U      /*Frame format*/
+#define SPI_CR1_SSI                 8U      /*Internal slave select*/
+#define SPI_CR1_SSM                 9U      /*Software slave management*/
+#define SPI_CR1_DFF                 11U     /*Data frame format*/
+
+/*SPI_CR2 register bits*/
+#define SPI_CR2_RXDMAEN             0U      /*Rx buffer DMA enable*/
+#define SPI_CR2_TXDMAEN             1U      /*Tx buffer DMA enable*/
+#define SPI_CR2_ERRIE               5U      /*Error interrupt enable*/
+#define SPI_CR2_RXNEIE              6U      /*RX buffer not empty interrupt enable*/
+#define SPI_CR2_TXEIE               7U      /*Tx buffer empty interrupt enable*/
+
+/*SPI_SR register bits*/
+#define SPI_SR_RXNE                 0U      /*Receive buffer not empty*/
+#define SPI_SR_TXE                  1U      /*Transmit buffer empty*/
+#define SPI_SR_MODF                 5U      /*Mode fault*/
+#define SPI_SR_OVR                  6U      /*Overrun flag*/
+#define SPI_SR_BSY                  7U      /*Busy flag*/
+
+/*  DMA streams of each SPI (RM0090 DMA request mapping): controller, TX stream, TX channel, RX stream, RX channel.
+    SPI2 TX shares DMA1 stream 4 with I2C3 TX, SPI3 RX shares DMA1 stream 0 with I2C1 RX: only one of them can
+    use DMA. */
+#define SPI_DMA_STREAMS \
+        {{DMA2, DMA_STREAM_3, DMA_CHANNEL_3, DMA_STREAM_0, DMA_CHANNEL_3}, \
+         {DMA1, DMA_STREAM_4, DMA_CHANNEL_0, DMA_STREAM_3, DMA_CHANNEL_0}, \
+         {DMA1, DMA_STREAM_5, DMA_CHANNEL_0, DMA_STREAM_0, DMA_CHANNEL_0}}
+
+/*Number of SPI peripherals handled by the driver*/
+#define SPI_INSTANCE_NUM            3U
+
+/*Macro to map SPIx to its index in the driver state tables, SPI_INSTANCE_NUM if the SPI is not handled.
+  SPI_Init, SPI_IT_Init and SPI_Submit reject such an SPI, the other functions must only be called for an
+  initialized one*/
+#define SPIx_TO_INDEX(SPIx) \
+        ((SPIx == SPI1) ? 0U : \
+         (SPIx == SPI2) ? 1U : \
+         (SPIx == SPI3) ? 2U : SPI_INSTANCE_NUM)
+
+/*Macro to map SPIx to its IRQ number. Only used for a handled SPI*/
+#define SPIx_TO_IRQ(SPIx) \
+        ((SPIx == SPI1) ? IRQ_NO_SPI1 : \
+         (SPIx == SPI2) ? IRQ_NO_SPI2 : \
+         (SPIx == SPI3) ? IRQ_NO_SPI3 : IRQ_NO_SPI1)
+
+uint8_t SPI_Init(SPI_RegDef_t * SPIx, SPI_Conf_t SPI_Conf);
+uint8_t SPI_IT_Init(SPI_RegDef_t * SPIx, uint8_t Priority);
+uint8_t SPI_GetBaudPrescaler(SPI_RegDef_t * SPIx, uint32_t MaxSpeed);
+uint8_t SPI_Submit(SPI_RegDef_t * SPIx, SPI_Transfer_t * pXfer);
+uint8_t SPI_IsIdle(SPI_RegDef_t * SPIx);
+const SPI_Stats_t * SPI_GetStats(SPI_RegDef_t * SPIx);
+void SPI_IRQHandling(SPI_RegDef_t * SPIx);
+#endif
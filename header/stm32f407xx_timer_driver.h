@@ -1,6 +1,7 @@
 #ifndef STM32F407_TIMER_DRIVER_H
 #define STM32F407_TIMER_DRIVER_H
 #include "stm32f407xx.h"
+#include "stm32f407xx_rcc_driver.h"
 
 /*Timer base unit configuration structure*/
 typedef struct
@@ -10,10 +11,14 @@ typedef struct
                                     This parameter can be a number between Min_Data = 0x00000000 and Max_Data = 0xFFFFFFFF*/
     uint16_t Prescaler;         /*  Specifies the prescaler value of the timer base unit,
                                     This parameter can be a number between Minval = 0x0000 and Maxval = 0xFFFF*/
+    uint32_t CounterClock;      /*  Specifies the counter clock in Hz. When it is not 0, Prescaler is ignored,
+                                    the prescaler is computed from the timer clock and recomputed on each clock change*/
     uint8_t AutoReloadPreload;  /*  Specifies the auto reload Preload,
                                     This parameter can be a value of @ref TIM_AutoReloadPreload*/  
     uint8_t CounterMode;        /*  Specifies the timer counting mode,
                                     This parameter can be a value of @ref TIM_CounterMode */  
+    uint8_t ClockDivision;      /*  Specifies the ratio between the timer clock (CK_INT) and the sampling clock (tDTS)
+                                    of the input filters, this parameter can be a value of @ref TIM_ClockDivision*/
 } TIM_Base_Conf_t;
 
 /*Output compare configuration structure*/
@@ -27,12 +32,53 @@ typedef struct
                                     This parameter can be a value of @ref TIM_Output_Compare_Polarity*/
 } TIM_OC_Conf_t;
 
+/*Input capture configuration structure*/
+typedef struct
+{
+    uint8_t ICPolarity;         /*  Specifies the active edge of the input signal.
+                                    This parameter can be a value of @ref TIM_Input_Capture_Polarity*/
+    uint8_t ICSelection;        /*  Specifies the input connected to the channel.
+                                    This parameter can be a value of @ref TIM_Input_Capture_Selection*/
+    uint8_t ICPrescaler;        /*  Specifies the number of edges per capture.
+                                    This parameter can be a value of @ref TIM_Input_Capture_Prescaler*/
+    uint8_t ICFilter;           /*  Specifies the input filter (ICxF), the edge is taken after N consecutive equal samples.
+                                    This parameter can be a number between Min_Data = 0x0 and Max_Data = 0xF,
+                                    0xF is N = 8 at fDTS/32 (about 12 us with an 84 MHz timer clock and TIM_CLOCKDIVISION_DIV4)*/
+} TIM_IC_Conf_t;
+
 /*Output compare channel*/
 #define TIM_OC_CHANNEL_1    0U      /*Output compare channel 1*/
 #define TIM_OC_CHANNEL_2    1U      /*Output compare channel 2*/
 #define TIM_OC_CHANNEL_3    2U      /*Output compare channel 3*/
 #define TIM_OC_CHANNEL_4    3U      /*Output compare channel 4*/
 
+/*Input capture channel*/
+#define TIM_IC_CHANNEL_1    0U      /*Input capture channel 1*/
+#define TIM_IC_CHANNEL_2    1U      /*Input capture channel 2*/
+#define TIM_IC_CHANNEL_3    2U      /*Input capture channel 3*/
+#define TIM_IC_CHANNEL_4    3U      /*Input capture channel 4*/
+
+/* TIM_Input_Capture_Polarity */
+#define TIM_ICPOLARITY_RISING       0U      /*Capture on the rising edges (CCxNP = 0, CCxP = 0)*/
+#define TIM_ICPOLARITY_FALLING      1U      /*Capture on the falling edges (CCxNP = 0, CCxP = 1)*/
+#define TIM_ICPOLARITY_BOTHEDGE     5U      /*Capture on both edges (CCxNP = 1, CCxP = 1)*/
+
+/* TIM_Input_Capture_Selection, value of the CCxS bits */
+#define TIM_ICSELECTION_DIRECTTI    1U      /*Channel x is mapped on TIx (e.g, IC1 on TI1)*/
+#define TIM_ICSELECTION_INDIRECTTI  2U      /*Channel x is mapped on the other input of the pair (e.g, IC2 on TI1)*/
+#define TIM_ICSELECTION_TRC         3U      /*Channel x is mapped on TRC*/
+
+/* TIM_Input_Capture_Prescaler */
+#define TIM_ICPSC_DIV1              0U      /*Capture on each edge*/
+#define TIM_ICPSC_DIV2              1U      /*Capture once every 2 edges*/
+#define TIM_ICPSC_DIV4              2U      /*Capture once every 4 edges*/
+#define TIM_ICPSC_DIV8              3U      /*Capture once every 8 edges*/
+
+/* TIM_ClockDivision */
+#define TIM_CLOCKDIVISION_DIV1      0U      /*tDTS = tCK_INT*/
+#define TIM_CLOCKDIVISION_DIV2      1U      /*tDTS = 2 * tCK_INT*/
+#define TIM_CLOCKDIVISION_DIV4      2U      /*tDTS = 4 * tCK_INT*/
+
 /* TIM_CounterMode */
 #define TIM_UPCOUNTING              0U      /*TIMx upcouting mode selection */
 #define TIM_DOWNCOUTING             1U      /*TIMx downcouting mode selection */
@@ -65,8 +111,11 @@ typedef struct
 
 
 /*TIMx CR1 register bits*/
+#define TIM_CR1_CKD     8U      /*CKD[1:0]: Clock division*/
 #define TIM_CR1_ARPE    7U      /*ARPE: Auto-reload preload enable bit*/
 #define TIM_CR1_DIR     4U      /*DIR: Counter mode*/
+#define TIM_CR1_OPM     3U      /*OPM: One-pulse mode, the counter stops at the next update event*/
+#define TIM_CR1_URS     2U      /*URS: Update request source, only the counter overflow raises the update interrupt*/
 #define TIM_CR1_CEN     0U      /*CEN: Counter enable bit*/
 
 /*TIMx EGR register bits*/
@@ -74,9 +123,23 @@ typedef struct
 
 /*TIMx SR register bit*/
 #define TIM_SR_UIF      0U      /*UIF: Update interrupt flag bit*/
+#define TIM_SR_CC1IF    1U      /*CC1IF: Capture/compare 1 interrupt flag, CCxIF is bit CC1IF + Channel*/
+#define TIM_SR_CC1OF    9U      /*CC1OF: Capture 1 overcapture flag, CCxOF is bit CC1OF + Channel*/
 
 /*TIMx DIER register bit*/
 #define TIM_DIER_UIE      0U    /*UIE: Enable Update interrupt bit*/
+#define TIM_DIER_CC1IE    1U    /*CC1IE: Capture/compare 1 interrupt enable, CCxIE is bit CC1IE + Channel*/
+#define TIM_DIER_CC1DE    9U    /*CC1DE: Capture/compare 1 DMA request enable, CCxDE is bit CC1DE + Channel*/
+
+/*TIMx CCMR register bits, for the odd channels add 8*/
+#define TIM_CCMR_CCS      0U    /*CCxS[1:0]: Capture/compare selection*/
+#define TIM_CCMR_ICPSC    2U    /*ICxPSC[1:0]: Input capture prescaler*/
+#define TIM_CCMR_ICF      4U    /*ICxF[3:0]: Input capture filter*/
+
+/*TIMx CCER register bits, for channel x add 4 * Channel*/
+#define TIM_CCER_CCE      0U    /*CCxE: Capture/compare enable*/
+#define TIM_CCER_CCP      1U    /*CCxP: Capture/compare polarity*/
+#define TIM_CCER_CCNP     3U    /*CCxNP: Capture/compare complementary polarity*/
 
 /*Macros handle update event status*/
 #define TIM6_UEV_STS()          ((TIM6->SR >> TIM_SR_UIF) & 0x01U)      /*Timer 6 - update event status*/
@@ -84,16 +147,37 @@ typedef struct
 
 /* Macro to map IRQn to TIMx */
 #define TIMx_TO_IRQ(TIMx) \
-        ((TIMx == TIM6) ? IRQ_NO_TIM6_DAC : \
+        ((TIMx == TIM2) ? IRQ_NO_TIM2 : \
+        (TIMx == TIM3) ? IRQ_NO_TIM3 : \
+        (TIMx == TIM4) ? IRQ_NO_TIM4 : \
+        (TIMx == TIM5) ? IRQ_NO_TIM5 : \
+        (TIMx == TIM6) ? IRQ_NO_TIM6_DAC : \
         (TIMx == TIM7) ? IRQ_NO_TIM7 : IRQ_NO_TIM6_DAC)
 
+/* Number of timers handled by the driver state tables */
+#define TIM_INSTANCE_NUM    6U
+
+/* Macro to map TIMx to its index in the driver state tables, TIM_INSTANCE_NUM if the timer is not handled */
+#define TIMx_TO_INDEX(TIMx) \
+        ((TIMx == TIM2) ? 0U : \
+         (TIMx == TIM3) ? 1U : \
+         (TIMx == TIM4) ? 2U : \
+         (TIMx == TIM5) ? 3U : \
+         (TIMx == TIM6) ? 4U : \
+         (TIMx == TIM7) ? 5U : TIM_INSTANCE_NUM)
+
 /*Macros handle output compare*/
 #define TIM4_OC_PWM_SET_DUTY(Channel, CCR_value)    (TIM4->CCR[(Channel)] = (CCR_value))
 
-void TIM_Base_Init(TIM_RegDef_t * TIMx, TIM_Base_Conf_t TIM_BaseConf);
+uint8_t TIM_Base_Init(TIM_RegDef_t * TIMx, TIM_Base_Conf_t TIM_BaseConf);
 void TIM_Base_Start(TIM_RegDef_t * TIMx);
 void TIM_Base_Stop(TIM_RegDef_t * TIMx);
 void TIM_Base_ForceUpdate(TIM_RegDef_t * TIMx);
 void TIM_Base_IT_Init(TIM_RegDef_t * TIMx, uint8_t Priority);
 void TIM_OC_Init(TIM_RegDef_t * TIMx, TIM_OC_Conf_t TIM_OCConf, uint8_t Channel);
+uint16_t TIM_CalcPrescaler(TIM_RegDef_t * TIMx, uint32_t CounterClock);
+void TIM_IC_Init(TIM_RegDef_t * TIMx, TIM_IC_Conf_t TIM_ICConf, uint8_t Channel);
+void TIM_IC_IT_Init(TIM_RegDef_t * TIMx, uint8_t Channel, uint8_t Priority);
+void TIM_IC_DMA_Enable(TIM_RegDef_t * TIMx, uint8_t Channel);
+uint8_t TIM_IC_GetCapture(TIM_RegDef_t * TIMx, uint8_t Channel, uint32_t * pCapture);
 #endif
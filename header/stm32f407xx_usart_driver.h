@@ -5,6 +5,9 @@
 #ifndef STM32F407XX_USART_DRIVER_H
 #define STM32F407XX_USART_DRIVER_H
 #include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
+#include "stm32f407xx_rcc_driver.h"
+#include "ring_buffer.h"
 
 /*USART configuration struct*/
 typedef struct 
@@ -32,6 +35,35 @@ typedef struct
                             This parameter can be a value of @ref USART_Over_Sampling*/
 }USART_Conf_t;
 
+/*USART transmission complete callback type*/
+typedef void (*USART_TxCpltCallback_t)(USART_RegDef_t * USARTx);
+
+/*USART transmit ring buffer size, this must be a power of two*/
+#define USART_TX_BUFFER_SIZE     64U
+
+/*USART interrupt driven transmit state*/
+typedef struct
+{
+    uint8_t Buffer[USART_TX_BUFFER_SIZE];   /*Transmit ring buffer storage*/
+    RingBuf_t Ring;                         /*Producer is USART_Transmit_IT, consumer is USART_IRQHandling*/
+    USART_TxCpltCallback_t TxCpltCallback;  /*Called when all queued bytes have been transmitted*/
+    uint8_t IRQPriority;                    /*USART interrupt priority, masked while a message is queued*/
+} USART_TxState_t;
+
+/*USART DMA reception callback type, Data points into the circular buffer and is valid until the callback returns*/
+typedef void (*USART_RxEventCallback_t)(USART_RegDef_t * USARTx, const uint8_t * Data, uint16_t Length);
+
+/*USART DMA circular reception state*/
+typedef struct
+{
+    DMA_RegDef_t * DMAx;                    /*DMA controller serving the USART RX request*/
+    uint8_t Stream;                         /*DMA stream serving the USART RX request*/
+    uint8_t * Buffer;                       /*Circular buffer filled by the DMA*/
+    uint16_t Size;                          /*Size of the circular buffer*/
+    uint16_t ReadPos;                       /*Position of the first byte not handed to the application yet*/
+    USART_RxEventCallback_t RxEventCallback;/*Called with each newly received span of bytes*/
+} USART_RxDMAState_t;
+
 /*USART_Mode*/
 #define USART_MODE_RX            1U      /*Only CR1_RE bit is enabled, receive mode only*/
 #define USART_MODE_TX            2U      /*Only CR1_TE bit is enabled, transmit mode only*/
@@ -68,8 +100,11 @@ typedef struct
 /* USART register bits ---------------------------------------------------------------*/
 /* USART_CR1 */
 #define USART_CR1_RE            2U      /* RE bit */
+#define USART_CR1_IDLEIE        4U      /* IDLEIE bit */
 #define USART_CR1_TE            3U      /* TE bit */
 #define USART_CR1_RXNEIE        5U      /* RXNEIE bit */
+#define USART_CR1_TCIE          6U      /* TCIE bit */
+#define USART_CR1_TXEIE         7U      /* TXEIE bit */
 #define USART_CR1_PS            9U      /* PS bit */
 #define USART_CR1_PCE           10U     /* PCE bit*/
 #define USART_CR1_M             12U     /* M bit */
@@ -79,22 +114,59 @@ typedef struct
 /* USART_CR2*/
 #define USART_CR2_STOP          12U     /* STOP bit */
 
+/* USART_CR3 */
+#define USART_CR3_DMAR          6U      /* DMAR bit: DMA enable receiver */
+#define USART_CR3_DMAT          7U      /* DMAT bit: DMA enable transmitter */
+
 /* USART_BRR */
 #define USART_DIV_MANTISSA      4U      /* Div_Mantissa */
 #define USART_DIV_FRACTION      0U      /* Div_Fraction */
 
 /* USART SR */
 #define USART_SR_TXE            7U      /* TXE bit */
+#define USART_SR_TC             6U      /* TC bit: Transmission complete */
 #define USART_SR_RXNE           5U      /* RXNE bit: Read data register not empty */
+#define USART_SR_IDLE           4U      /* IDLE bit: IDLE line detected */
 
 /*Interrupt configuration*/
 #define USART3_RXNEIE_ENB()     (USART3->CR1 |= (1U << USART_CR1_RXNEIE))      /*Enable receive not empty interrupt*/
 #define USART3_RXNEIE_DIS()     (USART3->CR1 &= ~(1U << USART_CR1_RXNEIE))     /*Disable receive not empty interrupt*/
 
+/* Macro to map USARTx to its IRQ number */
+#define USARTx_TO_IRQ(USARTx) \
+        ((USARTx == USART1) ? IRQ_NO_USART1 : \
+         (USARTx == USART2) ? IRQ_NO_USART2 : \
+         (USARTx == USART3) ? IRQ_NO_USART3 : \
+         (USARTx == UART4)  ? IRQ_NO_UART4  : \
+         (USARTx == UART5)  ? IRQ_NO_UART5  : \
+         (USARTx == USART6) ? IRQ_NO_USART6 : IRQ_NO_USART3)
+
+/* Number of USART/UART peripherals handled by the driver */
+#define USART_INSTANCE_NUM      6U
+
+/* Macro to map USARTx to its index in the driver state tables, USART_INSTANCE_NUM if the USART is not handled.
+   The init functions reject such a USART, the other functions must only be called for an initialized one. */
+#define USARTx_TO_INDEX(USARTx) \
+        ((USARTx == USART1) ? 0U : \
+         (USARTx == USART2) ? 1U : \
+         (USARTx == USART3) ? 2U : \
+         (USARTx == UART4)  ? 3U : \
+         (USARTx == UART5)  ? 4U : \
+         (USARTx == USART6) ? 5U : USART_INSTANCE_NUM)
 
 /* Function ptorotypes */
-void USART_Init(USART_RegDef_t * USARTx, USART_Conf_t USART_Conf);
+uint8_t USART_Init(USART_RegDef_t * USARTx, USART_Conf_t USART_Conf);
+void USART_SetBaudRate(USART_RegDef_t * USARTx, uint32_t BaudRate);
 void USART_Transmit(USART_RegDef_t * USARTx, uint8_t * Mess, uint8_t MessSize);
 void USART_Receive(USART_RegDef_t * USARTx, uint8_t * Mess, uint8_t MessSize);
+void USART_IT_Init(USART_RegDef_t * USARTx, uint8_t Priority);
+uint16_t USART_Transmit_IT(USART_RegDef_t * USARTx, const uint8_t * Mess, uint16_t MessSize);
+uint16_t USART_GetTxPending(USART_RegDef_t * USARTx);
+uint8_t USART_IsTxIdle(USART_RegDef_t * USARTx);
+void USART_RegisterTxCpltCallback(USART_RegDef_t * USARTx, USART_TxCpltCallback_t Callback);
+void USART_RxDMA_Start(USART_RegDef_t * USARTx, DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Channel,
+                       uint8_t * Buffer, uint16_t Size, USART_RxEventCallback_t Callback, uint8_t Priority);
+void USART_RxDMA_Stop(USART_RegDef_t * USARTx);
+void USART_IRQHandling(USART_RegDef_t * USARTx);
 
 #endif
@@ -0,0 +1,29 @@
+#ifndef SYSTICK_H
+#define SYSTICK_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_rcc_driver.h"
+
+/*  SysTick periodic tick.
+    - The rate is set in Hz, the reload value is derived from the live HCLK and follows the clock changes
+      (RCC_SysClkConfig). HCLK / 8 is used when the reload does not fit in 24 bits.
+    - The tick count is a monotonic 64 bit counter, read without masking the interrupts and without tearing.
+    - Hooks registered with SysTick_RegisterHook run from the SysTick interrupt on each tick, in registration order.
+    SysTick stops in STOP mode, the tick count does not include the time spent in it.
+    SysTick_Handler must call SysTick_IRQHandling. */
+
+/*Maximum number of tick hooks*/
+#define SYSTICK_HOOK_MAX            4U
+
+/*Tick hook type, called from the SysTick interrupt*/
+typedef void (*SysTick_Hook_t)(void);
+
+uint8_t SysTick_Init(uint32_t RateHz, uint8_t Priority);
+void SysTick_Stop(void);
+uint32_t SysTick_GetRate(void);
+uint64_t SysTick_GetTick64(void);
+uint32_t SysTick_GetTick(void);
+uint64_t SysTick_GetMs(void);
+uint8_t SysTick_RegisterHook(SysTick_Hook_t Hook);
+uint8_t SysTick_UnregisterHook(SysTick_Hook_t Hook);
+void SysTick_IRQHandling(void);
+#endif
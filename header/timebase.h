@@ -0,0 +1,30 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+#include "stm32f407xx.h"
+#include "stm32f407xx_timer_driver.h"
+
+/*  Time keeping.
+    - Microseconds: TIM2 is a free running 32 bit counter at 1 MHz, it wraps around every 71.6 minutes.
+      Its prescaler follows the clock changes (RCC_SysClkConfig), the time keeps running across them.
+    - Cycles: DWT_CYCCNT counts the core clock cycles, it wraps around every 25.5 s at 168 MHz.
+    The elapsed time helpers use unsigned subtraction, they are correct across one wrap around.
+    TIM2_IRQHandler must call Timebase_IRQHandling, the TIM2 channel 1 compare wakes Timebase_DelayUs/Ms up. */
+
+/*Timer used for the microsecond time base*/
+#define TIMEBASE_TIM                TIM2
+/*Counter clock of the microsecond time base*/
+#define TIMEBASE_COUNTER_CLOCK      1000000U
+/*Delays shorter than this (us) are busy waits, longer ones sleep until the TIM2 compare*/
+#define TIMEBASE_SLEEP_MIN_US       20U
+
+void Timebase_Init(uint8_t Priority);
+uint32_t Timebase_NowUs(void);
+uint32_t Timebase_NowCycles(void);
+uint32_t Timebase_ElapsedUs(uint32_t StartUs);
+uint32_t Timebase_ElapsedCycles(uint32_t StartCycles);
+uint8_t Timebase_IsExpired(uint32_t StartUs, uint32_t TimeoutUs);
+uint32_t Timebase_CyclesToUs(uint32_t Cycles);
+void Timebase_DelayUs(uint32_t Us);
+void Timebase_DelayMs(uint32_t Ms);
+void Timebase_IRQHandling(void);
+#endif
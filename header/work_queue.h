@@ -0,0 +1,49 @@
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+#include "stm32f407xx.h"
+#include "timebase.h"
+#include "mpsc_queue.h"
+
+/*  Deferred work (bottom halves) run from PendSV.
+    The interrupt handlers post a work item (handler + context) with WorkQueue_Post and return, PendSV runs at the
+    lowest priority once no interrupt is active and calls the handlers in the posting order.
+    - The queue is a lock-free multi producer queue (mpsc_queue.h), posting never masks the interrupts and works
+      at any priority. A producer preempted while posting only delays the items posted after it, PendSV is pended
+      again when it publishes.
+    - The handlers run in handler mode with every other interrupt able to preempt them, they can post work.
+    PendSV_Handler must call WorkQueue_IRQHandling. */
+
+/*Number of cells, this must be a power of two*/
+#define WORKQUEUE_SIZE              32U
+
+/*PendSV priority: the lowest one*/
+#define WORKQUEUE_PRIORITY          0x0FU
+
+/*Work handler type*/
+typedef void (*WorkQueue_Handler_t)(void * Context);
+
+/*Work item*/
+typedef struct
+{
+    WorkQueue_Handler_t Handler;        /*Handler of the work item*/
+    void * Context;                     /*Given to the handler*/
+    uint32_t PostStamp;                 /*Timebase_NowCycles value when the item was posted*/
+} WorkQueue_Item_t;
+
+/*Work queue statistics*/
+typedef struct
+{
+    uint32_t Posted;                    /*Number of posted items*/
+    uint32_t Executed;                  /*Number of items run*/
+    uint32_t Dropped;                   /*Number of items not posted, the queue was full*/
+    uint32_t HighWater;                 /*Maximum number of items waiting, seen when posting*/
+    uint32_t LastLatency;               /*Cycles from the post to the start of the handler, last item*/
+    uint32_t MaxLatency;                /*Worst case of LastLatency*/
+} WorkQueue_Stats_t;
+
+void WorkQueue_Init(void);
+uint8_t WorkQueue_Post(WorkQueue_Handler_t Handler, void * Context);
+uint32_t WorkQueue_GetDepth(void);
+const WorkQueue_Stats_t * WorkQueue_GetStats(void);
+void WorkQueue_IRQHandling(void);
+#endif
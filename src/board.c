@@ -0,0 +1,198 @@
+#include "board.h"
+
+/*Merged configuration of a GPIO port, Mask is the set of the bits written in each register*/
+typedef struct
+{
+    uint32_t Mask2;                     /*2 bit fields: MODER, PUPDR*/
+    uint32_t Moder;
+    uint32_t Pupd;
+    uint32_t OutMask;                   /*Output and alternate function pins: OTYPER (1 bit), OSPEEDR (2 bits)*/
+    uint32_t OutMask2;
+    uint32_t OutType;
+    uint32_t Speed;
+    uint32_t AfrMask[2];                /*AFRL, AFRH*/
+    uint32_t Afr[2];
+} Board_PortConf_t;
+
+static GPIO_RegDef_t * const Board_Gpio[BOARD_PORT_NUM] =
+{
+    GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH, GPIOI
+};
+static uint32_t Board_InitCycles = 0U;
+
+/**
+ * @brief This function merges the pin table into one configuration per port.
+ *
+ * @param pConf Board description
+ * @param pPorts Configuration of each port, cleared by the caller
+ * @param pEnable RCC enable bits of each bus, the port clocks are added
+ *
+ * @return uint8_t TRUE on success, FALSE if an entry is not valid
+ */
+static uint8_t Board_MergePins(const Board_Conf_t * pConf, Board_PortConf_t * pPorts, uint32_t * pEnable)
+{
+    const Board_PinDesc_t * pPin;
+    Board_PortConf_t * pPort;
+    uint8_t i, Shift2, ShiftAf;
+
+    for (i = 0U; i < pConf->PinNum; i++)
+    {
+        pPin = &pConf->pPins[i];
+        if ((pPin->Port >= BOARD_PORT_NUM) || (pPin->Pin > GPIO_PIN_NUM_15) || (pPin->Mode > GPIO_MODE_ANALOG)
+            || (pPin->OutType > GPIO_OUT_OD) || (pPin->PUPD > GPIO_PD) || (pPin->Speed > GPIO_SPEED_HIGH)
+            || (pPin->AltFunc > GPIO_ALT_AF15))
+        {
+            return FALSE;
+        }
+        pEnable[BOARD_BUS_AHB1] |= (0x01UL << (RCC_AHB1ENR_GPIOAEN + pPin->Port));
+        pPort = &pPorts[pPin->Port];
+        Shift2 = pPin->Pin * 2U;
+        pPort->Mask2 |= (0x03UL << Shift2);
+        pPort->Moder |= ((uint32_t)pPin->Mode << Shift2);
+        pPort->Pupd  |= ((uint32_t)pPin->PUPD << Shift2);
+        if ((pPin->Mode == GPIO_MODE_OUTPUT) || (pPin->Mode == GPIO_MODE_ALT))
+        {
+            pPort->OutMask  |= (0x01UL << pPin->Pin);
+            pPort->OutMask2 |= (0x03UL << Shift2);
+            pPort->OutType  |= ((uint32_t)pPin->OutType << pPin->Pin);
+            pPort->Speed    |= ((uint32_t)pPin->Speed << Shift2);
+        }
+        if (pPin->Mode == GPIO_MODE_ALT)
+        {
+            ShiftAf = (pPin->Pin % 8U) * 4U;
+            pPort->AfrMask[pPin->Pin / 8U] |= (0x0FUL << ShiftAf);
+            pPort->Afr[pPin->Pin / 8U]     |= ((uint32_t)pPin->AltFunc << ShiftAf);
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function applies the board tables: clocks, pins and EXTI interrupts.
+ *        Nothing is written if an entry is not valid.
+ *
+ * @param pConf Board description
+ *
+ * @return uint8_t TRUE on success, FALSE if an entry is not valid
+ */
+uint8_t Board_Init(const Board_Conf_t * pConf)
+{
+    Board_PortConf_t Ports[BOARD_PORT_NUM] = {0};
+    uint32_t Enable[BOARD_BUS_NUM] = {0U};
+    uint32_t ExtiMask[4] = {0U};
+    uint32_t ExtiCode[4] = {0U};
+    uint32_t Lines = 0U, Rising = 0U, Falling = 0U;
+    const Board_ExtiDesc_t * pExti;
+    GPIO_RegDef_t * GPIOx;
+    uint32_t Start;
+    uint8_t i;
+
+    Start = Timebase_NowCycles();
+    /*1. Merge the tables*/
+    for (i = 0U; i < pConf->ClockNum; i++)
+    {
+        if ((pConf->pClocks[i].Bus >= BOARD_BUS_NUM) || (pConf->pClocks[i].Bit > 31U))
+        {
+            return FALSE;
+        }
+        Enable[pConf->pClocks[i].Bus] |= (0x01UL << pConf->pClocks[i].Bit);
+    }
+    if (Board_MergePins(pConf, Ports, Enable) == FALSE)
+    {
+        return FALSE;
+    }
+    for (i = 0U; i < pConf->ExtiNum; i++)
+    {
+        pExti = &pConf->pExtis[i];
+        if ((pExti->Port >= BOARD_PORT_NUM) || (pExti->Pin > GPIO_PIN_NUM_15))
+        {
+            return FALSE;
+        }
+        Enable[BOARD_BUS_APB2] |= (0x01UL << RCC_APB2ENR_SYSCFGEN);
+        ExtiMask[pExti->Pin / 4U] |= (0x0FUL << ((pExti->Pin % 4U) * 4U));
+        ExtiCode[pExti->Pin / 4U] |= ((uint32_t)pExti->Port << ((pExti->Pin % 4U) * 4U));
+        Lines |= (0x01UL << pExti->Pin);
+        if (pExti->EdgeTrigger != GPIO_IT_EDGE_FT)
+        {
+            Rising |= (0x01UL << pExti->Pin);
+        }
+        if (pExti->EdgeTrigger != GPIO_IT_EDGE_RT)
+        {
+            Falling |= (0x01UL << pExti->Pin);
+        }
+    }
+
+    /*2. Clocks, one write per bus. The read back makes sure the clocks run before the peripherals are accessed*/
+    RCC->AHB1ENR |= Enable[BOARD_BUS_AHB1];
+    RCC->APB1ENR |= Enable[BOARD_BUS_APB1];
+    RCC->APB2ENR |= Enable[BOARD_BUS_APB2];
+    (void)RCC->APB2ENR;
+
+    /*3. Pins, one read-modify-write per register. The pin mode is written last, once the pin function is set*/
+    for (i = 0U; i < BOARD_PORT_NUM; i++)
+    {
+        if (Ports[i].Mask2 == 0U)
+        {
+            continue;
+        }
+        GPIOx = Board_Gpio[i];
+        if (Ports[i].AfrMask[0] != 0U)
+        {
+            GPIOx->AFRL = (GPIOx->AFRL & ~Ports[i].AfrMask[0]) | Ports[i].Afr[0];
+        }
+        if (Ports[i].AfrMask[1] != 0U)
+        {
+            GPIOx->AFRH = (GPIOx->AFRH & ~Ports[i].AfrMask[1]) | Ports[i].Afr[1];
+        }
+        if (Ports[i].OutMask != 0U)
+        {
+            GPIOx->OTYPER  = (GPIOx->OTYPER & ~Ports[i].OutMask) | Ports[i].OutType;
+            GPIOx->OSPEEDR = (GPIOx->OSPEEDR & ~Ports[i].OutMask2) | Ports[i].Speed;
+        }
+        GPIOx->PUPDR = (GPIOx->PUPDR & ~Ports[i].Mask2) | Ports[i].Pupd;
+        GPIOx->MODER = (GPIOx->MODER & ~Ports[i].Mask2) | Ports[i].Moder;
+    }
+
+    /*4. EXTI lines, one write per register, then their interrupts*/
+    if (Lines != 0U)
+    {
+        for (i = 0U; i < 4U; i++)
+        {
+            if (ExtiMask[i] != 0U)
+            {
+                SYSCFG->EXTICR[i] = (SYSCFG->EXTICR[i] & ~ExtiMask[i]) | ExtiCode[i];
+            }
+        }
+        EXTI->RTSR = (EXTI->RTSR & ~Lines) | Rising;
+        EXTI->FTSR = (EXTI->FTSR & ~Lines) | Falling;
+        EXTI->PR   = Lines;
+        EXTI->IMR |= Lines;
+        for (i = 0U; i < pConf->ExtiNum; i++)
+        {
+            NVIC_SetPriority(GPIO_PIN_TO_IRQ(pConf->pExtis[i].Pin), pConf->pExtis[i].Priority);
+            NVIC_EnableIRQ(GPIO_PIN_TO_IRQ(pConf->pExtis[i].Pin));
+        }
+    }
+    Board_InitCycles = Timebase_ElapsedCycles(Start);
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the duration of the last Board_Init in core cycles.
+ *
+ * @return uint32_t
+ */
+uint32_t Board_GetInitCycles(void)
+{
+    return Board_InitCycles;
+}
+
+/**
+ * @brief This function gets the duration of the last Board_Init in microseconds.
+ *
+ * @return uint32_t
+ */
+uint32_t Board_GetInitUs(void)
+{
+    return Timebase_CyclesToUs(Board_InitCycles);
+}
@@ -0,0 +1,173 @@
+#include "buttons.h"
+
+/*Debounce state of a port, one bit per pin in each mask*/
+typedef struct
+{
+    GPIO_RegDef_t * GPIOx;          /*Sampled port*/
+    uint16_t PinMask;               /*Pins used as buttons*/
+    uint16_t ActiveLowMask;         /*Buttons that read 0 when pressed*/
+    uint16_t State;                 /*Debounced state, 1 = pressed*/
+    uint16_t Cnt0;                  /*Vertical counter, bit 0 of each pin counter*/
+    uint16_t Cnt1;                  /*Vertical counter, bit 1 of each pin counter*/
+    uint16_t LongArmed;             /*Pressed buttons that did not report a long press yet*/
+    uint16_t DoubleArmed;           /*Released buttons whose next press may be a double press*/
+    uint32_t Stamp[16];             /*Tick of the last press or release of each pin*/
+} Buttons_Port_t;
+
+static Buttons_Port_t Buttons_Port[BUTTONS_PORT_MAX];
+static uint8_t Buttons_PortNum = 0U;
+static RingBuf_t * Buttons_Queue = NULL;
+/*Long and double press times in ticks*/
+static uint32_t Buttons_LongTicks;
+static uint32_t Buttons_DoubleTicks;
+/*Number of Buttons_Tick calls*/
+static uint32_t Buttons_Ticks = 0U;
+
+/**
+ * @brief This function initializes the sampling debouncer, the ports are then added with Buttons_AddPort.
+ *
+ * @param Buttons_Conf Structer that contains the timing configuration
+ * @param pEventQueue Initialized ring buffer receiving the event bytes
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+uint8_t Buttons_Init(Buttons_Conf_t Buttons_Conf, RingBuf_t * pEventQueue)
+{
+    if ((Buttons_Conf.TickPeriod == 0U) || (pEventQueue == NULL))
+    {
+        return FALSE;
+    }
+    Buttons_Queue       = pEventQueue;
+    Buttons_LongTicks   = Buttons_Conf.LongPressTime / Buttons_Conf.TickPeriod;
+    Buttons_DoubleTicks = Buttons_Conf.DoublePressTime / Buttons_Conf.TickPeriod;
+    Buttons_Ticks       = 0U;
+    Buttons_PortNum     = 0U;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function adds the buttons of a port. The pins must be configured as inputs by the application.
+ *        The current pin levels are taken as the initial debounced state, no event is reported for them.
+ *
+ * @param GPIOx Port of the buttons (e.g, GPIOA)
+ * @param PinMask Pins used as buttons, bit n for pin n
+ * @param ActiveLowMask Buttons that read 0 when pressed (e.g, with a pull-up), bit n for pin n
+ *
+ * @return uint8_t Port index used in the events, BUTTONS_PORT_INVALID if no port is left
+ */
+uint8_t Buttons_AddPort(GPIO_RegDef_t * GPIOx, uint16_t PinMask, uint16_t ActiveLowMask)
+{
+    Buttons_Port_t * pPort;
+
+    if (Buttons_PortNum >= BUTTONS_PORT_MAX)
+    {
+        return BUTTONS_PORT_INVALID;
+    }
+    pPort = &Buttons_Port[Buttons_PortNum];
+    pPort->GPIOx         = GPIOx;
+    pPort->PinMask       = PinMask;
+    pPort->ActiveLowMask = ActiveLowMask & PinMask;
+    pPort->State         = (uint16_t)((GPIOx->IDR ^ pPort->ActiveLowMask) & PinMask);
+    pPort->Cnt0          = 0U;
+    pPort->Cnt1          = 0U;
+    pPort->LongArmed     = 0U;
+    pPort->DoubleArmed   = 0U;
+
+    return Buttons_PortNum++;
+}
+
+/**
+ * @brief This function samples all ports and queues the events, it must be called every TickPeriod ms
+ *        (e.g, from a timer update interrupt).
+ *
+ */
+void Buttons_Tick(void)
+{
+    Buttons_Port_t * pPort;
+    uint16_t Sample, Delta, Toggle, Pressed, Released, Pending;
+    uint8_t Port, Pin;
+
+    Buttons_Ticks++;
+    for (Port = 0; Port < Buttons_PortNum; Port++)
+    {
+        pPort = &Buttons_Port[Port];
+
+        /*1. One IDR read for the 16 pins, normalized to 1 = pressed*/
+        Sample = (uint16_t)((pPort->GPIOx->IDR ^ pPort->ActiveLowMask) & pPort->PinMask);
+
+        /*2. Vertical counters: the counter of a pin counts the samples that differ from the debounced state,
+             it is cleared by a sample equal to the state and toggles the state when it wraps around*/
+        Delta = Sample ^ pPort->State;
+        pPort->Cnt1 = (pPort->Cnt1 ^ pPort->Cnt0) & Delta;
+        pPort->Cnt0 = (uint16_t)(~pPort->Cnt0) & Delta;
+        Toggle = Delta & (uint16_t)~(pPort->Cnt0 | pPort->Cnt1);
+        pPort->State ^= Toggle;
+        Pressed = Toggle & pPort->State;
+        Released = Toggle & (uint16_t)~pPort->State;
+
+        /*3. Press events*/
+        Pending = Pressed;
+        while (Pending != 0U)
+        {
+            Pin = (uint8_t)__builtin_ctz(Pending);
+            Pending &= (uint16_t)(Pending - 1U);
+            RingBuf_Put(Buttons_Queue, BUTTONS_EVT(Port, BUTTONS_EVT_PRESS, Pin));
+            if (((pPort->DoubleArmed >> Pin) & 0x01U) && ((Buttons_Ticks - pPort->Stamp[Pin]) <= Buttons_DoubleTicks))
+            {
+                RingBuf_Put(Buttons_Queue, BUTTONS_EVT(Port, BUTTONS_EVT_DOUBLE, Pin));
+                /*A third press is not a double press again*/
+                pPort->DoubleArmed &= (uint16_t)~(0x01U << Pin);
+            }
+            else
+            {
+                pPort->DoubleArmed |= (uint16_t)(0x01U << Pin);
+            }
+            pPort->Stamp[Pin] = Buttons_Ticks;
+        }
+        pPort->LongArmed |= Pressed;
+
+        /*4. Release events*/
+        Pending = Released;
+        while (Pending != 0U)
+        {
+            Pin = (uint8_t)__builtin_ctz(Pending);
+            Pending &= (uint16_t)(Pending - 1U);
+            RingBuf_Put(Buttons_Queue, BUTTONS_EVT(Port, BUTTONS_EVT_RELEASE, Pin));
+            pPort->Stamp[Pin] = Buttons_Ticks;
+        }
+        pPort->LongArmed &= (uint16_t)~Released;
+
+        /*5. Long press events, only the held buttons are checked*/
+        Pending = pPort->LongArmed;
+        while (Pending != 0U)
+        {
+            Pin = (uint8_t)__builtin_ctz(Pending);
+            Pending &= (uint16_t)(Pending - 1U);
+            if ((Buttons_Ticks - pPort->Stamp[Pin]) >= Buttons_LongTicks)
+            {
+                RingBuf_Put(Buttons_Queue, BUTTONS_EVT(Port, BUTTONS_EVT_LONG, Pin));
+                pPort->LongArmed &= (uint16_t)~(0x01U << Pin);
+                /*A long press does not start a double press*/
+                pPort->DoubleArmed &= (uint16_t)~(0x01U << Pin);
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function gets the debounced state of the buttons of a port.
+ *
+ * @param Port Port index returned by Buttons_AddPort
+ *
+ * @return uint16_t Debounced state, bit n is 1 when the button on pin n is pressed
+ */
+uint16_t Buttons_GetState(uint8_t Port)
+{
+    if (Port >= Buttons_PortNum)
+    {
+        return 0U;
+    }
+
+    return Buttons_Port[Port].State;
+}
@@ -36,3 +36,119 @@ void NVIC_EnableIRQ(uint8_t IRQNumber)
     /*Enable the IRQ*/
     NVIC->ISER[index] |= (0x01U << bitpos);
 }
+
+/**
+ * @brief This function gets the priority of the given IRQ number
+ * 
+ * @param IRQNumber Interrupt request number
+ * 
+ * @return uint8_t The priority in [0..15]
+ */
+uint8_t NVIC_GetPriority(uint8_t IRQNumber)
+{
+    uint8_t index, bitpos;
+
+    index = IRQNumber / 4U;
+    bitpos = (IRQNumber % 4U) * 8U;
+    return (uint8_t)((NVIC->IPR[index] >> (bitpos + 4U)) & 0x0FU);
+}
+
+/**
+ * @brief This function disables interrupt request for the given IRQ
+ *        When it returns, the interrupt handler can not start anymore
+ * 
+ * @param IRQNumber Interrupt request number to be disabled
+ */
+void NVIC_DisableIRQ(uint8_t IRQNumber)
+{
+    /*Writing 0 has no effect, no read-modify-write is needed*/
+    NVIC->ICER[IRQNumber / 32U] = (0x01U << (IRQNumber % 32U));
+    /*Complete the write before the next instructions, a pending interrupt could still be taken otherwise*/
+    CM4_DSB();
+    CM4_ISB();
+}
+
+/**
+ * @brief This function sets the pending status of the given IRQ, the handler runs as if the peripheral requested it
+ * 
+ * @param IRQNumber Interrupt request number
+ */
+void NVIC_SetPendingIRQ(uint8_t IRQNumber)
+{
+    NVIC->ISPR[IRQNumber / 32U] = (0x01U << (IRQNumber % 32U));
+}
+
+/**
+ * @brief This function clears the pending status of the given IRQ
+ * 
+ * @param IRQNumber Interrupt request number
+ */
+void NVIC_ClearPendingIRQ(uint8_t IRQNumber)
+{
+    NVIC->ICPR[IRQNumber / 32U] = (0x01U << (IRQNumber % 32U));
+}
+
+/**
+ * @brief This function gets the pending status of the given IRQ
+ * 
+ * @param IRQNumber Interrupt request number
+ * 
+ * @return uint8_t 1 if the interrupt is pending, 0 otherwise
+ */
+uint8_t NVIC_GetPendingIRQ(uint8_t IRQNumber)
+{
+    return (uint8_t)((NVIC->ISPR[IRQNumber / 32U] >> (IRQNumber % 32U)) & 0x01U);
+}
+
+/**
+ * @brief This function gets the active status of the given IRQ
+ * 
+ * @param IRQNumber Interrupt request number
+ * 
+ * @return uint8_t 1 if the handler is running or preempted, 0 otherwise
+ */
+uint8_t NVIC_GetActive(uint8_t IRQNumber)
+{
+    return (uint8_t)((NVIC->IABR[IRQNumber / 32U] >> (IRQNumber % 32U)) & 0x01U);
+}
+
+/**
+ * @brief This function sets the split of the priority field between the preemption priority and the subpriority
+ *        Only the preemption priority decides if an interrupt preempts another one (and BASEPRI masking),
+ *        the subpriority orders the pending interrupts of the same preemption priority
+ * 
+ * @param PriorityGroup The priority grouping, this should be a value of @ref NVIC_Priority_Group
+ */
+void NVIC_SetPriorityGrouping(uint8_t PriorityGroup)
+{
+    uint32_t temp;
+
+    temp = SCB->AIRCR;
+    /*The key field reads back as 0xFA05, it is overwritten*/
+    temp &= ~((0xFFFFU << SCB_AIRCR_VECTKEY) | (0x07U << SCB_AIRCR_PRIGROUP));
+    temp |= (SCB_AIRCR_VECTKEY_VALUE << SCB_AIRCR_VECTKEY) | ((uint32_t)(PriorityGroup & 0x07U) << SCB_AIRCR_PRIGROUP);
+    SCB->AIRCR = temp;
+}
+
+/**
+ * @brief This function gets the priority grouping
+ * 
+ * @return uint8_t A value of @ref NVIC_Priority_Group
+ */
+uint8_t NVIC_GetPriorityGrouping(void)
+{
+    return (uint8_t)((SCB->AIRCR >> SCB_AIRCR_PRIGROUP) & 0x07U);
+}
+
+/**
+ * @brief This function enables the DWT cycle counter (DWT_CYCCNT), it counts the core clock cycles
+ *        and wraps around every 2^32 cycles (about 25 s at 168 MHz)
+ * 
+ */
+void DWT_CycleCounterInit(void)
+{
+    /*Enable the trace units, the DWT is not clocked otherwise*/
+    DEMCR |= (0x01UL << DEMCR_TRCENA);
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= (0x01UL << DWT_CTRL_CYCCNTENA);
+}
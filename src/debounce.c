@@ -0,0 +1,262 @@
+#include "debounce.h"
+
+/*Debounce state of each EXTI line*/
+static Debounce_Line_t Debounce_Line[DEBOUNCE_LINE_NUM];
+/*Lines that are not in the idle state, only these are handled by Debounce_Tick.
+  It is changed from the EXTI and the tick interrupts, with atomic operations (LDREX/STREX)*/
+static volatile uint16_t Debounce_ActiveMask = 0U;
+/*1 ms periodic software timer running Debounce_Tick, armed while a line is masked*/
+static SoftTimer_t Debounce_Timer;
+
+/**
+ * @brief This function is the callback of the debounce software timer.
+ *
+ * @param Context Not used
+ */
+static void Debounce_TimerCallback(void * Context)
+{
+    uint32_t primask;
+
+    (void)Context;
+    Debounce_Tick();
+    /*Stop the tick when all the lines are armed again. The EXTI interrupts are masked during the check,
+      so a press can not start the timer between the check and the stop*/
+    primask = CM4_IRQSave();
+    if (Debounce_ActiveMask == 0U)
+    {
+        SoftTimer_Stop(&Debounce_Timer);
+    }
+    CM4_IRQRestore(primask);
+}
+
+/**
+ * @brief This function configures the debouncing of a button.
+ *        The pin and its EXTI line must be configured by the application (Board_Init, or GPIO_Init and GPIO_IT_Init),
+ *        and the EXTI callback of the line (GPIO_EXTI_Register) must call Debounce_EdgeIRQ.
+ *        The time base must be started to get the press timestamps (Timebase_Init).
+ *
+ * @param GPIOx Port of the button (e.g, GPIOA)
+ * @param PinNumber Pin number of the button, it is also the EXTI line number
+ * @param ActiveLevel Pin level when the button is pressed, BIT_SET or BIT_RESET
+ * @param LockoutTime Press lockout and release stable time in ms, must be at least 1
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+uint8_t Debounce_Init(GPIO_RegDef_t * GPIOx, uint8_t PinNumber, uint8_t ActiveLevel, uint16_t LockoutTime)
+{
+    Debounce_Line_t * pLine;
+
+    if ((PinNumber >= DEBOUNCE_LINE_NUM) || (LockoutTime == 0U))
+    {
+        return FALSE;
+    }
+    if (SoftTimer_IsArmed(&Debounce_Timer) == FALSE)
+    {
+        SoftTimer_Create(&Debounce_Timer, Debounce_TimerCallback, NULL);
+    }
+    pLine = &Debounce_Line[PinNumber];
+    pLine->GPIOx       = GPIOx;
+    pLine->ActiveLevel = ActiveLevel;
+    pLine->LockoutTime = LockoutTime;
+    pLine->State       = DEBOUNCE_STATE_IDLE;
+    pLine->Timer       = 0U;
+    pLine->PressStamp  = 0U;
+    pLine->PressCount  = 0U;
+    pLine->BounceCount = 0U;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function handles an edge of a button, it is called from the EXTI callback of the line
+ *        (the GPIO driver has cleared the pending bit). When the line is idle, it reports the press and masks the line.
+ *
+ * @param PinNumber Pin number of the button
+ *
+ * @return uint8_t TRUE if a new press is reported, FALSE otherwise
+ */
+uint8_t Debounce_EdgeIRQ(uint8_t PinNumber)
+{
+    Debounce_Line_t * pLine;
+    uint32_t primask;
+
+    if (PinNumber >= DEBOUNCE_LINE_NUM)
+    {
+        return FALSE;
+    }
+    pLine = &Debounce_Line[PinNumber];
+    if ((pLine->LockoutTime == 0U) || (pLine->State != DEBOUNCE_STATE_IDLE))
+    {
+        return FALSE;
+    }
+    /*Report the first edge and ignore the line until the button is released. The press time is the
+      dispatch timestamp of the edge, taken before the callbacks of the lower lines sharing the vector*/
+    pLine->PressStamp = GPIO_EXTI_GetLine(PinNumber)->EdgeStamp;
+    pLine->PressCount++;
+    /*EXTI_IMR is shared with the debounce tick and the idle manager, it is updated with the interrupts masked*/
+    primask = CM4_IRQSave();
+    EXTI->IMR &= ~(0x01U << PinNumber);
+    CM4_IRQRestore(primask);
+    pLine->Timer = pLine->LockoutTime;
+    pLine->State = DEBOUNCE_STATE_LOCKOUT;
+    if (__atomic_fetch_or(&Debounce_ActiveMask, (uint16_t)(0x01U << PinNumber), __ATOMIC_RELAXED) == 0U)
+    {
+        /*First masked line, start the 1 ms tick*/
+        SoftTimer_Start(&Debounce_Timer, 1U, 1U);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief This function runs the lockout and the release integrator of the masked lines, it is called every 1 ms
+ *        by the debounce software timer.
+ *
+ */
+void Debounce_Tick(void)
+{
+    Debounce_Line_t * pLine;
+    uint32_t primask;
+    uint16_t Pending;
+    uint8_t Line;
+
+    Pending = Debounce_ActiveMask;
+    while (Pending != 0U)
+    {
+        Line = (uint8_t)__builtin_ctz(Pending);
+        Pending &= (uint16_t)(Pending - 1U);
+        pLine = &Debounce_Line[Line];
+
+        if (pLine->State == DEBOUNCE_STATE_LOCKOUT)
+        {
+            pLine->Timer--;
+            if (pLine->Timer == 0U)
+            {
+                pLine->State = DEBOUNCE_STATE_RELEASE;
+            }
+        }
+        else if (GPIO_PinRead(pLine->GPIOx, Line) == pLine->ActiveLevel)
+        {
+            /*Still pressed or bouncing, restart the integrator*/
+            if (pLine->Timer != 0U)
+            {
+                pLine->BounceCount++;
+            }
+            pLine->Timer = 0U;
+        }
+        else
+        {
+            pLine->Timer++;
+            if (pLine->Timer >= pLine->LockoutTime)
+            {
+                /*Stable release, drop the edges latched meanwhile and arm the line again*/
+                pLine->State = DEBOUNCE_STATE_IDLE;
+                __atomic_fetch_and(&Debounce_ActiveMask, (uint16_t)~(0x01U << Line), __ATOMIC_RELAXED);
+                EXTI->PR = (0x01U << Line);
+                /*A button interrupt may mask another line meanwhile*/
+                primask = CM4_IRQSave();
+                EXTI->IMR |= (0x01U << Line);
+                CM4_IRQRestore(primask);
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function gets the debounce state and the counters of a button.
+ *
+ * @param PinNumber Pin number of the button
+ *
+ * @return const Debounce_Line_t* Debounce state, NULL if PinNumber is not valid
+ */
+const Debounce_Line_t * Debounce_GetLine(uint8_t PinNumber)
+{
+    if (PinNumber >= DEBOUNCE_LINE_NUM)
+    {
+        return NULL;
+    }
+
+    return &Debounce_Line[PinNumber];
+}
+
+/**
+ * @brief This function initializes an input capture button. The timer, its channels and its interrupts
+ *        must be configured by the application (TIM_Base_Init, TIM_IC_Init, TIM_IC_IT_Init, TIM_Base_IT_Init).
+ *
+ * @param pButton Pointer to the button state
+ * @param TIMx Free running 32 bit timer capturing the button input (TIM2 or TIM5)
+ * @param PressChannel Channel capturing the press edges
+ * @param ReleaseChannel Channel capturing the release edges
+ * @param QuietTime Time in ms without edges needed before a new press
+ */
+void Debounce_CaptureInit(Debounce_Capture_t * pButton, TIM_RegDef_t * TIMx, uint8_t PressChannel,
+                          uint8_t ReleaseChannel, uint16_t QuietTime)
+{
+    pButton->TIMx           = TIMx;
+    pButton->PressChannel   = PressChannel;
+    pButton->ReleaseChannel = ReleaseChannel;
+    pButton->QuietTime      = QuietTime;
+    /*No edge seen yet, the first press is accepted*/
+    pButton->IdlePeriods    = 2U;
+    pButton->LastEdge       = 0U;
+    pButton->PressStamp     = 0U;
+    pButton->PressCount     = 0U;
+    pButton->BounceCount    = 0U;
+}
+
+/**
+ * @brief This function handles the interrupt of the timer capturing the button, it is called from the TIMx_IRQHandler.
+ *
+ * @param pButton Pointer to the button state
+ *
+ * @return uint8_t TRUE if a new press is reported (its timestamp is pButton->PressStamp), FALSE otherwise
+ */
+uint8_t Debounce_CaptureIRQ(Debounce_Capture_t * pButton)
+{
+    TIM_RegDef_t * TIMx = pButton->TIMx;
+    uint32_t Press, Release, QuietTicks;
+    uint8_t HasPress, HasRelease, NewPress = FALSE;
+
+    /*The counter wraps around every 2^32 ticks, after two update events without edge the input is quiet*/
+    if (((TIMx->SR >> TIM_SR_UIF) & 0x01U) == BIT_SET)
+    {
+        TIMx->SR = ~(0x01U << TIM_SR_UIF);
+        if (pButton->IdlePeriods < 2U)
+        {
+            pButton->IdlePeriods++;
+        }
+    }
+
+    HasRelease = TIM_IC_GetCapture(TIMx, pButton->ReleaseChannel, &Release);
+    HasPress = TIM_IC_GetCapture(TIMx, pButton->PressChannel, &Press);
+    /*Handle the two edges in time order*/
+    if ((HasRelease == TRUE) && ((HasPress == FALSE) || ((int32_t)(Release - Press) < 0)))
+    {
+        pButton->LastEdge = Release;
+        pButton->IdlePeriods = 0U;
+        HasRelease = FALSE;
+    }
+    if (HasPress == TRUE)
+    {
+        QuietTicks = (uint32_t)pButton->QuietTime * (RCC_GetTIMxClkVal(TIMx) / 1000U);
+        if ((pButton->IdlePeriods >= 2U) || ((Press - pButton->LastEdge) >= QuietTicks))
+        {
+            pButton->PressStamp = Press;
+            pButton->PressCount++;
+            NewPress = TRUE;
+        }
+        else
+        {
+            pButton->BounceCount++;
+        }
+        pButton->LastEdge = Press;
+        pButton->IdlePeriods = 0U;
+    }
+    if (HasRelease == TRUE)
+    {
+        pButton->LastEdge = Release;
+        pButton->IdlePeriods = 0U;
+    }
+
+    return NewPress;
+}
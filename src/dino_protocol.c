@@ -0,0 +1,204 @@
+#include "dino_protocol.h"
+
+/*CRC-8/SMBUS lookup table (poly 0x07)*/
+static const uint8_t DinoProto_Crc8Table[256] =
+{
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
+};
+
+/**
+ * @brief This function computes the CRC-8/SMBUS of a buffer.
+ *
+ * @param Data Pointer to the data
+ * @param Length Number of bytes
+ *
+ * @return uint8_t CRC value
+ */
+uint8_t DinoProto_Crc8(const uint8_t * Data, uint16_t Length)
+{
+    uint8_t Crc = 0x00U;
+    uint16_t i;
+
+    for (i = 0; i < Length; i++)
+    {
+        Crc = DinoProto_Crc8Table[Crc ^ Data[i]];
+    }
+
+    return Crc;
+}
+
+/**
+ * @brief This function builds a COBS encoded frame terminated by 0x00.
+ *
+ * @param Id Message ID, @ref Message IDs
+ * @param Payload Pointer to the payload, can be NULL when Length is 0
+ * @param Length Payload length [0..DINO_PROTO_MAX_PAYLOAD]
+ * @param Frame Buffer to store the encoded frame
+ * @param FrameSize Size of the frame buffer, DINO_PROTO_MAX_FRAME is always enough
+ *
+ * @return uint16_t Number of bytes to be sent, 0 if the message does not fit
+ */
+uint16_t DinoProto_Encode(uint8_t Id, const uint8_t * Payload, uint8_t Length, uint8_t * Frame, uint16_t FrameSize)
+{
+    uint8_t Raw[DINO_PROTO_MAX_PAYLOAD + 2U];
+    uint8_t RawLength, Code, i;
+    uint16_t CodeIndex, OutIndex;
+
+    if ((Length > DINO_PROTO_MAX_PAYLOAD) || (FrameSize < (uint16_t)(Length + 4U)))
+    {
+        return 0U;
+    }
+    /*1. Build the header, payload and CRC*/
+    Raw[0] = (uint8_t)((DINO_PROTO_VERSION << 5) | (Id & 0x1FU));
+    for (i = 0; i < Length; i++)
+    {
+        Raw[1U + i] = Payload[i];
+    }
+    Raw[1U + Length] = DinoProto_Crc8(Raw, 1U + Length);
+    RawLength = Length + 2U;
+
+    /*2. COBS encode, each code byte gives the distance to the next zero*/
+    CodeIndex = 0U;
+    OutIndex = 1U;
+    Code = 1U;
+    for (i = 0; i < RawLength; i++)
+    {
+        if (Raw[i] == 0x00U)
+        {
+            Frame[CodeIndex] = Code;
+            CodeIndex = OutIndex;
+            OutIndex++;
+            Code = 1U;
+        }
+        else
+        {
+            Frame[OutIndex] = Raw[i];
+            OutIndex++;
+            Code++;
+        }
+    }
+    Frame[CodeIndex] = Code;
+
+    /*3. Terminate the frame*/
+    Frame[OutIndex] = 0x00U;
+    OutIndex++;
+
+    return OutIndex;
+}
+
+/**
+ * @brief This function resets a streaming decoder, the counters are cleared.
+ *
+ * @param pDecoder Pointer to the decoder
+ */
+void DinoProto_DecoderInit(DinoProto_Decoder_t * pDecoder)
+{
+    pDecoder->Length     = 0U;
+    pDecoder->Code       = 0U;
+    pDecoder->Remaining  = 0U;
+    pDecoder->Overflow   = 0U;
+    pDecoder->FrameCount = 0U;
+    pDecoder->ErrorCount = 0U;
+}
+
+/**
+ * @brief This function appends one decoded byte to the frame being received.
+ *
+ * @param pDecoder Pointer to the decoder
+ * @param Byte Decoded byte
+ */
+static void DinoProto_Append(DinoProto_Decoder_t * pDecoder, uint8_t Byte)
+{
+    if (pDecoder->Length < sizeof(pDecoder->Buffer))
+    {
+        pDecoder->Buffer[pDecoder->Length] = Byte;
+        pDecoder->Length++;
+    }
+    else
+    {
+        pDecoder->Overflow = 1U;
+    }
+}
+
+/**
+ * @brief This function feeds one received byte to the streaming decoder.
+ *        COBS decoding is done on the fly, the frame is checked when the 0x00 delimiter arrives.
+ *
+ * @param pDecoder Pointer to the decoder
+ * @param Byte Received byte
+ * @param pMsg Pointer to store the message, only written when DINO_PROTO_FRAME_OK is returned
+ *
+ * @return uint8_t DINO_PROTO_BUSY, DINO_PROTO_FRAME_OK or DINO_PROTO_FRAME_ERROR
+ */
+uint8_t DinoProto_Decode(DinoProto_Decoder_t * pDecoder, uint8_t Byte, DinoProto_Msg_t * pMsg)
+{
+    uint8_t Status, i;
+
+    if (Byte != 0x00U)
+    {
+        if (pDecoder->Remaining == 0U)
+        {
+            /*Code byte, the previous block ended with an implicit zero unless it was a full block*/
+            if ((pDecoder->Code != 0U) && (pDecoder->Code != 0xFFU))
+            {
+                DinoProto_Append(pDecoder, 0x00U);
+            }
+            pDecoder->Code = Byte;
+            pDecoder->Remaining = Byte - 1U;
+        }
+        else
+        {
+            DinoProto_Append(pDecoder, Byte);
+            pDecoder->Remaining--;
+        }
+        return DINO_PROTO_BUSY;
+    }
+
+    /*Delimiter, check the frame*/
+    if (pDecoder->Code == 0U)
+    {
+        /*Empty frame (e.g, two delimiters in a row), used to resynchronize*/
+        Status = DINO_PROTO_BUSY;
+    }
+    else if ((pDecoder->Overflow != 0U) || (pDecoder->Remaining != 0U) || (pDecoder->Length < 2U)
+          || ((pDecoder->Buffer[0] >> 5) != DINO_PROTO_VERSION)
+          || (DinoProto_Crc8(pDecoder->Buffer, pDecoder->Length) != 0x00U))
+    {
+        /*The CRC of a frame including its own CRC byte is 0*/
+        pDecoder->ErrorCount++;
+        Status = DINO_PROTO_FRAME_ERROR;
+    }
+    else
+    {
+        pMsg->Id = pDecoder->Buffer[0] & 0x1FU;
+        pMsg->Length = pDecoder->Length - 2U;
+        for (i = 0; i < pMsg->Length; i++)
+        {
+            pMsg->Payload[i] = pDecoder->Buffer[1U + i];
+        }
+        pDecoder->FrameCount++;
+        Status = DINO_PROTO_FRAME_OK;
+    }
+    /*Prepare for the next frame*/
+    pDecoder->Length    = 0U;
+    pDecoder->Code      = 0U;
+    pDecoder->Remaining = 0U;
+    pDecoder->Overflow  = 0U;
+
+    return Status;
+}
@@ -0,0 +1,173 @@
+#include "event.h"
+
+static volatile uint32_t Event_Sequence[EVENT_PRIO_NUM][EVENT_QUEUE_SIZE];
+static Event_t Event_Storage[EVENT_PRIO_NUM][EVENT_QUEUE_SIZE];
+static MpscQueue_t Event_Queue[EVENT_PRIO_NUM];
+static Event_Handler_t Event_Handler[EVENT_TYPE_NUM];
+static Event_TypeStats_t Event_Stats[EVENT_TYPE_NUM];
+
+/**
+ * @brief This function initializes the event queues, the handlers are removed.
+ *
+ */
+void Event_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < EVENT_PRIO_NUM; i++)
+    {
+        MpscQueue_Init(&Event_Queue[i], Event_Sequence[i], EVENT_QUEUE_SIZE);
+    }
+    for (i = 0U; i < EVENT_TYPE_NUM; i++)
+    {
+        Event_Handler[i] = NULL;
+    }
+}
+
+/**
+ * @brief This function sets the handler of an event type, the events without handler are dropped when dispatched.
+ *
+ * @param Type Event type, a value of @ref Event_Type
+ * @param Handler Function called from Event_Dispatch, NULL to remove the handler
+ *
+ * @return uint8_t TRUE on success, FALSE if Type is not valid
+ */
+uint8_t Event_Subscribe(uint8_t Type, Event_Handler_t Handler)
+{
+    if (Type >= EVENT_TYPE_NUM)
+    {
+        return FALSE;
+    }
+    Event_Handler[Type] = Handler;
+    return TRUE;
+}
+
+/**
+ * @brief This function posts an event, it can be called from any context.
+ *
+ * @param Type Event type, a value of @ref Event_Type
+ * @param Code Type specific code
+ * @param Param Type specific parameter
+ * @param Priority Event priority, a value of @ref Event_Priority
+ *
+ * @return uint8_t TRUE if the event was queued, FALSE if the queue is full or a parameter is not valid
+ */
+uint8_t Event_Post(uint8_t Type, uint8_t Code, uint32_t Param, uint8_t Priority)
+{
+    MpscQueue_t * pQueue;
+    Event_t * pEvent;
+    uint32_t Pos;
+
+    if ((Type >= EVENT_TYPE_NUM) || (Priority >= EVENT_PRIO_NUM))
+    {
+        return FALSE;
+    }
+    pQueue = &Event_Queue[Priority];
+    if (MpscQueue_Reserve(pQueue, &Pos) == FALSE)
+    {
+        return FALSE;
+    }
+    pEvent = &Event_Storage[Priority][MPSC_QUEUE_INDEX(pQueue, Pos)];
+    pEvent->Type      = Type;
+    pEvent->Code      = Code;
+    pEvent->Param     = Param;
+    pEvent->PostStamp = Timebase_NowCycles();
+    MpscQueue_Publish(pQueue, Pos);
+    return TRUE;
+}
+
+/**
+ * @brief This function checks if events are waiting, the idle loop uses it with the interrupts masked.
+ *
+ * @return uint8_t TRUE if at least one event is queued
+ */
+uint8_t Event_IsPending(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < EVENT_PRIO_NUM; i++)
+    {
+        if (MpscQueue_GetDepth(&Event_Queue[i]) != 0U)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief This function dispatches the oldest event of the highest priority queue not empty.
+ *        It is called from the main loop only (single consumer).
+ *
+ * @return uint8_t TRUE if an event was taken, FALSE if no event is ready
+ */
+uint8_t Event_Dispatch(void)
+{
+    Event_TypeStats_t * pStats;
+    Event_Handler_t Handler;
+    Event_t Event;
+    uint32_t Pos, Start, Cycles;
+    uint8_t i;
+
+    for (i = 0U; i < EVENT_PRIO_NUM; i++)
+    {
+        if (MpscQueue_Peek(&Event_Queue[i], &Pos) == TRUE)
+        {
+            break;
+        }
+    }
+    if (i == EVENT_PRIO_NUM)
+    {
+        return FALSE;
+    }
+    Event = Event_Storage[i][MPSC_QUEUE_INDEX(&Event_Queue[i], Pos)];
+    MpscQueue_Release(&Event_Queue[i], Pos);
+
+    Handler = Event_Handler[Event.Type];
+    if (Handler == NULL)
+    {
+        return TRUE;
+    }
+    pStats = &Event_Stats[Event.Type];
+    Start = Timebase_NowCycles();
+    if ((Start - Event.PostStamp) > pStats->MaxLatency)
+    {
+        pStats->MaxLatency = Start - Event.PostStamp;
+    }
+    Handler(&Event);
+    Cycles = Timebase_ElapsedCycles(Start);
+
+    /*The handler cycles include the interrupts served meanwhile*/
+    pStats->Count++;
+    pStats->Cycles = Cycles;
+    pStats->TotalCycles += Cycles;
+    if (Cycles > pStats->MaxCycles)
+    {
+        pStats->MaxCycles = Cycles;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the dispatch statistics of an event type.
+ *
+ * @param Type Event type, a value of @ref Event_Type
+ *
+ * @return const Event_TypeStats_t* NULL if Type is not valid
+ */
+const Event_TypeStats_t * Event_GetTypeStats(uint8_t Type)
+{
+    return (Type < EVENT_TYPE_NUM) ? &Event_Stats[Type] : NULL;
+}
+
+/**
+ * @brief This function gets the number of events dropped because their queue was full.
+ *
+ * @param Priority A value of @ref Event_Priority
+ *
+ * @return uint32_t
+ */
+uint32_t Event_GetDropped(uint8_t Priority)
+{
+    return (Priority < EVENT_PRIO_NUM) ? Event_Queue[Priority].Dropped : 0U;
+}
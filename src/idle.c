@@ -0,0 +1,153 @@
+#include "idle.h"
+
+static Idle_Conf_t Idle_Conf;
+static Idle_Stats_t Idle_Stats;
+/*Sleep time not counted in Idle_Stats.SleepTime yet, in us*/
+static uint32_t Idle_SleepRemainder = 0U;
+/*Timebase_NowUs value at the last activity*/
+static volatile uint32_t Idle_LastActivity = 0U;
+/*TRUE while the clock tree is restored after STOP*/
+static volatile uint8_t Idle_Waking = FALSE;
+/*Cycle counter value when the clock tree was switched back*/
+static volatile uint32_t Idle_SwitchCycles = 0U;
+
+/**
+ * @brief This function records the end of the HSI part of the wakeup.
+ *        It is called by RCC_SysClkConfig right after the clock switch.
+ *
+ * @param pClocks New clock frequencies
+ */
+static void Idle_ClockChangeCallback(const RCC_ClockState_t * pClocks)
+{
+    (void)pClocks;
+    if (Idle_Waking == TRUE)
+    {
+        Idle_SwitchCycles = Timebase_NowCycles();
+        Idle_Waking = FALSE;
+    }
+}
+
+/**
+ * @brief This function sleeps (WFI) until the next interrupt, the interrupts are masked by the caller.
+ *
+ */
+static void Idle_Sleep(void)
+{
+    uint32_t Start;
+
+    Start = Timebase_NowUs();
+    CM4_WFI();
+    Idle_SleepRemainder += Timebase_ElapsedUs(Start);
+    Idle_Stats.SleepTime += Idle_SleepRemainder / 1000U;
+    Idle_SleepRemainder %= 1000U;
+    Idle_Stats.SleepCount++;
+}
+
+/**
+ * @brief This function enters STOP until an EXTI line wakes the core up, then restores the clock tree.
+ *        The interrupts are masked by the caller, the wakeup interrupt is served after the clock restore.
+ *
+ */
+static void Idle_Stop(void)
+{
+    uint32_t WakeCycles, Latency;
+
+    /*Arm the wake lines, a stale pending bit would end STOP at once*/
+    EXTI->PR = Idle_Conf.WakeLines;
+    EXTI->IMR |= Idle_Conf.WakeLines;
+    /*STOP with the low-power regulator, the flash stays powered for a faster wakeup*/
+    PWR->CR &= ~(0x01U << PWR_CR_PDDS);
+    PWR->CR |= (0x01U << PWR_CR_LPDS);
+    SCB->SCR |= (0x01U << SCB_SCR_SLEEPDEEP);
+    CM4_WFI();
+
+    /*Running on the HSI, the cycle counter resumes from its value at the STOP entry*/
+    WakeCycles = Timebase_NowCycles();
+    SCB->SCR &= ~(0x01U << SCB_SCR_SLEEPDEEP);
+    /*The pending bit of the line that woke the core up stays set, its interrupt is still served*/
+    EXTI->IMR &= ~Idle_Conf.WakeLines;
+
+    Idle_SwitchCycles = WakeCycles;
+    Idle_Waking = TRUE;
+    /*On failure the system keeps running on the HSI, the drivers follow it*/
+    RCC_SysClkConfig(*Idle_Conf.pClkConf);
+    Idle_Waking = FALSE;
+
+    Latency = (Idle_SwitchCycles - WakeCycles) / (HSI_VALUE / 1000000U)
+            + Timebase_CyclesToUs(Timebase_ElapsedCycles(Idle_SwitchCycles));
+    Idle_Stats.WakeLatencyLast = Latency;
+    if (Latency > Idle_Stats.WakeLatencyMax)
+    {
+        Idle_Stats.WakeLatencyMax = Latency;
+    }
+    Idle_Stats.StopCount++;
+    /*The wakeup is an activity, the next STOP waits StopDelay again*/
+    Idle_LastActivity = Timebase_NowUs();
+}
+
+/**
+ * @brief This function initializes the idle manager, it must be called after Timebase_Init and SoftTimer_Init.
+ *
+ * @param IdleConf Idle configuration, the clock configuration pointed to must stay valid
+ */
+void Idle_Init(Idle_Conf_t IdleConf)
+{
+    Idle_Conf = IdleConf;
+    if ((Idle_Conf.pClkConf == NULL) || (Idle_Conf.CanStop == NULL))
+    {
+        Idle_Conf.StopDelay = 0U;
+    }
+    /*The wake lines only wake the core from STOP*/
+    EXTI->IMR &= ~Idle_Conf.WakeLines;
+    PWR_CLK_ENB();
+    RCC_RegisterClockChangeCallback(Idle_ClockChangeCallback);
+    Idle_LastActivity = Timebase_NowUs();
+}
+
+/**
+ * @brief This function restarts the STOP delay, it is called when the main loop has done some work.
+ *
+ */
+void Idle_NotifyActivity(void)
+{
+    Idle_LastActivity = Timebase_NowUs();
+}
+
+/**
+ * @brief This function puts the core in SLEEP or STOP until the next interrupt, unless the main loop has work.
+ *        It is called from the main loop (thread mode), the pending interrupt is served before it returns.
+ *
+ */
+void Idle_Enter(void)
+{
+    uint32_t primask;
+
+    primask = CM4_IRQSave();
+    if (Idle_Conf.HasWork() == TRUE)
+    {
+        CM4_IRQRestore(primask);
+        return;
+    }
+    if ((Idle_Conf.StopDelay != 0U)
+        && (Timebase_IsExpired(Idle_LastActivity, Idle_Conf.StopDelay * 1000U) == TRUE)
+        && (SoftTimer_GetArmedCount() == 0U)
+        && (Idle_Conf.CanStop() == TRUE))
+    {
+        Idle_Stop();
+    }
+    else
+    {
+        Idle_Sleep();
+    }
+    CM4_IRQRestore(primask);
+}
+
+/**
+ * @brief This function gets the idle statistics.
+ *
+ * @return const Idle_Stats_t*
+ */
+const Idle_Stats_t * Idle_GetStats(void)
+{
+    return &Idle_Stats;
+}
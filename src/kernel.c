@@ -0,0 +1,676 @@
+#include "kernel.h"
+#include "kernel_port.h"
+
+/*Running task, the boot task until the first context switch*/
+Kernel_Task_t * volatile Kernel_Current = NULL;
+
+/*Ready lists (circular, the head runs next) and their bitmap, bit n is set when the priority n list is not empty*/
+static Kernel_Task_t * Kernel_ReadyList[KERNEL_PRIO_NUM];
+static uint32_t Kernel_ReadyMask = 0U;
+/*All the created tasks, scanned by the tick for the delays and the timeouts*/
+static Kernel_Task_t * Kernel_AllTasks = NULL;
+static volatile uint32_t Kernel_Tick = 0U;
+static uint8_t Kernel_Started = FALSE;
+static Kernel_Stats_t Kernel_Stats;
+/*Port cycles at the last context switch*/
+static uint32_t Kernel_SwitchStamp = 0U;
+/*Pending switch request and its time*/
+static uint8_t Kernel_SwitchRequested = FALSE;
+static uint32_t Kernel_RequestStamp = 0U;
+/*Function run by PendSV before the context switch (e.g, the deferred work)*/
+static void (*Kernel_PendSVHook)(void) = NULL;
+
+/*Context of the code calling Kernel_Start, it is never switched in again*/
+static Kernel_Task_t Kernel_BootTask;
+static Kernel_Task_t Kernel_IdleTask;
+static uint32_t Kernel_IdleStack[KERNEL_IDLE_STACK_SIZE] __attribute__((aligned(8)));
+
+/**
+ * @brief This function adds a task at the tail of its ready list. Called in a critical section.
+ *
+ * @param pTask Pointer to the task
+ */
+static void Kernel_ReadyInsert(Kernel_Task_t * pTask)
+{
+    Kernel_Task_t * pHead = Kernel_ReadyList[pTask->Priority];
+
+    pTask->State = KERNEL_TASK_READY;
+    pTask->Timed = FALSE;
+    if (pHead == NULL)
+    {
+        pTask->Next = pTask;
+        pTask->Prev = pTask;
+        Kernel_ReadyList[pTask->Priority] = pTask;
+        Kernel_ReadyMask |= (0x01UL << pTask->Priority);
+    }
+    else
+    {
+        pTask->Next = pHead;
+        pTask->Prev = pHead->Prev;
+        pHead->Prev->Next = pTask;
+        pHead->Prev = pTask;
+    }
+}
+
+/**
+ * @brief This function removes a task from its ready list. Called in a critical section.
+ *
+ * @param pTask Pointer to the task
+ */
+static void Kernel_ReadyRemove(Kernel_Task_t * pTask)
+{
+    if (pTask->Next == pTask)
+    {
+        Kernel_ReadyList[pTask->Priority] = NULL;
+        Kernel_ReadyMask &= ~(0x01UL << pTask->Priority);
+    }
+    else
+    {
+        pTask->Prev->Next = pTask->Next;
+        pTask->Next->Prev = pTask->Prev;
+        if (Kernel_ReadyList[pTask->Priority] == pTask)
+        {
+            Kernel_ReadyList[pTask->Priority] = pTask->Next;
+        }
+    }
+}
+
+/**
+ * @brief This function adds a task to the wait list of a semaphore, after the tasks of the same or higher priority.
+ *        Called in a critical section.
+ *
+ * @param pSem Pointer to the semaphore
+ * @param pTask Pointer to the task
+ */
+static void Kernel_WaitInsert(Kernel_Sem_t * pSem, Kernel_Task_t * pTask)
+{
+    Kernel_Task_t ** ppLink = &pSem->WaitList;
+
+    while ((*ppLink != NULL) && ((*ppLink)->Priority <= pTask->Priority))
+    {
+        ppLink = &(*ppLink)->Next;
+    }
+    pTask->Next = *ppLink;
+    *ppLink = pTask;
+    pTask->WaitObject = pSem;
+}
+
+/**
+ * @brief This function removes a task from the wait list of a semaphore. Called in a critical section.
+ *
+ * @param pSem Pointer to the semaphore
+ * @param pTask Pointer to the task
+ */
+static void Kernel_WaitRemove(Kernel_Sem_t * pSem, Kernel_Task_t * pTask)
+{
+    Kernel_Task_t ** ppLink = &pSem->WaitList;
+
+    while (*ppLink != NULL)
+    {
+        if (*ppLink == pTask)
+        {
+            *ppLink = pTask->Next;
+            break;
+        }
+        ppLink = &(*ppLink)->Next;
+    }
+    pTask->WaitObject = NULL;
+}
+
+/**
+ * @brief This function asks the port for a context switch. Called in a critical section, as its last action:
+ *        the host port switches at once, the Cortex-M4 port switches when the critical section ends.
+ *
+ */
+static void Kernel_RequestSwitch(void)
+{
+    if (Kernel_Started == FALSE)
+    {
+        return;
+    }
+    if (Kernel_SwitchRequested == FALSE)
+    {
+        Kernel_SwitchRequested = TRUE;
+        Kernel_RequestStamp = Kernel_PortCycles();
+    }
+    Kernel_PortRequestSwitch();
+}
+
+/**
+ * @brief This function initializes a task control block and its stack.
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+static uint8_t Kernel_TaskSetup(Kernel_Task_t * pTask, const char * Name, Kernel_TaskEntry_t Entry, void * Arg,
+                                uint8_t Priority, uint32_t * Stack, uint32_t StackSize)
+{
+    uint32_t i, State;
+
+    if ((pTask == NULL) || (Entry == NULL) || (Stack == NULL) || (StackSize < KERNEL_STACK_MIN)
+        || (Priority >= KERNEL_PRIO_NUM))
+    {
+        return FALSE;
+    }
+    for (i = 0U; i < StackSize; i++)
+    {
+        Stack[i] = KERNEL_STACK_FILL;
+    }
+    pTask->Name        = Name;
+    pTask->Entry       = Entry;
+    pTask->Arg         = Arg;
+    pTask->Stack       = Stack;
+    pTask->StackSize   = StackSize;
+    pTask->PortData    = NULL;
+    pTask->WaitObject  = NULL;
+    pTask->Priority    = Priority;
+    pTask->WaitResult  = FALSE;
+    pTask->Slice       = KERNEL_TIME_SLICE;
+    pTask->WakeTick    = 0U;
+    pTask->SwitchCount = 0U;
+    pTask->RunCycles   = 0U;
+    Kernel_PortInitStack(pTask);
+
+    State = Kernel_PortEnterCritical();
+    pTask->AllNext = Kernel_AllTasks;
+    Kernel_AllTasks = pTask;
+    Kernel_ReadyInsert(pTask);
+    if (Priority < Kernel_Current->Priority)
+    {
+        Kernel_RequestSwitch();
+    }
+    Kernel_PortExitCritical(State);
+    return TRUE;
+}
+
+/**
+ * @brief This function is the idle task, it runs when no other task is ready.
+ *
+ * @param Arg Not used
+ */
+static void Kernel_IdleEntry(void * Arg)
+{
+    (void)Arg;
+    while (1)
+    {
+        Kernel_PortIdle();
+    }
+}
+
+/**
+ * @brief This function initializes the kernel and creates the idle task. It is called before any other kernel function.
+ *
+ */
+void Kernel_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < KERNEL_PRIO_NUM; i++)
+    {
+        Kernel_ReadyList[i] = NULL;
+    }
+    Kernel_ReadyMask = 0U;
+    Kernel_AllTasks = NULL;
+    Kernel_Tick = 0U;
+    Kernel_Started = FALSE;
+    Kernel_SwitchRequested = FALSE;
+    /*The boot task has a priority below the idle task, so that any created task preempts it*/
+    Kernel_BootTask.Name     = "boot";
+    Kernel_BootTask.Priority = KERNEL_PRIO_NUM;
+    Kernel_BootTask.State    = KERNEL_TASK_DORMANT;
+    Kernel_Current = &Kernel_BootTask;
+    Kernel_TaskSetup(&Kernel_IdleTask, "idle", Kernel_IdleEntry, NULL, KERNEL_PRIO_IDLE,
+                     Kernel_IdleStack, KERNEL_IDLE_STACK_SIZE);
+}
+
+/**
+ * @brief This function creates a task, it is ready at once. It can be called before or after Kernel_Start.
+ *
+ * @param pTask Task control block, owned by the application
+ * @param Name Task name
+ * @param Entry Task function, the task becomes dormant if it returns
+ * @param Arg Given to the task function
+ * @param Priority Task priority in [0..KERNEL_PRIO_IDLE - 1], 0 is the highest
+ * @param Stack Stack storage (8 byte aligned), owned by the application
+ * @param StackSize Stack size in words, at least KERNEL_STACK_MIN
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+uint8_t Kernel_TaskCreate(Kernel_Task_t * pTask, const char * Name, Kernel_TaskEntry_t Entry, void * Arg,
+                          uint8_t Priority, uint32_t * Stack, uint32_t StackSize)
+{
+    if (Priority >= KERNEL_PRIO_IDLE)
+    {
+        return FALSE;
+    }
+    return Kernel_TaskSetup(pTask, Name, Entry, Arg, Priority, Stack, StackSize);
+}
+
+/**
+ * @brief This function starts the scheduling, the Cortex-M4 port never returns.
+ *        The host port returns at once, Kernel_PortSimRun runs the tasks.
+ *
+ */
+void Kernel_Start(void)
+{
+    Kernel_SwitchStamp = Kernel_PortCycles();
+    Kernel_Started = TRUE;
+    Kernel_PortStart();
+}
+
+/**
+ * @brief This function switches to the next task of the same priority, if any.
+ *
+ */
+void Kernel_Yield(void)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+
+    State = Kernel_PortEnterCritical();
+    pTask = Kernel_Current;
+    if (pTask->Next != pTask)
+    {
+        Kernel_ReadyList[pTask->Priority] = pTask->Next;
+        pTask->Slice = KERNEL_TIME_SLICE;
+        Kernel_RequestSwitch();
+    }
+    Kernel_PortExitCritical(State);
+}
+
+/**
+ * @brief This function suspends the calling task for the given number of ticks.
+ *
+ * @param Ticks Number of ticks, 0 yields the CPU
+ */
+void Kernel_Delay(uint32_t Ticks)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+
+    if (Ticks == 0U)
+    {
+        Kernel_Yield();
+        return;
+    }
+    State = Kernel_PortEnterCritical();
+    pTask = Kernel_Current;
+    Kernel_ReadyRemove(pTask);
+    pTask->State = KERNEL_TASK_DELAYED;
+    pTask->WakeTick = Kernel_Tick + Ticks;
+    Kernel_RequestSwitch();
+    Kernel_PortExitCritical(State);
+}
+
+/**
+ * @brief This function gets the number of ticks since Kernel_Start.
+ *
+ * @return uint32_t
+ */
+uint32_t Kernel_GetTick(void)
+{
+    return Kernel_Tick;
+}
+
+/**
+ * @brief This function gets the running task.
+ *
+ * @return Kernel_Task_t*
+ */
+Kernel_Task_t * Kernel_GetCurrent(void)
+{
+    return Kernel_Current;
+}
+
+/**
+ * @brief This function sets the function run by PendSV before each context switch.
+ *        PendSV is shared: the deferred work (WorkQueue_IRQHandling) keeps running when the kernel owns it.
+ *
+ * @param Hook Function to be called from PendSV, NULL to remove it
+ */
+void Kernel_SetPendSVHook(void (*Hook)(void))
+{
+    Kernel_PendSVHook = Hook;
+}
+
+/**
+ * @brief This function initializes a counting semaphore.
+ *
+ * @param pSem Pointer to the semaphore
+ * @param Count Initial number of units
+ */
+void Kernel_SemInit(Kernel_Sem_t * pSem, uint32_t Count)
+{
+    pSem->Count = Count;
+    pSem->WaitList = NULL;
+}
+
+/**
+ * @brief This function takes a unit of a semaphore, waiting for it if needed.
+ *        The interrupts can only use KERNEL_NO_WAIT.
+ *
+ * @param pSem Pointer to the semaphore
+ * @param Timeout Maximum wait in ticks, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+ *
+ * @return uint8_t TRUE if a unit was taken, FALSE on timeout
+ */
+uint8_t Kernel_SemTake(Kernel_Sem_t * pSem, uint32_t Timeout)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+
+    State = Kernel_PortEnterCritical();
+    if (pSem->Count > 0U)
+    {
+        pSem->Count--;
+        Kernel_PortExitCritical(State);
+        return TRUE;
+    }
+    if ((Timeout == KERNEL_NO_WAIT) || (Kernel_Started == FALSE))
+    {
+        Kernel_PortExitCritical(State);
+        return FALSE;
+    }
+    pTask = Kernel_Current;
+    Kernel_ReadyRemove(pTask);
+    pTask->State = KERNEL_TASK_BLOCKED;
+    pTask->WaitResult = FALSE;
+    Kernel_WaitInsert(pSem, pTask);
+    if (Timeout != KERNEL_WAIT_FOREVER)
+    {
+        pTask->Timed = TRUE;
+        pTask->WakeTick = Kernel_Tick + Timeout;
+    }
+    Kernel_RequestSwitch();
+    Kernel_PortExitCritical(State);
+    /*Woken up by Kernel_SemGive (the unit is handed over) or by the timeout*/
+    return pTask->WaitResult;
+}
+
+/**
+ * @brief This function gives a unit of a semaphore, the highest priority waiting task gets it.
+ *        It can be called from a task or from an interrupt.
+ *
+ * @param pSem Pointer to the semaphore
+ */
+void Kernel_SemGive(Kernel_Sem_t * pSem)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+
+    State = Kernel_PortEnterCritical();
+    pTask = pSem->WaitList;
+    if (pTask == NULL)
+    {
+        pSem->Count++;
+    }
+    else
+    {
+        pSem->WaitList = pTask->Next;
+        pTask->WaitObject = NULL;
+        pTask->WaitResult = TRUE;
+        Kernel_ReadyInsert(pTask);
+        if (pTask->Priority < Kernel_Current->Priority)
+        {
+            Kernel_RequestSwitch();
+        }
+    }
+    Kernel_PortExitCritical(State);
+}
+
+/**
+ * @brief This function initializes a message queue.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Buffer Storage of Capacity * ItemSize bytes
+ * @param ItemSize Item size in bytes
+ * @param Capacity Number of items
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+uint8_t Kernel_QueueInit(Kernel_Queue_t * pQueue, void * Buffer, uint16_t ItemSize, uint16_t Capacity)
+{
+    if ((Buffer == NULL) || (ItemSize == 0U) || (Capacity == 0U))
+    {
+        return FALSE;
+    }
+    pQueue->Buffer   = (uint8_t *)Buffer;
+    pQueue->ItemSize = ItemSize;
+    pQueue->Capacity = Capacity;
+    pQueue->Head     = 0U;
+    pQueue->Count    = 0U;
+    Kernel_SemInit(&pQueue->Items, 0U);
+    Kernel_SemInit(&pQueue->Spaces, Capacity);
+    return TRUE;
+}
+
+/**
+ * @brief This function copies an item at the end of a message queue, waiting for a free item if needed.
+ *        The interrupts can only use KERNEL_NO_WAIT.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Item Item to be copied (ItemSize bytes)
+ * @param Timeout Maximum wait in ticks, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+ *
+ * @return uint8_t TRUE if the item was queued, FALSE on timeout
+ */
+uint8_t Kernel_QueueSend(Kernel_Queue_t * pQueue, const void * Item, uint32_t Timeout)
+{
+    uint8_t * pDst;
+    uint32_t State;
+    uint16_t i;
+
+    if (Kernel_SemTake(&pQueue->Spaces, Timeout) == FALSE)
+    {
+        return FALSE;
+    }
+    State = Kernel_PortEnterCritical();
+    pDst = &pQueue->Buffer[((pQueue->Head + pQueue->Count) % pQueue->Capacity) * pQueue->ItemSize];
+    for (i = 0U; i < pQueue->ItemSize; i++)
+    {
+        pDst[i] = ((const uint8_t *)Item)[i];
+    }
+    pQueue->Count++;
+    Kernel_PortExitCritical(State);
+    Kernel_SemGive(&pQueue->Items);
+    return TRUE;
+}
+
+/**
+ * @brief This function copies and removes the oldest item of a message queue, waiting for an item if needed.
+ *        The interrupts can only use KERNEL_NO_WAIT.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Item Destination (ItemSize bytes)
+ * @param Timeout Maximum wait in ticks, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+ *
+ * @return uint8_t TRUE if an item was received, FALSE on timeout
+ */
+uint8_t Kernel_QueueReceive(Kernel_Queue_t * pQueue, void * Item, uint32_t Timeout)
+{
+    const uint8_t * pSrc;
+    uint32_t State;
+    uint16_t i;
+
+    if (Kernel_SemTake(&pQueue->Items, Timeout) == FALSE)
+    {
+        return FALSE;
+    }
+    State = Kernel_PortEnterCritical();
+    pSrc = &pQueue->Buffer[pQueue->Head * pQueue->ItemSize];
+    for (i = 0U; i < pQueue->ItemSize; i++)
+    {
+        ((uint8_t *)Item)[i] = pSrc[i];
+    }
+    pQueue->Head = (pQueue->Head + 1U) % pQueue->Capacity;
+    pQueue->Count--;
+    Kernel_PortExitCritical(State);
+    Kernel_SemGive(&pQueue->Spaces);
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the kernel statistics.
+ *
+ * @return const Kernel_Stats_t*
+ */
+const Kernel_Stats_t * Kernel_GetStats(void)
+{
+    return &Kernel_Stats;
+}
+
+/**
+ * @brief This function gets the CPU usage of a task since Kernel_Start.
+ *
+ * @param pTask Pointer to the task
+ *
+ * @return uint32_t CPU usage in per mille
+ */
+uint32_t Kernel_GetTaskLoad(const Kernel_Task_t * pTask)
+{
+    if (Kernel_Stats.TotalCycles == 0U)
+    {
+        return 0U;
+    }
+    return (uint32_t)((pTask->RunCycles * 1000U) / Kernel_Stats.TotalCycles);
+}
+
+/**
+ * @brief This function gets the number of stack words never used by a task (stack high water mark).
+ *
+ * @param pTask Pointer to the task
+ *
+ * @return uint32_t
+ */
+uint32_t Kernel_GetStackFree(const Kernel_Task_t * pTask)
+{
+    uint32_t i = 0U;
+
+    /*The stack grows down from Stack + StackSize*/
+    while ((i < pTask->StackSize) && (pTask->Stack[i] == KERNEL_STACK_FILL))
+    {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief This function handles a tick, it is called by the port tick interrupt.
+ *        It wakes the delayed tasks and the timed out waits up and rotates the time slices.
+ *
+ */
+void Kernel_TickHandler(void)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+    uint8_t Switch = FALSE;
+
+    State = Kernel_PortEnterCritical();
+    Kernel_Tick++;
+    for (pTask = Kernel_AllTasks; pTask != NULL; pTask = pTask->AllNext)
+    {
+        if (((pTask->State == KERNEL_TASK_DELAYED) || ((pTask->State == KERNEL_TASK_BLOCKED) && (pTask->Timed == TRUE)))
+            && ((int32_t)(Kernel_Tick - pTask->WakeTick) >= 0))
+        {
+            if (pTask->State == KERNEL_TASK_BLOCKED)
+            {
+                Kernel_WaitRemove((Kernel_Sem_t *)pTask->WaitObject, pTask);
+                pTask->WaitResult = FALSE;
+            }
+            Kernel_ReadyInsert(pTask);
+            if (pTask->Priority < Kernel_Current->Priority)
+            {
+                Switch = TRUE;
+            }
+        }
+    }
+
+    /*Round robin between the ready tasks of the running priority*/
+    pTask = Kernel_Current;
+    if ((pTask->State == KERNEL_TASK_READY) && (pTask->Next != pTask))
+    {
+        pTask->Slice--;
+        if (pTask->Slice == 0U)
+        {
+            pTask->Slice = KERNEL_TIME_SLICE;
+            Kernel_ReadyList[pTask->Priority] = pTask->Next;
+            Switch = TRUE;
+        }
+    }
+    if (Switch == TRUE)
+    {
+        Kernel_RequestSwitch();
+    }
+    Kernel_PortExitCritical(State);
+}
+
+/**
+ * @brief This function selects the next task, it is called by the port context switch.
+ *        It charges the elapsed cycles to the task being switched out.
+ *
+ */
+void Kernel_SwitchContext(void)
+{
+    Kernel_Task_t * pNext;
+    uint32_t Now, Elapsed, Latency;
+
+    Now = Kernel_PortCycles();
+    Elapsed = Now - Kernel_SwitchStamp;
+    Kernel_SwitchStamp = Now;
+    if (Kernel_Current != &Kernel_BootTask)
+    {
+        Kernel_Current->RunCycles += Elapsed;
+        Kernel_Stats.TotalCycles += Elapsed;
+    }
+    if (Kernel_SwitchRequested == TRUE)
+    {
+        Kernel_SwitchRequested = FALSE;
+        Latency = Now - Kernel_RequestStamp;
+        Kernel_Stats.LastSwitchLatency = Latency;
+        if (Latency > Kernel_Stats.MaxSwitchLatency)
+        {
+            Kernel_Stats.MaxSwitchLatency = Latency;
+        }
+    }
+
+    /*The idle task is always ready*/
+    pNext = Kernel_ReadyList[__builtin_ctz(Kernel_ReadyMask)];
+    if (pNext != Kernel_Current)
+    {
+        Kernel_Stats.SwitchCount++;
+        pNext->SwitchCount++;
+        Kernel_Current = pNext;
+    }
+}
+
+/**
+ * @brief This function runs the PendSV hook, it is called by the port PendSV handler.
+ *
+ */
+void Kernel_RunPendSVHook(void)
+{
+    if (Kernel_PendSVHook != NULL)
+    {
+        Kernel_PendSVHook();
+    }
+}
+
+/**
+ * @brief This function is run when a task function returns, the task becomes dormant.
+ *
+ */
+void Kernel_TaskExit(void)
+{
+    Kernel_Task_t * pTask;
+    uint32_t State;
+
+    State = Kernel_PortEnterCritical();
+    pTask = Kernel_Current;
+    Kernel_ReadyRemove(pTask);
+    pTask->State = KERNEL_TASK_DORMANT;
+    Kernel_RequestSwitch();
+    Kernel_PortExitCritical(State);
+    while (1)
+    {
+        /*Not reached, the task is never switched in again*/
+    }
+}
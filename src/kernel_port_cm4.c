@@ -0,0 +1,180 @@
+#include "kernel_port.h"
+
+#if !defined(KERNEL_PORT_HOST)
+#include "systick.h"
+
+/*PendSV runs at the lowest priority, the context switch never preempts an interrupt*/
+#define KERNEL_PORT_PRIORITY        0x0FU
+/*BASEPRI value of the kernel critical sections, written as an immediate by PendSV_Handler*/
+#define KERNEL_PORT_BASEPRI         (KERNEL_SYSCALL_PRIORITY << (8U - NVIC_PRIO_BITS))
+_Static_assert(KERNEL_PORT_BASEPRI == 0x10U, "PendSV_Handler masks BASEPRI with 0x10");
+/*EXC_RETURN of a new task: thread mode, PSP, no FP context*/
+#define KERNEL_PORT_EXC_RETURN      0xFFFFFFFDUL
+/*Initial xPSR of a task, Thumb state*/
+#define KERNEL_PORT_XPSR            0x01000000UL
+/*Stack used by the code calling Kernel_Start until the first switch, its context is saved there and dropped*/
+#define KERNEL_PORT_BOOT_STACK      32U
+
+/*Set by Kernel_PortStart, PendSV only switches the context once the kernel runs*/
+static volatile uint8_t Kernel_PortRunning __attribute__((used)) = FALSE;
+static uint32_t Kernel_PortBootStack[KERNEL_PORT_BOOT_STACK] __attribute__((aligned(8)));
+
+/**
+ * @brief This function builds the initial stack frame of a task, as saved by PendSV_Handler.
+ *        From the saved stack pointer up: r4-r11, EXC_RETURN, then the hardware frame r0-r3, r12, lr, pc, xPSR.
+ *
+ * @param pTask Pointer to the task
+ */
+void Kernel_PortInitStack(Kernel_Task_t * pTask)
+{
+    uint32_t * pSp;
+
+    /*The AAPCS requires an 8 byte aligned stack*/
+    pSp = (uint32_t *)((uint32_t)&pTask->Stack[pTask->StackSize] & ~0x07UL);
+    *(--pSp) = KERNEL_PORT_XPSR;
+    *(--pSp) = (uint32_t)pTask->Entry & ~0x01UL;        /*pc*/
+    *(--pSp) = (uint32_t)Kernel_TaskExit;              /*lr, run when the task function returns*/
+    *(--pSp) = 0U;                                      /*r12*/
+    *(--pSp) = 0U;                                      /*r3*/
+    *(--pSp) = 0U;                                      /*r2*/
+    *(--pSp) = 0U;                                      /*r1*/
+    *(--pSp) = (uint32_t)pTask->Arg;                    /*r0*/
+    *(--pSp) = KERNEL_PORT_EXC_RETURN;
+    pSp -= 8U;                                          /*r4-r11*/
+    pTask->Sp = pSp;
+}
+
+/**
+ * @brief This function starts the tick and switches to the first task, it never returns.
+ *        The cycle counter (DWT) must run, Timebase_Init starts it. SysTick is started at KERNEL_TICK_HZ
+ *        unless it already runs at this rate.
+ *
+ */
+void Kernel_PortStart(void)
+{
+    /*PendSV priority, it is shared with the work queue which sets the same value*/
+    SCB->SHPR[2] &= ~(0xFFU << SCB_SHPR3_PRI_PENDSV);
+    SCB->SHPR[2] |= ((KERNEL_PORT_PRIORITY << (8U - NVIC_PRIO_BITS)) << SCB_SHPR3_PRI_PENDSV);
+    /*Lazy stacking: the FP registers are saved only for the tasks using the FPU, and only if needed*/
+    FPU_FPCCR |= (0x01UL << FPU_FPCCR_ASPEN) | (0x01UL << FPU_FPCCR_LSPEN);
+
+    /*The kernel tick is a SysTick hook, the other hooks keep running*/
+    if (SysTick_GetRate() != KERNEL_TICK_HZ)
+    {
+        SysTick_Init(KERNEL_TICK_HZ, KERNEL_PORT_PRIORITY);
+    }
+    SysTick_RegisterHook(Kernel_TickHandler);
+
+    /*The first PendSV saves the boot context on the boot stack, the interrupts keep using MSP*/
+    __asm volatile ("msr psp, %0" :: "r" (&Kernel_PortBootStack[KERNEL_PORT_BOOT_STACK]) : "memory");
+    Kernel_PortRunning = TRUE;
+    SCB->ICSR = (0x01U << SCB_ICSR_PENDSVSET);
+    CM4_DSB();
+    CM4_ISB();
+    CM4_ENABLE_IRQ();
+    while (1)
+    {
+        /*Not reached, the boot context is never switched in again*/
+    }
+}
+
+/**
+ * @brief This function requests a context switch, PendSV runs it when no other interrupt is active.
+ *
+ */
+void Kernel_PortRequestSwitch(void)
+{
+    SCB->ICSR = (0x01U << SCB_ICSR_PENDSVSET);
+}
+
+/**
+ * @brief This function enters a kernel critical section, the interrupts of priority KERNEL_SYSCALL_PRIORITY
+ *        and lower are masked (BASEPRI), the higher ones are never delayed by the kernel.
+ *
+ * @return uint32_t State given back to Kernel_PortExitCritical
+ */
+uint32_t Kernel_PortEnterCritical(void)
+{
+    return CM4_BasePriSave(KERNEL_SYSCALL_PRIORITY);
+}
+
+/**
+ * @brief This function leaves a kernel critical section.
+ *
+ * @param State Value returned by Kernel_PortEnterCritical
+ */
+void Kernel_PortExitCritical(uint32_t State)
+{
+    CM4_BasePriRestore(State);
+}
+
+/**
+ * @brief This function gets the core cycle counter, used for the CPU time and the switch latency.
+ *
+ * @return uint32_t
+ */
+uint32_t Kernel_PortCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief This function is the idle task body, the core sleeps until the next interrupt.
+ *
+ */
+void Kernel_PortIdle(void)
+{
+    CM4_WFI();
+}
+
+#if (KERNEL_ENABLE == 1)
+/**
+ * @brief This is the exception handler for PendSV (deferred work and context switch).
+ *        The hook runs first, then the context of the running task is saved on its stack (r4-r11, EXC_RETURN and
+ *        s16-s31 if the task used the FPU, the hardware already stacked the rest) and the next task is restored.
+ *
+ */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile
+    (
+        "push    {r0, lr}               \n"
+        "bl      Kernel_RunPendSVHook   \n"
+        "pop     {r0, lr}               \n"
+        "ldr     r3, =Kernel_PortRunning\n"
+        "ldrb    r3, [r3]               \n"
+        "cbnz    r3, 1f                 \n"
+        "bx      lr                     \n"
+        "1:                             \n"
+        /*Save the running task*/
+        "ldr     r3, =Kernel_Current    \n"
+        "ldr     r2, [r3]               \n"
+        "mrs     r0, psp                \n"
+        "tst     lr, #0x10              \n"
+        "it      eq                     \n"
+        "vstmdbeq r0!, {s16-s31}        \n"
+        "stmdb   r0!, {r4-r11, lr}      \n"
+        "str     r0, [r2]               \n"
+        /*Select the next task with the kernel calls masked*/
+        "movs    r0, #0x10              \n"
+        "msr     basepri, r0            \n"
+        "dsb                            \n"
+        "isb                            \n"
+        "bl      Kernel_SwitchContext   \n"
+        "movs    r0, #0                 \n"
+        "msr     basepri, r0            \n"
+        /*Restore the next task*/
+        "ldr     r3, =Kernel_Current    \n"
+        "ldr     r2, [r3]               \n"
+        "ldr     r0, [r2]               \n"
+        "ldmia   r0!, {r4-r11, lr}      \n"
+        "tst     lr, #0x10              \n"
+        "it      eq                     \n"
+        "vldmiaeq r0!, {s16-s31}        \n"
+        "msr     psp, r0                \n"
+        "isb                            \n"
+        "bx      lr                     \n"
+    );
+}
+#endif
+#endif
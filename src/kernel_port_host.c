@@ -0,0 +1,201 @@
+#include "kernel_port.h"
+
+#if defined(KERNEL_PORT_HOST)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+
+/*  Host simulation port (Linux), to test the scheduling without the board.
+    - Each task runs on a ucontext with its own host stack (the task stack is only filled, libc needs more).
+    - The ticks are simulated: the idle task gives one tick per loop, a busy task calls Kernel_PortSimTick to let
+      the time pass. Kernel_PortSimRun runs the tasks for a number of ticks and returns to the test.
+    - Everything runs on one host thread, the critical sections are empty.
+    Build with KERNEL_PORT_HOST, without kernel_port_cm4.c, e.g, the scheduling test (test/test_kernel.c):
+        gcc -std=gnu11 -Wall -Iheader -DKERNEL_PORT_HOST test/test_kernel.c src/kernel.c src/kernel_port_host.c */
+
+#define KERNEL_HOST_TASK_MAX        16U
+#define KERNEL_HOST_STACK_SIZE      65536U
+
+static ucontext_t Kernel_HostMainCtx;
+static ucontext_t Kernel_HostCtx[KERNEL_HOST_TASK_MAX];
+static uint8_t Kernel_HostStack[KERNEL_HOST_TASK_MAX][KERNEL_HOST_STACK_SIZE];
+static uint32_t Kernel_HostTaskNum = 0U;
+/*TRUE while the tasks run (between Kernel_PortSimRun and its return)*/
+static uint8_t Kernel_HostRunning = FALSE;
+/*TRUE while the simulated tick interrupt runs, the switch requests are then deferred to its end*/
+static uint8_t Kernel_HostInTick = FALSE;
+static uint8_t Kernel_HostSwitchPending = FALSE;
+static uint32_t Kernel_HostTicksLeft = 0U;
+
+/**
+ * @brief This function is the entry of every task context.
+ *
+ */
+static void Kernel_HostTaskEntry(void)
+{
+    Kernel_Task_t * pTask = Kernel_Current;
+
+    pTask->Entry(pTask->Arg);
+    Kernel_TaskExit();
+}
+
+/**
+ * @brief This function selects the next task and switches to it, it returns when the calling task runs again.
+ *
+ */
+static void Kernel_HostSwitch(void)
+{
+    Kernel_Task_t * pPrev = Kernel_Current;
+
+    Kernel_HostSwitchPending = FALSE;
+    Kernel_SwitchContext();
+    if (Kernel_Current != pPrev)
+    {
+        swapcontext((ucontext_t *)pPrev->PortData, (ucontext_t *)Kernel_Current->PortData);
+    }
+}
+
+/**
+ * @brief This function creates the host context of a task.
+ *
+ * @param pTask Pointer to the task
+ */
+void Kernel_PortInitStack(Kernel_Task_t * pTask)
+{
+    ucontext_t * pCtx;
+
+    if (Kernel_HostTaskNum >= KERNEL_HOST_TASK_MAX)
+    {
+        fprintf(stderr, "kernel host port: more than %u tasks\n", KERNEL_HOST_TASK_MAX);
+        abort();
+    }
+    pCtx = &Kernel_HostCtx[Kernel_HostTaskNum];
+    getcontext(pCtx);
+    pCtx->uc_stack.ss_sp = Kernel_HostStack[Kernel_HostTaskNum];
+    pCtx->uc_stack.ss_size = KERNEL_HOST_STACK_SIZE;
+    pCtx->uc_link = NULL;
+    makecontext(pCtx, Kernel_HostTaskEntry, 0);
+    Kernel_HostTaskNum++;
+    pTask->PortData = pCtx;
+    pTask->Sp = NULL;
+}
+
+/**
+ * @brief This function returns at once on the host, Kernel_PortSimRun runs the tasks.
+ *
+ */
+void Kernel_PortStart(void)
+{
+    Kernel_HostRunning = FALSE;
+}
+
+/**
+ * @brief This function switches the context at once from a task, at the end of the tick from the tick handler,
+ *        and on the next Kernel_PortSimRun from the test code.
+ *
+ */
+void Kernel_PortRequestSwitch(void)
+{
+    if ((Kernel_HostRunning == FALSE) || (Kernel_HostInTick == TRUE))
+    {
+        Kernel_HostSwitchPending = TRUE;
+    }
+    else
+    {
+        Kernel_HostSwitch();
+    }
+}
+
+/**
+ * @brief This function enters a kernel critical section, nothing to do on one host thread.
+ *
+ * @return uint32_t
+ */
+uint32_t Kernel_PortEnterCritical(void)
+{
+    return 0U;
+}
+
+/**
+ * @brief This function leaves a kernel critical section, nothing to do on one host thread.
+ *
+ * @param State Not used
+ */
+void Kernel_PortExitCritical(uint32_t State)
+{
+    (void)State;
+}
+
+/**
+ * @brief This function gets the host monotonic time in nanoseconds, used as the cycle counter.
+ *
+ * @return uint32_t
+ */
+uint32_t Kernel_PortCycles(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint32_t)((uint64_t)Now.tv_sec * 1000000000U + (uint64_t)Now.tv_nsec);
+}
+
+/**
+ * @brief This function is the idle task body, the time passes by one tick.
+ *
+ */
+void Kernel_PortIdle(void)
+{
+    Kernel_PortSimTick();
+}
+
+/**
+ * @brief This function simulates a tick interrupt in the running task, it can preempt it.
+ *        The simulation returns to the test when its ticks are over.
+ *
+ */
+void Kernel_PortSimTick(void)
+{
+    Kernel_HostInTick = TRUE;
+    Kernel_TickHandler();
+    Kernel_HostInTick = FALSE;
+
+    if (Kernel_HostTicksLeft > 0U)
+    {
+        Kernel_HostTicksLeft--;
+    }
+    if (Kernel_HostTicksLeft == 0U)
+    {
+        /*Resumed here by the next Kernel_PortSimRun*/
+        Kernel_HostRunning = FALSE;
+        swapcontext((ucontext_t *)Kernel_Current->PortData, &Kernel_HostMainCtx);
+    }
+    if (Kernel_HostSwitchPending == TRUE)
+    {
+        Kernel_HostSwitch();
+    }
+}
+
+/**
+ * @brief This function runs the tasks for the given number of ticks, then returns to the caller.
+ *        Kernel_Start must have been called.
+ *
+ * @param Ticks Number of simulated ticks
+ */
+void Kernel_PortSimRun(uint32_t Ticks)
+{
+    if (Ticks == 0U)
+    {
+        return;
+    }
+    Kernel_HostTicksLeft = Ticks;
+    /*First run, or a switch requested by the test code*/
+    if ((Kernel_Current->PortData == NULL) || (Kernel_HostSwitchPending == TRUE))
+    {
+        Kernel_HostSwitchPending = FALSE;
+        Kernel_SwitchContext();
+    }
+    Kernel_HostRunning = TRUE;
+    swapcontext(&Kernel_HostMainCtx, (ucontext_t *)Kernel_Current->PortData);
+}
+#endif
@@ -1,154 +1,342 @@
 #include "stm32f407xx_gpio_driver.h"
 #include "stm32f407xx_usart_driver.h"
 #include "stm32f407xx_timer_driver.h"
-#include <string.h>
-#include <stdlib.h>
+#include "board.h"
+#include "ring_buffer.h"
+#include "dino_protocol.h"
+#include "debounce.h"
+#include "buttons.h"
+#include "timebase.h"
+#include "soft_timer.h"
+#include "systick.h"
+#include "idle.h"
+#include "work_queue.h"
+#include "event.h"
+#include "kernel.h"
 
-void delayms(uint32_t miliseconds)
-{
-    uint32_t i;
-
-    for (i = 0; i < miliseconds*100000; i++)
-    {
-        /*Do nothing*/
-    }
-}
-/*Configure GPIOD pin number 12 as an output pin*/
-GPIO_PinConf_t GPIOD_PinConf;
-/*Configure GPIOA pin number 0 as an output pin*/
-GPIO_PinConf_t GPIOA_PinConf;
 /*Configure USART3 for comunication*/
 USART_Conf_t USART3_Conf;
-/*Configure TIM6 for time base*/
-TIM_Base_Conf_t TIM6_Conf;
+/*Configure the clock tree: 168 MHz system clock from the 8 MHz HSE*/
+RCC_ClkConf_t RCC_Conf =
+{
+    .SysClkSource   = RCC_SYSCLK_PLL,
+    .PLLSource      = RCC_PLLSOURCE_HSE,
+    .PLLM           = 8U,                   /*1 MHz PLL input*/
+    .PLLN           = 336U,                 /*336 MHz VCO*/
+    .PLLP           = 2U,                   /*168 MHz system clock*/
+    .PLLQ           = 7U,                   /*48 MHz USB/SDIO/RNG clock*/
+    .AHBPrescaler   = RCC_AHB_DIV1,         /*168 MHz HCLK*/
+    .APB1Prescaler  = RCC_APB_DIV4,         /*42 MHz PCLK1, 84 MHz APB1 timer clock*/
+    .APB2Prescaler  = RCC_APB_DIV2,         /*84 MHz PCLK2, 168 MHz APB2 timer clock*/
+};
 /*Configure TIM4 for time base*/
 TIM_Base_Conf_t TIM4_Conf;
 TIM_OC_Conf_t TIM4_OC_Conf;
 
-#define RX_BUFFER_SIZE  8U
-#define TX_BUFFER_SIZE  8U
-#define BUTTON_DEBOUNCE_TIME    100U
-volatile uint8_t ReceivedMess[RX_BUFFER_SIZE];
-volatile uint8_t TransmitMess[TX_BUFFER_SIZE]   = "J\n";
-volatile uint8_t TransmitMessSize               = 2U;
-volatile uint8_t RxData                         = 0U;
-volatile uint8_t RxIndex                        = 0U;
-volatile uint8_t IsRxAvailable                  = FALSE;
-volatile uint16_t Timer6DelayCounter = 0U;
+#define RX_DMA_BUFFER_SIZE      64U
+#define RX_QUEUE_SIZE           128U    /*Must be a power of two*/
+#define BUTTON_LOCKOUT_TIME     20U     /*Press lockout and release stable time of the jump button in ms*/
+#define BUTTON_EVENT_QUEUE_SIZE 16U     /*Events of the sampled buttons, must be a power of two*/
+/*Jump button mode*/
+#define BUTTON_MODE_EXTI        0U      /*EXTI0 interrupt on PA0, debounced by lockout (1ms software timer)*/
+#define BUTTON_MODE_CAPTURE     1U      /*TIM5 CH1/CH2 input capture on PA0, filtered by the hardware*/
+#define BUTTON_MODE_SAMPLED     2U      /*PA0 sampled on each SysTick tick by the buttons module, no TELEMETRY frame*/
+#define BUTTON_MODE             BUTTON_MODE_EXTI
+/*Time without activity in ms before the idle loop uses STOP instead of SLEEP.
+  STOP saves most of the power but adds the clock restore time (about 1 ms) to the first press and
+  loses the first frame received, 0 keeps the core in SLEEP only.*/
+#define IDLE_STOP_DELAY         5000U
+/*Global tick rate in Hz (1 tick = 1 ms)*/
+#define SYSTICK_RATE            1000U
+/*Interrupt priorities (4 bits of preemption priority), the priority 0 is left free.
+  The jump button, USART3 and its RX DMA share one priority: the producers of the USART3 frames never preempt
+  each other and USART_Transmit_IT only masks them (BASEPRI) while it queues a frame.*/
+#define IRQ_PRIORITY_LINK       1U
+#define IRQ_PRIORITY_TIMERS     2U      /*Time base wakeups and software timers (debounce ticks)*/
+/*Board pins*/
+#define LED_GREEN_PIN           GPIO_PIN_NUM_12     /*PD12, toggled on each press*/
+#define TIM4_CH4_PIN            GPIO_PIN_NUM_15     /*PD15, blue LED*/
+#define JUMP_BUTTON_PIN         GPIO_PIN_NUM_0      /*PA0, user button, active high*/
+#define USART3_TX_PIN           GPIO_PIN_NUM_10     /*PB10*/
+/*USART3 RX pin, its falling edge (start bit) wakes the core from STOP on the EXTI line 11*/
+#define USART3_RX_PIN           GPIO_PIN_NUM_11
+/*Board bring-up tables, applied by Board_Init*/
+static const Board_ClockDesc_t Board_Clocks[] =
+{
+    {BOARD_BUS_APB1, RCC_APB1ENR_TIM4EN},
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+    {BOARD_BUS_APB1, RCC_APB1ENR_TIM5EN},
+#endif
+    {BOARD_BUS_APB1, RCC_APB1ENR_USART3EN},
+    {BOARD_BUS_AHB1, RCC_AHB1ENR_DMA1EN},
+};
+static const Board_PinDesc_t Board_Pins[] =
+{
+    /*Port          Pin              Mode              OutType      PUPD          Speed              AltFunc*/
+    {BOARD_PORT_D, LED_GREEN_PIN,   GPIO_MODE_OUTPUT, GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_LOW,    GPIO_ALT_AF0},
+    {BOARD_PORT_D, TIM4_CH4_PIN,    GPIO_MODE_ALT,    GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_LOW,    GPIO_ALT_AF2},
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+    {BOARD_PORT_A, JUMP_BUTTON_PIN, GPIO_MODE_ALT,    GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_LOW,    GPIO_ALT_AF2},
+#else
+    {BOARD_PORT_A, JUMP_BUTTON_PIN, GPIO_MODE_INPUT,  GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_LOW,    GPIO_ALT_AF0},
+#endif
+    {BOARD_PORT_B, USART3_TX_PIN,   GPIO_MODE_ALT,    GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_MEDIUM, GPIO_ALT_AF7},
+    {BOARD_PORT_B, USART3_RX_PIN,   GPIO_MODE_ALT,    GPIO_OUT_PP, GPIO_NO_PUPD, GPIO_SPEED_MEDIUM, GPIO_ALT_AF7},
+};
+/*The EXTI0 priority is the USART3 one, so the EXTI0 interrupt and the USART3 transmission complete callback never
+  preempt each other when they queue frames. The EXTI line 11 follows the RX pin in alternate function mode too,
+  the idle manager only unmasks it in STOP. The GPIO driver owns the EXTI vectors and calls the line callbacks.*/
+static const Board_ExtiDesc_t Board_Extis[] =
+{
+#if (BUTTON_MODE == BUTTON_MODE_EXTI)
+    {BOARD_PORT_A, JUMP_BUTTON_PIN, GPIO_IT_EDGE_RT, IRQ_PRIORITY_LINK},
+#endif
+    {BOARD_PORT_B, USART3_RX_PIN,   GPIO_IT_EDGE_FT, IRQ_PRIORITY_LINK},
+};
+static const Board_Conf_t Board_Conf =
+{
+    .pClocks  = Board_Clocks,
+    .ClockNum = BOARD_TABLE_SIZE(Board_Clocks),
+    .pPins    = Board_Pins,
+    .PinNum   = BOARD_TABLE_SIZE(Board_Pins),
+    .pExtis   = Board_Extis,
+    .ExtiNum  = BOARD_TABLE_SIZE(Board_Extis),
+};
+/*Encoded JUMP frame, built once at start up*/
+uint8_t TransmitMess[DINO_PROTO_MAX_FRAME];
+uint8_t TransmitMessSize                        = 0U;
+/*Encoded TELEMETRY frame: last latency (us), max latency (us), presses, release bounces*/
+uint8_t TelemetryMess[DINO_PROTO_MAX_FRAME];
+/*Press to TX latency of the JUMP frame, from the EXTI edge to the end of the transmission.
+  At 9600 baud about 4.2 ms of it is the transmission of the 4 bytes frame.*/
+volatile uint8_t JumpLatencyPending             = FALSE;
+volatile uint32_t JumpLatencyLastUs             = 0U;
+volatile uint32_t JumpLatencyMaxUs              = 0U;
+/*Encoded POWER frame: sleep time (ms), STOP count, last and max wake latency (us), sent after each TELEMETRY*/
+uint8_t PowerMess[DINO_PROTO_MAX_FRAME];
+volatile uint8_t PowerReportPending             = FALSE;
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+/*Jump button captured by TIM5*/
+Debounce_Capture_t JumpButton;
+#endif
+#if (BUTTON_MODE == BUTTON_MODE_SAMPLED)
+/*Events of the sampled buttons, produced by Buttons_Tick and consumed by the SysTick hook*/
+uint8_t ButtonEventStorage[BUTTON_EVENT_QUEUE_SIZE];
+RingBuf_t ButtonEventQueue;
+#endif
+/*Circular buffer filled by DMA1 stream 1 with the bytes received by USART3*/
+uint8_t RxDMABuffer[RX_DMA_BUFFER_SIZE];
+/*Queue of received bytes, produced by the USART3 reception interrupts and consumed by the deferred decoder*/
+uint8_t RxQueueStorage[RX_QUEUE_SIZE];
+RingBuf_t RxQueue;
+/*Decoder of the frames sent by the game*/
+DinoProto_Decoder_t RxDecoder;
+/*Last score sent by the game*/
+uint32_t GameScore                              = 0U;
 
 
 /**
- * @brief   This function initializes timer 6 as specific configuration
- *          The timer 6 is used to generate delay in this project
- *          The timer period is 1ms
+ * @brief   This function initializes timer 4 channel 4 to used in output compare mode
+ *          The prescaler is derived from the current timer clock
  * 
  */
-void TIM6_Init(void)
+void TIM4_OC_Init(void)
 {
-    TIM6_Conf.AutoReloadPreload = ENABLE;   
-    TIM6_Conf.Period = 999;                 /*1ms period*/
-    TIM6_Conf.Prescaler = 15;               /*Counter clock is 1Mhz (with 16 Mhz timer clock)*/
-    TIM6_CLK_ENB();
-    TIM_Base_Init(TIM6, TIM6_Conf);
-    TIM_Base_ForceUpdate(TIM6);
+    /*Timer 4 configuration, the PD15 pin and the clock are set by Board_Init*/
+    /*Timer base init*/
+    TIM4_Conf.AutoReloadPreload = ENABLE;
+    TIM4_Conf.Period            = 999;      /*1ms period*/
+    TIM4_Conf.CounterClock      = 1000000U; /*Counter clock is 1Mhz*/
+    TIM4_Conf.CounterMode       = TIM_UPCOUNTING;
+    TIM_Base_Init(TIM4, TIM4_Conf);
 
+    /*Output compare init*/
+    TIM4_OC_Conf.OCMode         = TIM_OCMODE_PWM1;
+    TIM4_OC_Conf.OCPolarity     = TIM_OCPOLARITY_HIGH;
+    TIM4_OC_Conf.Pulse          = 0;
+    TIM_OC_Init(TIM4, TIM4_OC_Conf, TIM_OC_CHANNEL_4);
 }
 
 /**
- * @brief   This function is used to start timer 6
+ * @brief This function is used to start timer 4
  * 
  */
-void TIM6_Start(void)
+void TIM4_Start(void)
 {
-    TIM_Base_Start(TIM6);
+    TIM_Base_Start(TIM4);
 }
 
+
 /**
- * @brief   This function is used to stop timer 6
+ * @brief This function appends a uint32 in little endian order.
  * 
+ * @param Buffer Destination
+ * @param Value Value to be written
  */
-void TIM6_Stop(void)
+static void PutU32LE(uint8_t * Buffer, uint32_t Value)
 {
-    TIM_Base_Stop(TIM6);
+    Buffer[0] = (uint8_t)Value;
+    Buffer[1] = (uint8_t)(Value >> 8);
+    Buffer[2] = (uint8_t)(Value >> 16);
+    Buffer[3] = (uint8_t)(Value >> 24);
 }
 
 /**
- * @brief   This function is used to initialize timer 6 interrupt
- *          Priority is set to 1
+ * @brief This function is called from the USART3 interrupt when all queued bytes have been sent.
+ *        After a JUMP frame it computes the press to TX latency and reports it in a TELEMETRY frame,
+ *        after the TELEMETRY frame it sends the idle statistics in a POWER frame.
  * 
+ * @param USARTx USART port that completed the transmission
  */
-void TIM6_IT_Init(void)
+void USART3_TxCpltCallback(USART_RegDef_t * USARTx)
 {
-    uint8_t Priority = 1U;
-    TIM_Base_IT_Init(TIM6, Priority);
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+    const Debounce_Capture_t * pButton = &JumpButton;
+#else
+    const Debounce_Line_t * pButton;
+#endif
+    const Idle_Stats_t * pStats;
+    uint8_t Payload[16];
+    uint16_t FrameSize;
+
+    if (JumpLatencyPending == FALSE)
+    {
+        if (PowerReportPending == TRUE)
+        {
+            PowerReportPending = FALSE;
+            pStats = Idle_GetStats();
+            PutU32LE(&Payload[0], pStats->SleepTime);
+            PutU32LE(&Payload[4], pStats->StopCount);
+            PutU32LE(&Payload[8], pStats->WakeLatencyLast);
+            PutU32LE(&Payload[12], pStats->WakeLatencyMax);
+            FrameSize = DinoProto_Encode(DINO_MSG_POWER, Payload, sizeof(Payload), PowerMess, sizeof(PowerMess));
+            USART_Transmit_IT(USARTx, PowerMess, FrameSize);
+        }
+        return;
+    }
+    JumpLatencyPending = FALSE;
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+    /*The press timestamp is the TIM5 counter latched on the edge*/
+    JumpLatencyLastUs = (TIM5->CNT - pButton->PressStamp) / (RCC_GetTIMxClkVal(TIM5) / 1000000U);
+#else
+    pButton = Debounce_GetLine(JUMP_BUTTON_PIN);
+    JumpLatencyLastUs = Timebase_CyclesToUs(Timebase_ElapsedCycles(pButton->PressStamp));
+#endif
+    if (JumpLatencyLastUs > JumpLatencyMaxUs)
+    {
+        JumpLatencyMaxUs = JumpLatencyLastUs;
+    }
+    PutU32LE(&Payload[0], JumpLatencyLastUs);
+    PutU32LE(&Payload[4], JumpLatencyMaxUs);
+    PutU32LE(&Payload[8], pButton->PressCount);
+    PutU32LE(&Payload[12], pButton->BounceCount);
+    FrameSize = DinoProto_Encode(DINO_MSG_TELEMETRY, Payload, sizeof(Payload), TelemetryMess, sizeof(TelemetryMess));
+    PowerReportPending = TRUE;
+    USART_Transmit_IT(USARTx, TelemetryMess, FrameSize);
 }
 
 /**
- * @brief   This function initializes timer 4 channel 4 to used in output compare mode
- *          This configuration is applied for peripheral clock at 16Mhz 
+ * @brief This function decodes the received bytes into frames, it is run from PendSV (deferred work).
+ *        Each valid frame is posted as an EVENT_UART_FRAME event.
  * 
+ * @param Context Not used
  */
-void TIM4_OC_Init(void)
+static void RxDecode_Work(void * Context)
 {
-    GPIO_PinConf_t OC_Pin;
-
-    /*GPIO - TIM4 output compare pin configuration
-      Configure GPIO (GPIOD pin15/channel 4) pin to use in alternate function mode (TIM4 - OC Channel 4)*/
-    OC_Pin.GPIO_PinMode   = GPIO_MODE_ALT;
-    OC_Pin.GPIO_PUPD      = GPIO_NO_PUPD;
-    OC_Pin.GPIO_OutType   = GPIO_OUT_PP;
-    OC_Pin.GPIO_PinNumber = GPIO_PIN_NUM_15;
-    OC_Pin.GPIO_AltFunc   = GPIO_ALT_AF2;
-    GPIOD_CLK_ENB();
-    GPIO_Init(GPIOD, OC_Pin);
-
-    /*Timer 4 configuration*/
-    /*Timer base init*/
-    TIM4_Conf.AutoReloadPreload = ENABLE;
-    TIM4_Conf.Period            = 999;      /*1ms period*/
-    TIM4_Conf.Prescaler         = 15;       /*Counter clock is 1Mhz (with 16 Mhz timer clock)*/
-    TIM4_Conf.CounterMode       = TIM_UPCOUNTING;
-    TIM4_CLK_ENB();
-    TIM_Base_Init(TIM4, TIM4_Conf);
+    DinoProto_Msg_t RxMsg;
+    uint32_t Param;
+    uint8_t RxData, i;
 
-    /*Output compare init*/
-    TIM4_OC_Conf.OCMode         = TIM_OCMODE_PWM1;
-    TIM4_OC_Conf.OCPolarity     = TIM_OCPOLARITY_HIGH;
-    TIM4_OC_Conf.Pulse          = 0;
-    TIM_OC_Init(TIM4, TIM4_OC_Conf, TIM_OC_CHANNEL_4);
+    (void)Context;
+    while (RingBuf_Get(&RxQueue, &RxData) == TRUE)
+    {
+        Idle_NotifyActivity();
+        if (DinoProto_Decode(&RxDecoder, RxData, &RxMsg) != DINO_PROTO_FRAME_OK)
+        {
+            continue;
+        }
+        /*Frames too short for their message are dropped*/
+        if (((RxMsg.Id == DINO_MSG_HEIGHT) && (RxMsg.Length < 1U))
+            || ((RxMsg.Id == DINO_MSG_SCORE) && (RxMsg.Length < 4U)))
+        {
+            continue;
+        }
+        Param = 0U;
+        for (i = 0U; (i < RxMsg.Length) && (i < 4U); i++)
+        {
+            Param |= (uint32_t)RxMsg.Payload[i] << (8U * i);
+        }
+        /*A full queue is counted by Event_GetDropped*/
+        Event_Post(EVENT_UART_FRAME, RxMsg.Id, Param, EVENT_PRIO_NORMAL);
+    }
 }
 
 /**
- * @brief This function is used to start timer 4
+ * @brief This function handles the frames sent by the game, it is run by the event loop.
+ *        HEIGHT sets the LED brightness, SCORE is stored.
  * 
+ * @param pEvent EVENT_UART_FRAME event, Code is the message ID
  */
-void TIM4_Start(void)
+static void UartFrame_Handler(const Event_t * pEvent)
 {
-    TIM_Base_Start(TIM4);
+    switch (pEvent->Code)
+    {
+        case DINO_MSG_HEIGHT:
+        {
+            /*Set duty cycle for timer 4 pwm channel 4, the height is a fraction of 256*/
+            TIM4_OC_PWM_SET_DUTY(TIM_OC_CHANNEL_4, ((TIM4_Conf.Period + 1U) * (pEvent->Param & 0xFFU)) >> 8);
+            break;
+        }
+        case DINO_MSG_SCORE:
+        {
+            GameScore = pEvent->Param;
+            break;
+        }
+        default:
+        {
+            /*Unknown message, ignored*/
+            break;
+        }
+    }
 }
 
+/**
+ * @brief This function handles the jump button presses, it is run by the event loop.
+ *        The JUMP frame is already sent by the interrupt, the green LED (PD12) toggles on each press.
+ * 
+ * @param pEvent EVENT_BUTTON event
+ */
+static void Button_Handler(const Event_t * pEvent)
+{
+    (void)pEvent;
+    GPIO_PinToggle(GPIOD, LED_GREEN_PIN);
+}
+
+/**
+ * @brief This function is called from the USART3/DMA1 stream 1 interrupt with the newly received bytes.
+ *        The bytes are queued and their decoding is deferred to PendSV, the interrupt only copies them.
+ * 
+ * @param USARTx USART port that received the data
+ * @param Data Received bytes
+ * @param Length Number of received bytes
+ */
+void USART3_RxEventCallback(USART_RegDef_t * USARTx, const uint8_t * Data, uint16_t Length)
+{
+    (void)USARTx;
+    /*Bytes that do not fit are counted in RxQueue.Dropped*/
+    RingBuf_Write(&RxQueue, Data, Length);
+    /*A failed post is counted in the work queue statistics, the bytes then wait for the next reception*/
+    WorkQueue_Post(RxDecode_Work, NULL);
+}
 
 /**
  * @brief USART3 init function
  *        This function initializes the USART3 which includes:
- *        GPIOB configuration - Configure GPIOB pin10 and pin11 to use in alternate function mode
- *        USART3 configuration 
+ *        USART3 configuration and its DMA reception
+ *        The PB10/PB11 pins, the EXTI line 11 (wake up from STOP) and the clocks are set by Board_Init
  */
 void USART3_Init(void)
 {
-    GPIO_PinConf_t USART_Pin;
-    /*GPIO - USART pin configuration
-      Configure GPIO (GPIOB pin10/Tx and pin11/Rx) pin to use in alternate function mode (USART3)*/
-    USART_Pin.GPIO_PinMode   = GPIO_MODE_ALT;
-    USART_Pin.GPIO_PUPD      = GPIO_NO_PUPD;
-    USART_Pin.GPIO_OutType   = GPIO_OUT_PP;
-    USART_Pin.GPIO_AltFunc   = GPIO_ALT_AF7;
-    GPIOB_CLK_ENB();
-    USART_Pin.GPIO_PinNumber = GPIO_PIN_NUM_10; /* Tx pin */
-    GPIO_Init(GPIOB, USART_Pin);
-    USART_Pin.GPIO_PinNumber = GPIO_PIN_NUM_11; /* Rx pin */
-    GPIO_Init(GPIOB, USART_Pin);
-
     /*USART3 configuration*/
     USART3_Conf.Mode            = USART_MODE_TX_RX;         /*Transmit and receive mode*/
     USART3_Conf.Parity          = USART_PARITY_NONE;        /*None parity control*/
@@ -156,130 +344,251 @@ void USART3_Init(void)
     USART3_Conf.WordLength      = USART_WORDLENGTH_8B;      /*8 bit word length*/
     USART3_Conf.OverSampling    = USART_OVERSAMPLING_16;    /*Oversampling by 16*/
     USART3_Conf.BaudRate        = USART_BAUDRATE_9600;                     
-    USART3_CLK_ENB();
-    /*TODO-----------------------------------------------------*/
-    USART3_RXNEIE_ENB();                                    /*Enable receive not empty interrupt*/
-    NVIC_SetPriority(IRQ_NO_USART3, 0U);                    /*Set USART3 interrupt priority*/
-    NVIC_EnableIRQ(IRQ_NO_USART3);                          /*Enable USART3 IRQ*/
+    USART_IT_Init(USART3, IRQ_PRIORITY_LINK);               /*Set USART3 interrupt priority and enable USART3 IRQ*/
     USART_Init(USART3, USART3_Conf);
+    USART_RegisterTxCpltCallback(USART3, USART3_TxCpltCallback);
+    /*USART3 RX request is served by DMA1 stream 1 channel 4*/
+    RingBuf_Init(&RxQueue, RxQueueStorage, RX_QUEUE_SIZE);
+    USART_RxDMA_Start(USART3, DMA1, DMA_STREAM_1, DMA_CHANNEL_4,
+                      RxDMABuffer, RX_DMA_BUFFER_SIZE, USART3_RxEventCallback, IRQ_PRIORITY_LINK);
 }
 
-void GPIOD_Init(void)
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+/**
+ * @brief   This function initializes the jump button in input capture mode
+ *          PA0 (TIM5_CH1) is captured by TIM5 running at the full timer clock:
+ *          CH1 captures the press (rising) edges, CH2 the release (falling) edges of the same input
+ * 
+ */
+void TIM5_IC_Init(void)
 {
-    GPIOD_PinConf.GPIO_PinNumber    = GPIO_PIN_NUM_12;
-    GPIOD_PinConf.GPIO_PinMode      = GPIO_MODE_OUTPUT;
-    GPIOD_PinConf.GPIO_OutType      = GPIO_OUT_PP;
+    TIM_Base_Conf_t TIM5_Conf;
+    TIM_IC_Conf_t TIM5_IC_Conf;
+
+    /*Timer 5 configuration: free running 32 bit counter, filters sampled at CK_INT/4.
+      The PA0 pin (TIM5 - IC Channel 1) and the clock are set by Board_Init*/
+    TIM5_Conf.AutoReloadPreload = DISABLE;
+    TIM5_Conf.Period            = 0xFFFFFFFFU;
+    TIM5_Conf.Prescaler         = 0U;
+    TIM5_Conf.CounterClock      = 0U;
+    TIM5_Conf.CounterMode       = TIM_UPCOUNTING;
+    TIM5_Conf.ClockDivision     = TIM_CLOCKDIVISION_DIV4;
+    TIM_Base_Init(TIM5, TIM5_Conf);
+    TIM_Base_ForceUpdate(TIM5);
+
+    /*Input capture init, the strongest filter (8 samples at fDTS/32)*/
+    TIM5_IC_Conf.ICPrescaler    = TIM_ICPSC_DIV1;
+    TIM5_IC_Conf.ICFilter       = 0x0FU;
+    TIM5_IC_Conf.ICPolarity     = TIM_ICPOLARITY_RISING;
+    TIM5_IC_Conf.ICSelection    = TIM_ICSELECTION_DIRECTTI;
+    TIM_IC_Init(TIM5, TIM5_IC_Conf, TIM_IC_CHANNEL_1);
+    TIM5_IC_Conf.ICPolarity     = TIM_ICPOLARITY_FALLING;
+    TIM5_IC_Conf.ICSelection    = TIM_ICSELECTION_INDIRECTTI;
+    TIM_IC_Init(TIM5, TIM5_IC_Conf, TIM_IC_CHANNEL_2);
+    Debounce_CaptureInit(&JumpButton, TIM5, TIM_IC_CHANNEL_1, TIM_IC_CHANNEL_2, BUTTON_LOCKOUT_TIME);
+
+    /*Same priority as USART3, see the EXTI mode*/
+    TIM_IC_IT_Init(TIM5, TIM_IC_CHANNEL_1, IRQ_PRIORITY_LINK);
+    TIM_IC_IT_Init(TIM5, TIM_IC_CHANNEL_2, IRQ_PRIORITY_LINK);
+    TIM_Base_IT_Init(TIM5, IRQ_PRIORITY_LINK);
+    TIM_Base_Start(TIM5);
+}
+#endif
 
-    /*enable clock for GPIOD*/
-    GPIOD_CLK_ENB();
-    GPIO_Init(GPIOD, GPIOD_PinConf);
+#if (BUTTON_MODE == BUTTON_MODE_EXTI)
+/**
+ * @brief This function is the EXTI callback of the user button, called from the EXTI0 interrupt.
+ *        The JUMP frame is queued on the first edge, the debouncer then ignores the bounces
+ * 
+ * @param Line EXTI line of the button
+ * @param Context Not used
+ */
+static void JumpButton_EdgeCallback(uint8_t Line, void * Context)
+{
+    (void)Context;
+    /*Check if this is a new press*/
+    if (Debounce_EdgeIRQ(Line) == TRUE)
+    {
+        JumpLatencyPending = TRUE;
+        /*Queue data for transmission, the USART3 interrupt sends it*/
+        USART_Transmit_IT(USART3, TransmitMess, TransmitMessSize);
+        /*The rest of the press handling runs in the event loop*/
+        Event_Post(EVENT_BUTTON, 0U, 0U, EVENT_PRIO_HIGH);
+    }
 }
+#endif
 
-void GPIOA_Init(void)
+#if (BUTTON_MODE == BUTTON_MODE_SAMPLED)
+/**
+ * @brief This function is the SysTick hook of the sampled buttons, called from the SysTick interrupt.
+ *        The JUMP frame is queued on each debounced press, the other events are ignored.
+ *        There is no press timestamp in this mode, so no TELEMETRY frame follows the JUMP frame.
+ * 
+ */
+static void Buttons_SysTickHook(void)
 {
-    GPIOA_PinConf.GPIO_PinMode      = GPIO_MODE_INPUT;
-    GPIOA_PinConf.GPIO_PUPD         = GPIO_NO_PUPD;
-    GPIOA_PinConf.GPIO_EdgeTrigger  = GPIO_IT_EDGE_RT;
-    GPIOA_CLK_ENB();
-    GPIO_Init(GPIOA, GPIOA_PinConf);
+    uint8_t Evt;
+
+    Buttons_Tick();
+    while (RingBuf_Get(&ButtonEventQueue, &Evt) == TRUE)
+    {
+        if (BUTTONS_EVT_TYPE(Evt) == BUTTONS_EVT_PRESS)
+        {
+            /*Queue data for transmission, USART_Transmit_IT masks the USART3 interrupt while it queues*/
+            USART_Transmit_IT(USART3, TransmitMess, TransmitMessSize);
+            Event_Post(EVENT_BUTTON, 0U, 0U, EVENT_PRIO_HIGH);
+        }
+    }
 }
 
-int main(void)
+/**
+ * @brief   This function initializes the jump button in sampled mode
+ *          PA0 is read on each SysTick tick, the press is reported after BUTTONS_INTEGRATOR_SAMPLES equal samples
+ * 
+ */
+static void JumpButton_SampledInit(void)
 {
-    uint8_t DutyCycle = 0;
+    Buttons_Conf_t Buttons_Conf;
+
+    Buttons_Conf.TickPeriod      = 1000U / SYSTICK_RATE;
+    Buttons_Conf.LongPressTime   = 1000U;
+    Buttons_Conf.DoublePressTime = 300U;
+    RingBuf_Init(&ButtonEventQueue, ButtonEventStorage, BUTTON_EVENT_QUEUE_SIZE);
+    Buttons_Init(Buttons_Conf, &ButtonEventQueue);
+    /*The user button (PA0) is active high*/
+    Buttons_AddPort(GPIOA, (0x01U << JUMP_BUTTON_PIN), 0x0000U);
+    SysTick_RegisterHook(Buttons_SysTickHook);
+}
+#endif
 
-    GPIOD_Init();
-    GPIOA_Init();
-    /*Configure GPIOA as input interrupt*/
-    GPIO_IT_Init(GPIOA, GPIOA_PinConf, 1);
+/**
+ * @brief This function checks if work is pending, it is called by the idle manager with the interrupts masked.
+ * 
+ * @return uint8_t TRUE if events or deferred work are waiting
+ */
+static uint8_t MainLoop_HasWork(void)
+{
+    return ((Event_IsPending() == TRUE) || (WorkQueue_GetDepth() != 0U)) ? TRUE : FALSE;
+}
 
+/**
+ * @brief This function checks if the application allows STOP, it is called by the idle manager with the interrupts masked.
+ *        The USART3, the input capture timer and SysTick are stopped in STOP, so a frame must not be in transmission
+ *        and the jump button must wake the core up through its EXTI line.
+ * 
+ * @return uint8_t TRUE if STOP is allowed
+ */
+static uint8_t MainLoop_CanStop(void)
+{
+    if (BUTTON_MODE != BUTTON_MODE_EXTI)
+    {
+        return FALSE;
+    }
+    /*The last byte must have left the shift register*/
+    return USART_IsTxIdle(USART3);
+}
+
+int main(void)
+{
+    Idle_Conf_t Idle_Conf;
+    uint8_t ClockReady;
+
+    /*Switch to the 168 MHz clock first, the drivers derive their settings from the live clock.
+      On failure the project keeps running on the 16 MHz HSI.*/
+    ClockReady = RCC_SysClkConfig(RCC_Conf);
+    /*All the priority bits are preemption priority bits (reset value, set for clarity)*/
+    NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
+    /*Microsecond and cycle time base, also used for the latency measurements*/
+    Timebase_Init(IRQ_PRIORITY_TIMERS);
+#if (BUTTON_MODE == BUTTON_MODE_SAMPLED) || (KERNEL_ENABLE == 1)
+    /*Global millisecond tick, only started for its hooks (sampled buttons, kernel):
+      otherwise it would wake the core from SLEEP every 1 ms for nothing*/
+    SysTick_Init(SYSTICK_RATE, IRQ_PRIORITY_TIMERS);
+#endif
+    /*Software timers (debounce lockout), the callbacks run below the button and USART3 interrupts*/
+    SoftTimer_Init(IRQ_PRIORITY_TIMERS);
+    /*Deferred work run by PendSV at the lowest priority*/
+    WorkQueue_Init();
+#if (KERNEL_ENABLE == 1)
+    /*The kernel owns PendSV, the deferred work runs before each context switch*/
+    Kernel_Init();
+    Kernel_SetPendSVHook(WorkQueue_IRQHandling);
+#endif
+    /*Events dispatched by the main loop*/
+    Event_Init();
+    Event_Subscribe(EVENT_BUTTON, Button_Handler);
+    Event_Subscribe(EVENT_UART_FRAME, UartFrame_Handler);
+    /*Clocks, pins and EXTI lines of the board, Board_GetInitUs gives the duration*/
+    Board_Init(&Board_Conf);
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+    TIM5_IC_Init();
+#elif (BUTTON_MODE == BUTTON_MODE_SAMPLED)
+    JumpButton_SampledInit();
+#else
+    /*The user button (PA0) is active high*/
+    Debounce_Init(GPIOA, JUMP_BUTTON_PIN, BIT_SET, BUTTON_LOCKOUT_TIME);
+    GPIO_EXTI_Register(JUMP_BUTTON_PIN, JumpButton_EdgeCallback, NULL);
+#endif
+
+    /*Build the JUMP frame sent on each button press*/
+    TransmitMessSize = (uint8_t)DinoProto_Encode(DINO_MSG_JUMP, NULL, 0U, TransmitMess, sizeof(TransmitMess));
+    DinoProto_DecoderInit(&RxDecoder);
     USART3_Init();
 
-    /*Init timer 6*/
-    TIM6_Init();
-    TIM6_IT_Init();
-    /*Start timer 6*/
-    // TIM6_Start();
     TIM4_OC_Init();
     TIM4_Start();
-    // uint16_t Timer6DelayCounter = 0U;
+
+    /*Sleep when the main loop has nothing to do, STOP after IDLE_STOP_DELAY ms without activity*/
+    Idle_Conf.HasWork   = MainLoop_HasWork;
+    Idle_Conf.CanStop   = MainLoop_CanStop;
+    /*Without the HSE the clock tree can not be restored after STOP, the core only uses SLEEP*/
+    Idle_Conf.pClkConf  = (ClockReady == TRUE) ? &RCC_Conf : NULL;
+    Idle_Conf.StopDelay = IDLE_STOP_DELAY;
+    Idle_Conf.WakeLines = (0x01U << USART3_RX_PIN);
+    Idle_Init(Idle_Conf);
     while (1)
     {
-        /*TODO-------------------------------------------------*/
-        /*Compare buffer*/
-        /*Control LED*/
-        /*Is new data available?*/
-        if (IsRxAvailable == TRUE)
+        /*Run the events one at a time: the received frames (RxDecode_Work) and the button presses*/
+        if (Event_Dispatch() == TRUE)
         {
-            USART3_RXNEIE_DIS();
-            /*Reset the Rx data available flag to FALSE*/
-            IsRxAvailable = FALSE;
-            
-            /*Null-terminate the string/message*/
-            ReceivedMess[RxIndex - 1] = '\0';
-            // /*Check if the received message is "ON"*/
-            // if (strcmp((const char *)ReceivedMess, "ON") == 0)
-            // {
-            //     /*Turn blue LED ON*/
-            //     GPIO_PinWrite(GPIOD, GPIOD_PinConf.GPIO_PinNumber, BIT_SET);
-            // }
-            // /*Check if the received message is "OFF"*/
-            // if (strcmp((const char *)ReceivedMess, "OFF") == 0)
-            // {
-            //     /*Turn blue LED OFF*/
-            //     GPIO_PinWrite(GPIOD, GPIOD_PinConf.GPIO_PinNumber, BIT_RESET);
-            // }
-
-            DutyCycle = atoi((const char *) ReceivedMess);
-            /*Set duty cycle for timer 4 pwm channel 4*/
-            TIM4_OC_PWM_SET_DUTY(TIM_OC_CHANNEL_4, (TIM4_Conf.Period * DutyCycle) / 100);
-            // USART_Transmit(USART3,(uint8_t *)&ReceivedMess, RxIndex);
-            /*Reset the index*/
-            RxIndex = 0U;
-            USART3_RXNEIE_ENB();
+            continue;
         }
 
-                
-        // /*Check if update event generated*/
-        // if (TIM6_UEV_STS() == BIT_SET)
-        // {
-        //     /*Clear the update event status*/
-        //     TIM6_UEV_STS_CLR();
-        //     /*Increase the timer delay counter by 1*/
-        //     Timer6DelayCounter++;
-        //     /*Check if 1 second has elapsed*/
-        //     if (Timer6DelayCounter == 1000)
-        //     {
-        //         /*Toggle the Blue LED*/
-        //         GPIO_PinToggle(GPIOD, GPIOD_PinConf.GPIO_PinNumber);
-        //         /*Reset timer 6 delay counter*/
-        //         Timer6DelayCounter = 0U; 
-        //     }
-        // }
-        
+        /*No event left: sleep until the next interrupt*/
+        Idle_Enter();
     }
 
     return 0;
 }
 
-void EXTI0_IRQHandler(void)
+#if (BUTTON_MODE == BUTTON_MODE_CAPTURE)
+/**
+ * @brief This is interrupt service routine for Timer 5 (user button in input capture mode)
+ * 
+ */
+void TIM5_IRQHandler(void)
 {
-
-    
-    /*TODO----------------------------------------------------------*/
-    /*Thay the delayms bang timer interrupt de chong doi nut nhan*/
-    // delayms(1);
-    /*Clear pending interrupt bit in EXTI_PR*/
-    // EXTI->PR |= (0x01 << GPIOA_PinConf.GPIO_PinNumber);
-        /*Start timer 6*/
-    TIM6_Start();
-    /*Is the corresponding bit in the EXTI_PR register set?*/
-    if((EXTI->PR >> GPIOA_PinConf.GPIO_PinNumber) & 0x01U)
+    /*Read the captures and check if this is a new press*/
+    if (Debounce_CaptureIRQ(&JumpButton) == TRUE)
     {
-        /*Clear the pending bit by writing 1*/
-        EXTI->PR |= (0x01U << GPIOA_PinConf.GPIO_PinNumber);
+        JumpLatencyPending = TRUE;
+        /*Queue data for transmission, the USART3 interrupt sends it*/
+        USART_Transmit_IT(USART3, TransmitMess, TransmitMessSize);
+        /*The rest of the press handling runs in the event loop*/
+        Event_Post(EVENT_BUTTON, 0U, 0U, EVENT_PRIO_HIGH);
     }
 }
+#endif
+
+/**
+ * @brief This is interrupt service routine for Timer 2 (time base)
+ * 
+ */
+void TIM2_IRQHandler(void)
+{
+    /*Wake up the sleeping delays*/
+    Timebase_IRQHandling();
+}
 
 /**
  * @brief This is interrupt service routine for USART3
@@ -287,60 +596,48 @@ void EXTI0_IRQHandler(void)
  */
 void USART3_IRQHandler(void)
 {
-    /*Check if the receive register is not empty*/
-    if ((USART3->SR >> USART_SR_RXNE) & 0x01U)
-    {
-        /*TODO-------------------------------------------------*/
-        /*USART_Reseive()*/
-        /*Push character to buffer*/
-
-        /*Read received data*/
-        RxData = USART3->DR;
-        /*Check overflow status and store data*/
-        if (RxIndex < RX_BUFFER_SIZE)
-        {
-            /*Store new data to the received message*/
-            ReceivedMess[RxIndex] = RxData;
-            /*Increase the index*/
-            RxIndex++;
-        }
-        else
-        {
-            RxIndex = 0U; /*Overflow recovery*/
-        }
+    /*Handle the IDLE line reception event and the interrupt driven transmission*/
+    USART_IRQHandling(USART3);
+}
 
-        if (RxData == '\n')
-        {
-            /*Set the Rx data available flag to TRUE*/
-            IsRxAvailable = TRUE;
-        }
-    }
+/**
+ * @brief This is interrupt service routine for DMA1 stream 1 (USART3 RX)
+ * 
+ */
+void DMA1_Stream1_IRQHandler(void)
+{
+    /*Handle the half transfer and transfer complete events of the reception*/
+    DMA_IRQHandling(DMA1, DMA_STREAM_1);
 }
 
-/*TODO-----------------------------------------------------------*/
-/*Viet timer base interrupt*/
+#if (KERNEL_ENABLE == 0)
 /**
- * @brief This is interrupt service routine for Timer 6 and DAC
+ * @brief This is the exception handler for PendSV (deferred work)
  * 
  */
-void TIM6_DAC_IRQHandler(void)
+void PendSV_Handler(void)
 {
-    /*Check if update event generated*/
-    if (TIM6_UEV_STS() == BIT_SET)
-    {
-        /*Clear the update event status*/
-        TIM6_UEV_STS_CLR();
-        /*Increase the timer delay counter by 1*/
-        Timer6DelayCounter++;
-        /*Check if BUTTON_DEBOUNCE_TIME ms has elapsed*/
-        if (Timer6DelayCounter == BUTTON_DEBOUNCE_TIME)
-        {
-            /*Transmit data*/
-            USART_Transmit(USART3,(uint8_t *)TransmitMess, TransmitMessSize);
-            /*Reset timer 6 delay counter*/
-            Timer6DelayCounter = 0U;
-            /*Stop timer 6*/
-            TIM6_Stop(); 
-        }
-    }
+    /*Run the work posted by the interrupt handlers*/
+    WorkQueue_IRQHandling();
+}
+#endif
+
+/**
+ * @brief This is the exception handler for SysTick (global tick)
+ * 
+ */
+void SysTick_Handler(void)
+{
+    /*Count the tick and run the tick hooks*/
+    SysTick_IRQHandling();
+}
+
+/**
+ * @brief This is interrupt service routine for Timer 7 (software timer alarm)
+ * 
+ */
+void TIM7_IRQHandler(void)
+{
+    /*Run the expired software timers*/
+    SoftTimer_IRQHandling();
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "mpsc_queue.h"
+
+/**
+ * @brief This function initializes an empty queue on the given sequence array.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Sequence Sequence array, one entry per cell
+ * @param Size Number of cells, must be a power of two
+ *
+ * @return uint8_t TRUE on success, FALSE if Size is not valid
+ */
+uint8_t MpscQueue_Init(MpscQueue_t * pQueue, volatile uint32_t * Sequence, uint32_t Size)
+{
+    uint32_t i;
+
+    if ((Size == 0U) || ((Size & (Size - 1U)) != 0U))
+    {
+        return FALSE;
+    }
+    for (i = 0U; i < Size; i++)
+    {
+        Sequence[i] = i;
+    }
+    pQueue->Sequence  = Sequence;
+    pQueue->Mask      = Size - 1U;
+    pQueue->Head      = 0U;
+    pQueue->Tail      = 0U;
+    pQueue->Dropped   = 0U;
+    pQueue->HighWater = 0U;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function reserves the next position. Producer side, any context.
+ *
+ * @param pQueue Pointer to the queue
+ * @param pPos Reserved position, the item is written at MPSC_QUEUE_INDEX(pQueue, *pPos)
+ *
+ * @return uint8_t TRUE on success, FALSE if the queue is full (counted in Dropped)
+ */
+uint8_t MpscQueue_Reserve(MpscQueue_t * pQueue, uint32_t * pPos)
+{
+    uint32_t Pos, Seq;
+
+    Pos = __atomic_load_n(&pQueue->Head, __ATOMIC_RELAXED);
+    while (1)
+    {
+        Seq = __atomic_load_n(&pQueue->Sequence[Pos & pQueue->Mask], __ATOMIC_ACQUIRE);
+        if (Seq == Pos)
+        {
+            /*On failure Pos is reloaded with the position taken by the other producer*/
+            if (__atomic_compare_exchange_n(&pQueue->Head, &Pos, Pos + 1U, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *pPos = Pos;
+                return TRUE;
+            }
+        }
+        else if ((int32_t)(Seq - Pos) < 0)
+        {
+            /*The cell still holds the item reserved one lap before*/
+            __atomic_fetch_add(&pQueue->Dropped, 1U, __ATOMIC_RELAXED);
+            return FALSE;
+        }
+        else
+        {
+            /*Another producer took the cell*/
+            Pos = __atomic_load_n(&pQueue->Head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief This function publishes a reserved position once its item is written. Producer side.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Pos Position given by MpscQueue_Reserve
+ */
+void MpscQueue_Publish(MpscQueue_t * pQueue, uint32_t Pos)
+{
+    uint32_t Depth, HighWater;
+
+    __atomic_store_n(&pQueue->Sequence[Pos & pQueue->Mask], Pos + 1U, __ATOMIC_RELEASE);
+
+    /*The consumer may already be past Pos when it preempted the producer, the depth is then not valid*/
+    Depth = Pos + 1U - __atomic_load_n(&pQueue->Tail, __ATOMIC_RELAXED);
+    HighWater = __atomic_load_n(&pQueue->HighWater, __ATOMIC_RELAXED);
+    while ((Depth <= (pQueue->Mask + 1U)) && (Depth > HighWater))
+    {
+        if (__atomic_compare_exchange_n(&pQueue->HighWater, &HighWater, Depth, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief This function checks if the next position is published. Consumer side.
+ *
+ * @param pQueue Pointer to the queue
+ * @param pPos Position to be read, the item is at MPSC_QUEUE_INDEX(pQueue, *pPos)
+ *
+ * @return uint8_t TRUE if an item is available, FALSE if the queue is empty or the next item is not published yet
+ */
+uint8_t MpscQueue_Peek(MpscQueue_t * pQueue, uint32_t * pPos)
+{
+    uint32_t Pos;
+
+    Pos = pQueue->Tail;
+    if (__atomic_load_n(&pQueue->Sequence[Pos & pQueue->Mask], __ATOMIC_ACQUIRE) != (Pos + 1U))
+    {
+        return FALSE;
+    }
+    *pPos = Pos;
+    return TRUE;
+}
+
+/**
+ * @brief This function frees the position read after MpscQueue_Peek. Consumer side.
+ *        The item must have been copied, the cell can be reserved again at once.
+ *
+ * @param pQueue Pointer to the queue
+ * @param Pos Position given by MpscQueue_Peek
+ */
+void MpscQueue_Release(MpscQueue_t * pQueue, uint32_t Pos)
+{
+    /*The cell is free for the position one lap ahead*/
+    __atomic_store_n(&pQueue->Sequence[Pos & pQueue->Mask], Pos + pQueue->Mask + 1U, __ATOMIC_RELEASE);
+    __atomic_store_n(&pQueue->Tail, Pos + 1U, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function gets the number of positions reserved and not consumed yet.
+ *
+ * @param pQueue Pointer to the queue
+ *
+ * @return uint32_t
+ */
+uint32_t MpscQueue_GetDepth(const MpscQueue_t * pQueue)
+{
+    return __atomic_load_n(&pQueue->Head, __ATOMIC_RELAXED) - __atomic_load_n(&pQueue->Tail, __ATOMIC_RELAXED);
+}
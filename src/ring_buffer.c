@@ -0,0 +1,150 @@
+#include "ring_buffer.h"
+
+/**
+ * @brief This function initializes an empty ring buffer on the given storage.
+ *
+ * @param pRing Pointer to the ring buffer
+ * @param Storage Storage of the queue
+ * @param Size Size of the storage, must be a power of two in [1..32768]
+ *
+ * @return uint8_t TRUE on success, FALSE if Size is not valid
+ */
+uint8_t RingBuf_Init(RingBuf_t * pRing, uint8_t * Storage, uint16_t Size)
+{
+    /*The mask indexing and the free running 16 bit indexes need a power of two up to 32768*/
+    if ((Size == 0U) || ((Size & (Size - 1U)) != 0U) || (Size > 32768U))
+    {
+        return FALSE;
+    }
+    pRing->Buffer    = Storage;
+    pRing->Size      = Size;
+    pRing->Head      = 0U;
+    pRing->Tail      = 0U;
+    pRing->HighWater = 0U;
+    pRing->Dropped   = 0U;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function queues one byte. Producer side.
+ *
+ * @param pRing Pointer to the ring buffer
+ * @param Data Byte to be queued
+ *
+ * @return uint8_t TRUE if the byte is queued, FALSE if the queue is full (the byte is counted as dropped)
+ */
+uint8_t RingBuf_Put(RingBuf_t * pRing, uint8_t Data)
+{
+    return (RingBuf_Write(pRing, &Data, 1U) == 1U) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function queues as many bytes as fit into the queue. Producer side.
+ *
+ * @param pRing Pointer to the ring buffer
+ * @param Data Bytes to be queued
+ * @param Length Number of bytes to be queued
+ *
+ * @return uint16_t Number of bytes queued, the rest is counted as dropped
+ */
+uint16_t RingBuf_Write(RingBuf_t * pRing, const uint8_t * Data, uint16_t Length)
+{
+    uint16_t Head, Count, Used, i;
+
+    Head = pRing->Head;
+    Used = (uint16_t)(Head - pRing->Tail);
+    Count = pRing->Size - Used;
+    if (Count > Length)
+    {
+        Count = Length;
+    }
+    for (i = 0; i < Count; i++)
+    {
+        pRing->Buffer[(uint16_t)(Head + i) & (pRing->Size - 1U)] = Data[i];
+    }
+    /*The data must be visible before the consumer sees the new head*/
+    CM4_DMB();
+    pRing->Head = Head + Count;
+
+    Used += Count;
+    if (Used > pRing->HighWater)
+    {
+        pRing->HighWater = Used;
+    }
+    if (Count < Length)
+    {
+        pRing->Dropped += (uint32_t)(Length - Count);
+    }
+
+    return Count;
+}
+
+/**
+ * @brief This function removes one byte from the queue. Consumer side.
+ *
+ * @param pRing Pointer to the ring buffer
+ * @param Data Pointer to store the byte
+ *
+ * @return uint8_t TRUE if a byte is read, FALSE if the queue is empty
+ */
+uint8_t RingBuf_Get(RingBuf_t * pRing, uint8_t * Data)
+{
+    return (RingBuf_Read(pRing, Data, 1U) == 1U) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function removes up to Length bytes from the queue. Consumer side.
+ *
+ * @param pRing Pointer to the ring buffer
+ * @param Data Buffer to store the bytes
+ * @param Length Size of the buffer
+ *
+ * @return uint16_t Number of bytes read
+ */
+uint16_t RingBuf_Read(RingBuf_t * pRing, uint8_t * Data, uint16_t Length)
+{
+    uint16_t Tail, Count, i;
+
+    Tail = pRing->Tail;
+    Count = (uint16_t)(pRing->Head - Tail);
+    if (Count > Length)
+    {
+        Count = Length;
+    }
+    /*Read the data only after the head that published it*/
+    CM4_DMB();
+    for (i = 0; i < Count; i++)
+    {
+        Data[i] = pRing->Buffer[(uint16_t)(Tail + i) & (pRing->Size - 1U)];
+    }
+    /*The data must be read before the producer can overwrite the slots*/
+    CM4_DMB();
+    pRing->Tail = Tail + Count;
+
+    return Count;
+}
+
+/**
+ * @brief This function gets the number of queued bytes.
+ *
+ * @param pRing Pointer to the ring buffer
+ *
+ * @return uint16_t Number of queued bytes
+ */
+uint16_t RingBuf_Count(const RingBuf_t * pRing)
+{
+    return (uint16_t)(pRing->Head - pRing->Tail);
+}
+
+/**
+ * @brief This function gets the number of bytes that can still be queued.
+ *
+ * @param pRing Pointer to the ring buffer
+ *
+ * @return uint16_t Number of free bytes
+ */
+uint16_t RingBuf_Free(const RingBuf_t * pRing)
+{
+    return pRing->Size - (uint16_t)(pRing->Head - pRing->Tail);
+}
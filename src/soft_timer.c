@@ -0,0 +1,406 @@
+#include "soft_timer.h"
+
+/*Slot lists and occupancy bitmaps of each level*/
+static SoftTimer_t * SoftTimer_Slot[SOFTTIMER_LEVELS][SOFTTIMER_SLOTS];
+static uint64_t SoftTimer_Occupied[SOFTTIMER_LEVELS];
+/*Wheel time: all the timers expiring up to this tick have been handled*/
+static uint32_t SoftTimer_Now = 0U;
+/*Ticks elapsed after SoftTimer_Now and not handled yet*/
+static uint32_t SoftTimer_Behind = 0U;
+/*Time base value (us) of the tick SoftTimer_Now + SoftTimer_Behind*/
+static uint32_t SoftTimer_LastUs = 0U;
+/*Number of armed timers*/
+static volatile uint32_t SoftTimer_ArmedCount = 0U;
+/*The expired timers are being handled, the alarm is programmed at the end*/
+static uint8_t SoftTimer_Busy = FALSE;
+
+/**
+ * @brief This function rotates a 64 bit map to the right.
+ *
+ * @param Map Bitmap
+ * @param Count Number of bits, in [0..63]
+ *
+ * @return uint64_t
+ */
+static uint64_t SoftTimer_Rotr(uint64_t Map, uint8_t Count)
+{
+    return (Count == 0U) ? Map : ((Map >> Count) | (Map << (64U - Count)));
+}
+
+/**
+ * @brief This function puts a timer in the slot matching its expiry tick.
+ *        The expiry tick must not be before SoftTimer_Now.
+ *
+ * @param pTimer Pointer to the timer
+ */
+static void SoftTimer_Insert(SoftTimer_t * pTimer)
+{
+    uint32_t Delta;
+    uint8_t Level, Shift, Slot;
+
+    /*Level of the highest set bit of the distance (6 bits per level), the distance is wrap safe*/
+    Delta = pTimer->Expires - SoftTimer_Now;
+    Level = (Delta < SOFTTIMER_SLOTS) ? 0U : (uint8_t)((31U - (uint32_t)__builtin_clz(Delta)) / SOFTTIMER_SLOT_BITS);
+    if (Level >= SOFTTIMER_LEVELS)
+    {
+        /*Beyond the wheel range, wait in the farthest slot of the last level*/
+        Level = SOFTTIMER_LEVELS - 1U;
+        Shift = Level * SOFTTIMER_SLOT_BITS;
+        Slot = (uint8_t)(((SoftTimer_Now >> Shift) + SOFTTIMER_SLOT_MASK) & SOFTTIMER_SLOT_MASK);
+    }
+    else
+    {
+        /*At most 64 slots ahead, the current slot index is reached again on its next turn*/
+        Shift = Level * SOFTTIMER_SLOT_BITS;
+        Slot = (uint8_t)((pTimer->Expires >> Shift) & SOFTTIMER_SLOT_MASK);
+    }
+
+    /*Push at the head of the slot list*/
+    pTimer->Level = Level;
+    pTimer->Slot  = Slot;
+    pTimer->Prev  = NULL;
+    pTimer->Next  = SoftTimer_Slot[Level][Slot];
+    if (pTimer->Next != NULL)
+    {
+        pTimer->Next->Prev = pTimer;
+    }
+    SoftTimer_Slot[Level][Slot] = pTimer;
+    SoftTimer_Occupied[Level] |= ((uint64_t)1U << Slot);
+}
+
+/**
+ * @brief This function removes a timer from its slot.
+ *
+ * @param pTimer Pointer to the timer
+ */
+static void SoftTimer_Unlink(SoftTimer_t * pTimer)
+{
+    if (pTimer->Prev != NULL)
+    {
+        pTimer->Prev->Next = pTimer->Next;
+    }
+    else
+    {
+        SoftTimer_Slot[pTimer->Level][pTimer->Slot] = pTimer->Next;
+        if (pTimer->Next == NULL)
+        {
+            SoftTimer_Occupied[pTimer->Level] &= ~((uint64_t)1U << pTimer->Slot);
+        }
+    }
+    if (pTimer->Next != NULL)
+    {
+        pTimer->Next->Prev = pTimer->Prev;
+    }
+    pTimer->Next = NULL;
+    pTimer->Prev = NULL;
+}
+
+/**
+ * @brief This function computes the number of ticks from SoftTimer_Now to the next tick needing work:
+ *        the next occupied slot of level 0 or the next cascade of an occupied slot of the upper levels.
+ *
+ * @return uint32_t Number of ticks, 0 if the wheel is empty
+ */
+static uint32_t SoftTimer_NextEvent(void)
+{
+    uint32_t Next = 0U, Distance, Boundary;
+    uint64_t Map;
+    uint8_t Level, Shift;
+
+    /*Level 0: slot s expires in ((s - Now - 1) & 63) + 1 ticks*/
+    if (SoftTimer_Occupied[0] != 0U)
+    {
+        Map = SoftTimer_Rotr(SoftTimer_Occupied[0], (uint8_t)((SoftTimer_Now + 1U) & SOFTTIMER_SLOT_MASK));
+        Next = (uint32_t)__builtin_ctzll(Map) + 1U;
+    }
+    /*Upper levels: slot s is cascaded when the tick reaches a multiple of 64^Level with index s*/
+    for (Level = 1U, Shift = SOFTTIMER_SLOT_BITS; Level < SOFTTIMER_LEVELS; Level++, Shift += SOFTTIMER_SLOT_BITS)
+    {
+        if (SoftTimer_Occupied[Level] == 0U)
+        {
+            continue;
+        }
+        Boundary = ((SoftTimer_Now >> Shift) + 1U) << Shift;
+        Map = SoftTimer_Rotr(SoftTimer_Occupied[Level], (uint8_t)((Boundary >> Shift) & SOFTTIMER_SLOT_MASK));
+        Distance = (Boundary + ((uint32_t)__builtin_ctzll(Map) << Shift)) - SoftTimer_Now;
+        if ((Next == 0U) || (Distance < Next))
+        {
+            Next = Distance;
+        }
+    }
+
+    return Next;
+}
+
+/**
+ * @brief This function moves the timers of the upper level slots reached by SoftTimer_Now down the wheel.
+ *
+ */
+static void SoftTimer_Cascade(void)
+{
+    SoftTimer_t * pTimer;
+    uint8_t Level, Shift, Slot;
+
+    /*From the highest level, a cascaded timer may land in a lower slot cascaded at the same tick*/
+    for (Level = SOFTTIMER_LEVELS - 1U; Level > 0U; Level--)
+    {
+        Shift = Level * SOFTTIMER_SLOT_BITS;
+        if ((SoftTimer_Now & ((1UL << Shift) - 1U)) != 0U)
+        {
+            continue;
+        }
+        Slot = (uint8_t)((SoftTimer_Now >> Shift) & SOFTTIMER_SLOT_MASK);
+        while ((pTimer = SoftTimer_Slot[Level][Slot]) != NULL)
+        {
+            SoftTimer_Unlink(pTimer);
+            SoftTimer_Insert(pTimer);
+        }
+    }
+}
+
+/**
+ * @brief This function adds the time elapsed on the time base to SoftTimer_Behind.
+ *
+ */
+static void SoftTimer_Sync(void)
+{
+    uint32_t Ticks;
+
+    Ticks = (Timebase_NowUs() - SoftTimer_LastUs) / SOFTTIMER_US_PER_TICK;
+    SoftTimer_LastUs += Ticks * SOFTTIMER_US_PER_TICK;
+    SoftTimer_Behind += Ticks;
+}
+
+/**
+ * @brief This function programs the TIM7 one-shot alarm to the next tick needing work, or stops it.
+ *
+ */
+static void SoftTimer_Program(void)
+{
+    uint32_t Ticks, Counts;
+    int32_t RemainingUs;
+
+    TIM_Base_Stop(SOFTTIMER_TIM);
+    Ticks = SoftTimer_NextEvent();
+    if (Ticks == 0U)
+    {
+        return;
+    }
+    /*The handled ticks are behind the real time by SoftTimer_Behind ticks*/
+    Ticks = (Ticks > SoftTimer_Behind) ? (Ticks - SoftTimer_Behind) : 0U;
+    if (Ticks > SOFTTIMER_MAX_ALARM)
+    {
+        Ticks = SOFTTIMER_MAX_ALARM;
+    }
+    RemainingUs = (int32_t)((SoftTimer_LastUs + (Ticks * SOFTTIMER_US_PER_TICK)) - Timebase_NowUs());
+    Counts = (RemainingUs <= 0) ? 0U : (((uint32_t)RemainingUs + SOFTTIMER_US_PER_COUNT - 1U) / SOFTTIMER_US_PER_COUNT);
+    /*At least 2 counts, the counter does not run with ARR = 0*/
+    if (Counts < 2U)
+    {
+        Counts = 2U;
+    }
+    SOFTTIMER_TIM->ARR = Counts - 1U;
+    /*Clear the counter and load the prescaler, URS is set so no interrupt is raised*/
+    TIM_Base_ForceUpdate(SOFTTIMER_TIM);
+    TIM_Base_Start(SOFTTIMER_TIM);
+}
+
+/**
+ * @brief This function initializes the software timer service, TIM7 is the one-shot alarm.
+ *
+ * @param Priority Priority of the TIM7 interrupt, the callbacks run at this priority
+ */
+void SoftTimer_Init(uint8_t Priority)
+{
+    TIM_Base_Conf_t SoftTimer_Conf;
+
+    SoftTimer_Conf.Period            = 0xFFFFU;
+    SoftTimer_Conf.Prescaler         = 0U;
+    SoftTimer_Conf.CounterClock      = SOFTTIMER_COUNTER_CLOCK;
+    SoftTimer_Conf.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    SoftTimer_Conf.CounterMode       = TIM_UPCOUNTING;
+    SoftTimer_Conf.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    TIM7_CLK_ENB();
+    TIM_Base_Init(SOFTTIMER_TIM, SoftTimer_Conf);
+    /*One-shot counter, the update interrupt is raised by the counter overflow only*/
+    SOFTTIMER_TIM->CR1 |= ((0x01U << TIM_CR1_OPM) | (0x01U << TIM_CR1_URS));
+    TIM_Base_ForceUpdate(SOFTTIMER_TIM);
+    TIM_Base_IT_Init(SOFTTIMER_TIM, Priority);
+
+    SoftTimer_LastUs = Timebase_NowUs();
+}
+
+/**
+ * @brief This function initializes a software timer, it is not armed.
+ *
+ * @param pTimer Pointer to the timer
+ * @param Callback Function called when the timer expires
+ * @param Context Given to the callback
+ */
+void SoftTimer_Create(SoftTimer_t * pTimer, SoftTimer_Callback_t Callback, void * Context)
+{
+    pTimer->Next     = NULL;
+    pTimer->Prev     = NULL;
+    pTimer->Expires  = 0U;
+    pTimer->Period   = 0U;
+    pTimer->Callback = Callback;
+    pTimer->Context  = Context;
+    pTimer->Level    = 0U;
+    pTimer->Slot     = 0U;
+    pTimer->Armed    = FALSE;
+}
+
+/**
+ * @brief This function arms a timer, an armed timer is restarted. It can be called from any context.
+ *
+ * @param pTimer Pointer to the timer
+ * @param Timeout Ticks (ms) to the first expiry, 0 is handled as 1
+ * @param Period Ticks (ms) between the next expiries, 0 for a one-shot timer
+ *
+ * @return uint8_t TRUE on success, FALSE if Timeout or Period is above SOFTTIMER_MAX_TIMEOUT
+ */
+uint8_t SoftTimer_Start(SoftTimer_t * pTimer, uint32_t Timeout, uint32_t Period)
+{
+    uint32_t primask;
+
+    if ((Timeout > SOFTTIMER_MAX_TIMEOUT) || (Period > SOFTTIMER_MAX_TIMEOUT))
+    {
+        return FALSE;
+    }
+    if (Timeout == 0U)
+    {
+        Timeout = 1U;
+    }
+
+    primask = CM4_IRQSave();
+    if (pTimer->Armed == TRUE)
+    {
+        SoftTimer_Unlink(pTimer);
+        SoftTimer_ArmedCount--;
+    }
+    else if ((SoftTimer_ArmedCount == 0U) && (SoftTimer_Busy == FALSE))
+    {
+        /*Empty wheel: restart the time keeping from now, the time base may have wrapped around*/
+        SoftTimer_LastUs = Timebase_NowUs();
+        SoftTimer_Now += SoftTimer_Behind;
+        SoftTimer_Behind = 0U;
+    }
+    SoftTimer_Sync();
+    pTimer->Expires = SoftTimer_Now + SoftTimer_Behind + Timeout;
+    pTimer->Period  = Period;
+    SoftTimer_Insert(pTimer);
+    pTimer->Armed = TRUE;
+    SoftTimer_ArmedCount++;
+    if (SoftTimer_Busy == FALSE)
+    {
+        SoftTimer_Program();
+    }
+    CM4_IRQRestore(primask);
+
+    return TRUE;
+}
+
+/**
+ * @brief This function disarms a timer, it can be called from any context (also from its own callback).
+ *
+ * @param pTimer Pointer to the timer
+ */
+void SoftTimer_Stop(SoftTimer_t * pTimer)
+{
+    uint32_t primask;
+
+    primask = CM4_IRQSave();
+    if (pTimer->Armed == TRUE)
+    {
+        /*The alarm is left as it is, an early alarm only finds nothing to do*/
+        SoftTimer_Unlink(pTimer);
+        pTimer->Armed = FALSE;
+        SoftTimer_ArmedCount--;
+    }
+    CM4_IRQRestore(primask);
+}
+
+/**
+ * @brief This function checks if a timer is armed.
+ *
+ * @param pTimer Pointer to the timer
+ *
+ * @return uint8_t TRUE if the timer is armed, FALSE otherwise
+ */
+uint8_t SoftTimer_IsArmed(const SoftTimer_t * pTimer)
+{
+    return pTimer->Armed;
+}
+
+/**
+ * @brief This function gets the number of armed timers.
+ *
+ * @return uint32_t
+ */
+uint32_t SoftTimer_GetArmedCount(void)
+{
+    return SoftTimer_ArmedCount;
+}
+
+/**
+ * @brief This function handles the TIM7 alarm interrupt, it is called from the TIM7_IRQHandler.
+ *        It walks the wheel up to the current time and calls the callbacks of the expired timers.
+ *
+ */
+void SoftTimer_IRQHandling(void)
+{
+    SoftTimer_t * pTimer;
+    uint32_t primask, Ticks;
+
+    if (((SOFTTIMER_TIM->SR >> TIM_SR_UIF) & 0x01U) == BIT_SET)
+    {
+        SOFTTIMER_TIM->SR = ~(0x01U << TIM_SR_UIF);
+    }
+
+    primask = CM4_IRQSave();
+    SoftTimer_Busy = TRUE;
+    SoftTimer_Sync();
+    while (SoftTimer_Behind > 0U)
+    {
+        /*Skip the ticks without work*/
+        Ticks = SoftTimer_NextEvent();
+        if ((Ticks == 0U) || (Ticks > SoftTimer_Behind))
+        {
+            SoftTimer_Now += SoftTimer_Behind;
+            SoftTimer_Behind = 0U;
+            break;
+        }
+        SoftTimer_Now += Ticks;
+        SoftTimer_Behind -= Ticks;
+        SoftTimer_Cascade();
+
+        /*Expire the timers of the level 0 slot one by one, the callbacks may start or stop timers*/
+        while ((pTimer = SoftTimer_Slot[0][SoftTimer_Now & SOFTTIMER_SLOT_MASK]) != NULL)
+        {
+            SoftTimer_Unlink(pTimer);
+            if (pTimer->Period != 0U)
+            {
+                pTimer->Expires += pTimer->Period;
+                if ((int32_t)(pTimer->Expires - SoftTimer_Now) <= 0)
+                {
+                    /*Too late for the missed periods, keep the phase from now*/
+                    pTimer->Expires = SoftTimer_Now + 1U;
+                }
+                SoftTimer_Insert(pTimer);
+            }
+            else
+            {
+                pTimer->Armed = FALSE;
+                SoftTimer_ArmedCount--;
+            }
+            CM4_IRQRestore(primask);
+            pTimer->Callback(pTimer->Context);
+            primask = CM4_IRQSave();
+        }
+        /*Time spent in the callbacks*/
+        SoftTimer_Sync();
+    }
+    SoftTimer_Busy = FALSE;
+    SoftTimer_Program();
+    CM4_IRQRestore(primask);
+}
@@ -0,0 +1,711 @@
+#include "ssd1306.h"
+
+/*Init sequence of a 128x64 panel, the bytes depending on the configuration are set by SSD1306_Init*/
+static const uint8_t SSD1306_InitSeq[] =
+{
+    SSD1306_DISPLAY_OFF,
+    SSD1306_SET_CLOCK_DIV, 0x80U,                   /*Reset oscillator frequency, divide ratio 1*/
+    SSD1306_SET_MULTIPLEX, SSD1306_HEIGHT - 1U,
+    SSD1306_SET_DISPLAY_OFFSET, 0x00U,
+    SSD1306_SET_START_LINE | 0x00U,
+    SSD1306_CHARGE_PUMP, 0x14U,                     /*Index 9: charge pump*/
+    SSD1306_SET_MEMORY_MODE, 0x00U,                 /*Horizontal addressing, the frame is sent in one transfer*/
+    SSD1306_SEG_REMAP | 0x01U,                      /*Index 12: segment remap*/
+    SSD1306_COM_SCAN_DEC,                           /*Index 13: COM scan direction*/
+    SSD1306_SET_COM_PINS, 0x12U,
+    SSD1306_SET_CONTRAST, 0xCFU,                    /*Index 17: contrast*/
+    SSD1306_SET_PRECHARGE, 0xF1U,                   /*Index 19: precharge period*/
+    SSD1306_SET_VCOM_DETECT, 0x40U,
+    SSD1306_DISPLAY_RAM,
+    SSD1306_NORMAL_DISPLAY,
+    SSD1306_DEACTIVATE_SCROLL,
+    SSD1306_DISPLAY_ON,
+};
+#define SSD1306_SEQ_CHARGE_PUMP     9U
+#define SSD1306_SEQ_SEG_REMAP       12U
+#define SSD1306_SEQ_COM_SCAN        13U
+#define SSD1306_SEQ_CONTRAST        17U
+#define SSD1306_SEQ_PRECHARGE       19U
+_Static_assert(sizeof(SSD1306_InitSeq) <= SSD1306_CMD_MAX, "SSD1306_CMD_MAX is too small for the init sequence");
+
+static uint8_t SSD1306_SendSpan(SSD1306_t * pDisp, uint8_t PageStart, uint8_t PageEnd);
+
+/**
+ * @brief This function ends a flush, it updates the statistics and calls the flush callback.
+ *
+ * @param pDisp Display handle
+ * @param Status TRUE on success, FALSE on a bus error
+ */
+static void SSD1306_FlushEnd(SSD1306_t * pDisp, uint8_t Status)
+{
+    uint32_t Time;
+
+    if (Status == TRUE)
+    {
+        Time = Timebase_CyclesToUs(Timebase_ElapsedCycles(pDisp->FlushStart));
+        pDisp->Stats.FlushTimeLast = Time;
+        if (Time > pDisp->Stats.FlushTimeMax)
+        {
+            pDisp->Stats.FlushTimeMax = Time;
+        }
+        pDisp->Stats.FlushCount++;
+        pDisp->Stats.FlushBytesLast = pDisp->FlushBytes;
+        pDisp->Stats.FlushBytesTotal += pDisp->FlushBytes;
+    }
+    else
+    {
+        /*The display RAM content is not known anymore*/
+        pDisp->FullFlush = TRUE;
+    }
+    pDisp->State = SSD1306_STATE_IDLE;
+    if (pDisp->Conf.FlushDone != NULL)
+    {
+        pDisp->Conf.FlushDone(Status, pDisp->Conf.Context);
+    }
+}
+
+/**
+ * @brief This function finds the next page with a span to be sent by the running flush.
+ *
+ * @param pDisp Display handle
+ * @param Page First page to be checked
+ *
+ * @return uint8_t Page, SSD1306_PAGES if there is none
+ */
+static uint8_t SSD1306_FindSpan(const SSD1306_t * pDisp, uint8_t Page)
+{
+    while ((Page < SSD1306_PAGES) && (pDisp->SpanStart[Page] > pDisp->SpanEnd[Page]))
+    {
+        Page++;
+    }
+    return Page;
+}
+
+/**
+ * @brief This function is the completion callback of the bus transfers, it is called from the bus interrupt.
+ *        After the address window commands of a span it sends the span bytes, then the window of the next span.
+ *
+ * @param Status TRUE on success, FALSE on a bus error
+ * @param Context Display handle
+ */
+static void SSD1306_BusDone(uint8_t Status, void * Context)
+{
+    SSD1306_t * pDisp = (SSD1306_t *)Context;
+    uint8_t Page;
+
+    if (Status == FALSE)
+    {
+        pDisp->Stats.BusErrors++;
+    }
+    switch (pDisp->State)
+    {
+        case SSD1306_STATE_WINDOW:
+        {
+            if (Status == TRUE)
+            {
+                pDisp->State = SSD1306_STATE_DATA;
+                Status = pDisp->Conf.Bus.Write(pDisp->Conf.Bus.pBus, SSD1306_CTRL_DATA,
+                                               &pDisp->TxFrame[pDisp->SpanOffset], pDisp->SpanLength,
+                                               SSD1306_BusDone, pDisp);
+                if (Status == TRUE)
+                {
+                    break;
+                }
+                pDisp->Stats.BusErrors++;
+            }
+            SSD1306_FlushEnd(pDisp, FALSE);
+            break;
+        }
+        case SSD1306_STATE_DATA:
+        {
+            if (Status == TRUE)
+            {
+                Page = SSD1306_FindSpan(pDisp, pDisp->SpanPage + 1U);
+                if (Page < SSD1306_PAGES)
+                {
+                    if (SSD1306_SendSpan(pDisp, Page, Page) == TRUE)
+                    {
+                        break;
+                    }
+                    pDisp->Stats.BusErrors++;
+                    Status = FALSE;
+                }
+            }
+            SSD1306_FlushEnd(pDisp, Status);
+            break;
+        }
+        default:
+        {
+            pDisp->State = SSD1306_STATE_IDLE;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief This function sends the first Length bytes of the command buffer.
+ *
+ * @param pDisp Display handle
+ * @param Length Number of command bytes
+ * @param State State of the transfer (@ref SSD1306_State)
+ *
+ * @return uint8_t TRUE if the transfer is started, FALSE if the bus is busy
+ */
+static uint8_t SSD1306_SendCmd(SSD1306_t * pDisp, uint8_t Length, uint8_t State)
+{
+    pDisp->State = State;
+    if (pDisp->Conf.Bus.Write(pDisp->Conf.Bus.pBus, SSD1306_CTRL_CMD, pDisp->Cmd, Length,
+                              SSD1306_BusDone, pDisp) == FALSE)
+    {
+        pDisp->State = SSD1306_STATE_IDLE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function sends the address window of a span of the running flush, its bytes are sent by
+ *        SSD1306_BusDone. The columns are the span of PageStart (all the pages of a full frame).
+ *
+ * @param pDisp Display handle
+ * @param PageStart First page of the window
+ * @param PageEnd Last page of the window
+ *
+ * @return uint8_t TRUE if the transfer is started, FALSE if the bus is busy
+ */
+static uint8_t SSD1306_SendSpan(SSD1306_t * pDisp, uint8_t PageStart, uint8_t PageEnd)
+{
+    uint8_t ColStart = pDisp->SpanStart[PageStart];
+    uint8_t ColEnd = pDisp->SpanEnd[PageStart];
+
+    pDisp->SpanPage = PageEnd;
+    pDisp->SpanOffset = (PageStart * SSD1306_WIDTH) + ColStart;
+    pDisp->SpanLength = (uint16_t)(PageEnd - PageStart + 1U) * (uint16_t)(ColEnd - ColStart + 1U);
+    pDisp->FlushBytes += SSD1306_WINDOW_SIZE + pDisp->SpanLength;
+    pDisp->Cmd[0] = SSD1306_SET_COLUMN_ADDR;
+    pDisp->Cmd[1] = ColStart;
+    pDisp->Cmd[2] = ColEnd;
+    pDisp->Cmd[3] = SSD1306_SET_PAGE_ADDR;
+    pDisp->Cmd[4] = PageStart;
+    pDisp->Cmd[5] = PageEnd;
+    return SSD1306_SendCmd(pDisp, SSD1306_WINDOW_SIZE, SSD1306_STATE_WINDOW);
+}
+
+/**
+ * @brief This function widens the dirty column range of a page of the draw buffer.
+ *
+ * @param pDisp Display handle
+ * @param Page Page
+ * @param XStart First column
+ * @param XEnd Last column
+ */
+static void SSD1306_MarkDirty(SSD1306_t * pDisp, uint8_t Page, uint8_t XStart, uint8_t XEnd)
+{
+    if (XStart < pDisp->DirtyStart[Page])
+    {
+        pDisp->DirtyStart[Page] = XStart;
+    }
+    if (XEnd > pDisp->DirtyEnd[Page])
+    {
+        pDisp->DirtyEnd[Page] = XEnd;
+    }
+}
+
+/**
+ * @brief This function ORs a column of 8 pixels into the frame, Y is the row of bit 0.
+ *
+ * @param pDisp Display handle
+ * @param X Column, in the display
+ * @param Y Row of bit 0, from -7 to SSD1306_HEIGHT - 1
+ * @param Bits Pixels, bit n is the row Y + n
+ */
+static void SSD1306_OrColumn(SSD1306_t * pDisp, uint8_t X, int16_t Y, uint8_t Bits)
+{
+    uint8_t Page, Shift;
+
+    if (Y < 0)
+    {
+        pDisp->Frame[X] |= (uint8_t)(Bits >> (uint8_t)(-Y));
+        SSD1306_MarkDirty(pDisp, 0U, X, X);
+        return;
+    }
+    Page = (uint8_t)Y / 8U;
+    Shift = (uint8_t)Y % 8U;
+    pDisp->Frame[(Page * SSD1306_WIDTH) + X] |= (uint8_t)(Bits << Shift);
+    SSD1306_MarkDirty(pDisp, Page, X, X);
+    if ((Shift != 0U) && ((Page + 1U) < SSD1306_PAGES))
+    {
+        pDisp->Frame[((Page + 1U) * SSD1306_WIDTH) + X] |= (uint8_t)(Bits >> (8U - Shift));
+        SSD1306_MarkDirty(pDisp, Page + 1U, X, X);
+    }
+}
+
+/**
+ * @brief This function initializes the display: the init sequence is sent, then the display is turned on.
+ *        It returns at once and the frame buffers are cleared, SSD1306_UpdateScreen can be called once the init
+ *        sequence is sent.
+ *
+ * @param pDisp Display handle
+ * @param Conf Display configuration
+ *
+ * @return uint8_t TRUE on success, FALSE if the bus interface is missing or the bus is busy
+ */
+uint8_t SSD1306_Init(SSD1306_t * pDisp, SSD1306_Conf_t Conf)
+{
+    SSD1306_Stats_t Empty = {0};
+    uint16_t i;
+
+    if (Conf.Bus.Write == NULL)
+    {
+        return FALSE;
+    }
+    pDisp->Conf = Conf;
+    pDisp->State = SSD1306_STATE_IDLE;
+    pDisp->Stats = Empty;
+    /*All pages clean, the handle may be uninitialized memory and SSD1306_MarkDirty only widens the ranges*/
+    for (i = 0U; i < SSD1306_PAGES; i++)
+    {
+        pDisp->DirtyStart[i] = 0xFFU;
+        pDisp->DirtyEnd[i] = 0U;
+    }
+    /*The display RAM content is random after the power up*/
+    pDisp->FullFlush = TRUE;
+    SSD1306_Fill(pDisp, FALSE);
+    for (i = 0U; i < (SSD1306_FRAME_SIZE / 4U); i++)
+    {
+        ((uint32_t *)pDisp->TxFrame)[i] = 0U;
+    }
+
+    for (i = 0U; i < sizeof(SSD1306_InitSeq); i++)
+    {
+        pDisp->Cmd[i] = SSD1306_InitSeq[i];
+    }
+    if (Conf.ExternalVcc == TRUE)
+    {
+        pDisp->Cmd[SSD1306_SEQ_CHARGE_PUMP] = 0x10U;
+        pDisp->Cmd[SSD1306_SEQ_PRECHARGE] = 0x22U;
+    }
+    if (Conf.Flip == TRUE)
+    {
+        pDisp->Cmd[SSD1306_SEQ_SEG_REMAP] = SSD1306_SEG_REMAP;
+        pDisp->Cmd[SSD1306_SEQ_COM_SCAN] = SSD1306_COM_SCAN_INC;
+    }
+    pDisp->Cmd[SSD1306_SEQ_CONTRAST] = Conf.Contrast;
+
+    return SSD1306_SendCmd(pDisp, sizeof(SSD1306_InitSeq), SSD1306_STATE_CMD);
+}
+
+/**
+ * @brief This function sets the display contrast.
+ *
+ * @param pDisp Display handle
+ * @param Contrast Contrast (0 to 255)
+ *
+ * @return uint8_t TRUE if the command is started, FALSE if a transfer is running
+ */
+uint8_t SSD1306_SetContrast(SSD1306_t * pDisp, uint8_t Contrast)
+{
+    if (pDisp->State != SSD1306_STATE_IDLE)
+    {
+        return FALSE;
+    }
+    pDisp->Cmd[0] = SSD1306_SET_CONTRAST;
+    pDisp->Cmd[1] = Contrast;
+    return SSD1306_SendCmd(pDisp, 2U, SSD1306_STATE_CMD);
+}
+
+/**
+ * @brief This function turns the display on or off (sleep mode), the display RAM is kept.
+ *
+ * @param pDisp Display handle
+ * @param On TRUE to turn the display on, FALSE to turn it off
+ *
+ * @return uint8_t TRUE if the command is started, FALSE if a transfer is running
+ */
+uint8_t SSD1306_DisplayOn(SSD1306_t * pDisp, uint8_t On)
+{
+    if (pDisp->State != SSD1306_STATE_IDLE)
+    {
+        return FALSE;
+    }
+    pDisp->Cmd[0] = (On == TRUE) ? SSD1306_DISPLAY_ON : SSD1306_DISPLAY_OFF;
+    return SSD1306_SendCmd(pDisp, 1U, SSD1306_STATE_CMD);
+}
+
+/**
+ * @brief This function checks if a transfer (init, command or flush) is running.
+ *
+ * @param pDisp Display handle
+ *
+ * @return uint8_t TRUE if a transfer is running
+ */
+uint8_t SSD1306_IsBusy(const SSD1306_t * pDisp)
+{
+    return (pDisp->State != SSD1306_STATE_IDLE) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function sends the changes of the draw buffer to the display. The dirty ranges are trimmed to the
+ *        bytes that differ from the transfer buffer, the changed bytes are copied to it, then the address window
+ *        and the bytes of each changed page are sent by the bus (the whole frame when it costs less).
+ *        It returns at once, the draw buffer keeps its content and can be changed during the transfer.
+ *
+ * @note When nothing changed, the flush ends at once and FlushDone is called before the return.
+ *
+ * @param pDisp Display handle
+ *
+ * @return uint8_t TRUE if the flush is started, FALSE if a transfer is running or the bus is busy
+ */
+uint8_t SSD1306_UpdateScreen(SSD1306_t * pDisp)
+{
+    const uint32_t * pSrc = (const uint32_t *)pDisp->Frame;
+    uint32_t * pDst = (uint32_t *)pDisp->TxFrame;
+    uint16_t Base, Cost = 0U;
+    uint16_t i;
+    uint8_t Page, Start, End;
+
+    if (pDisp->State != SSD1306_STATE_IDLE)
+    {
+        return FALSE;
+    }
+    pDisp->FlushStart = Timebase_NowCycles();
+    pDisp->FlushBytes = 0U;
+    /*1. Trim the dirty ranges to the bytes changed since the last flush, the transfer buffer is the display RAM*/
+    for (Page = 0U; Page < SSD1306_PAGES; Page++)
+    {
+        Base = Page * SSD1306_WIDTH;
+        Start = pDisp->DirtyStart[Page];
+        End = pDisp->DirtyEnd[Page];
+        while ((Start <= End) && (pDisp->Frame[Base + Start] == pDisp->TxFrame[Base + Start]))
+        {
+            Start++;
+        }
+        while ((End > Start) && (pDisp->Frame[Base + End] == pDisp->TxFrame[Base + End]))
+        {
+            End--;
+        }
+        pDisp->SpanStart[Page] = Start;
+        pDisp->SpanEnd[Page] = End;
+        if (Start <= End)
+        {
+            Cost += SSD1306_WINDOW_SIZE + (End - Start) + 1U;
+        }
+        pDisp->DirtyStart[Page] = 0xFFU;
+        pDisp->DirtyEnd[Page] = 0U;
+    }
+    /*2. Whole frame when the display RAM is not known or when the spans cost more*/
+    if ((pDisp->FullFlush == TRUE) || (Cost >= (SSD1306_WINDOW_SIZE + SSD1306_FRAME_SIZE)))
+    {
+        for (i = 0U; i < (SSD1306_FRAME_SIZE / 4U); i++)
+        {
+            pDst[i] = pSrc[i];
+        }
+        pDisp->FullFlush = FALSE;
+        pDisp->Stats.FullFlushes++;
+        pDisp->SpanStart[0] = 0U;
+        pDisp->SpanEnd[0] = SSD1306_WIDTH - 1U;
+        if (SSD1306_SendSpan(pDisp, 0U, SSD1306_PAGES - 1U) == FALSE)
+        {
+            pDisp->FullFlush = TRUE;
+            return FALSE;
+        }
+        return TRUE;
+    }
+    /*3. Partial update, one window per changed page*/
+    for (Page = 0U; Page < SSD1306_PAGES; Page++)
+    {
+        Base = Page * SSD1306_WIDTH;
+        for (i = pDisp->SpanStart[Page]; i <= pDisp->SpanEnd[Page]; i++)
+        {
+            pDisp->TxFrame[Base + i] = pDisp->Frame[Base + i];
+        }
+    }
+    Page = SSD1306_FindSpan(pDisp, 0U);
+    if (Page == SSD1306_PAGES)
+    {
+        SSD1306_FlushEnd(pDisp, TRUE);
+        return TRUE;
+    }
+    if (SSD1306_SendSpan(pDisp, Page, Page) == FALSE)
+    {
+        pDisp->FullFlush = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function makes the next flush send the whole frame, e.g, after direct writes to the draw buffer
+ *        or a reset of the display.
+ *
+ * @param pDisp Display handle
+ */
+void SSD1306_Invalidate(SSD1306_t * pDisp)
+{
+    pDisp->FullFlush = TRUE;
+}
+
+/**
+ * @brief This function fills the whole draw buffer.
+ *
+ * @param pDisp Display handle
+ * @param On TRUE to light all the pixels, FALSE to clear them
+ */
+void SSD1306_Fill(SSD1306_t * pDisp, uint8_t On)
+{
+    uint32_t * pFrame = (uint32_t *)pDisp->Frame;
+    uint32_t Value = (On == TRUE) ? 0xFFFFFFFFUL : 0U;
+    uint16_t i;
+
+    for (i = 0U; i < (SSD1306_FRAME_SIZE / 4U); i++)
+    {
+        pFrame[i] = Value;
+    }
+    for (i = 0U; i < SSD1306_PAGES; i++)
+    {
+        SSD1306_MarkDirty(pDisp, (uint8_t)i, 0U, SSD1306_WIDTH - 1U);
+    }
+}
+
+/**
+ * @brief This function sets or clears a pixel of the draw buffer, the pixels out of the display are ignored.
+ *
+ * @param pDisp Display handle
+ * @param X Column (0 is the left)
+ * @param Y Row (0 is the top)
+ * @param On TRUE to light the pixel
+ */
+void SSD1306_DrawPixel(SSD1306_t * pDisp, uint8_t X, uint8_t Y, uint8_t On)
+{
+    uint8_t * pByte;
+
+    if ((X >= SSD1306_WIDTH) || (Y >= SSD1306_HEIGHT))
+    {
+        return;
+    }
+    pByte = &pDisp->Frame[((Y / 8U) * SSD1306_WIDTH) + X];
+    SSD1306_MarkDirty(pDisp, Y / 8U, X, X);
+    if (On == TRUE)
+    {
+        *pByte |= (uint8_t)(0x01U << (Y % 8U));
+    }
+    else
+    {
+        *pByte &= (uint8_t)~(0x01U << (Y % 8U));
+    }
+}
+
+/**
+ * @brief This function sets or clears a rectangle of the draw buffer, it is clipped to the display.
+ *
+ * @param pDisp Display handle
+ * @param X Left column
+ * @param Y Top row
+ * @param Width Width in pixels
+ * @param Height Height in pixels
+ * @param On TRUE to light the pixels
+ */
+void SSD1306_DrawFilledRectangle(SSD1306_t * pDisp, uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t On)
+{
+    uint16_t XEnd = (uint16_t)X + Width;
+    uint16_t YEnd = (uint16_t)Y + Height;
+    uint8_t Page, Mask, Col;
+    uint8_t * pRow;
+
+    if ((X >= SSD1306_WIDTH) || (Y >= SSD1306_HEIGHT) || (Width == 0U) || (Height == 0U))
+    {
+        return;
+    }
+    XEnd = (XEnd > SSD1306_WIDTH) ? SSD1306_WIDTH : XEnd;
+    YEnd = (YEnd > SSD1306_HEIGHT) ? SSD1306_HEIGHT : YEnd;
+    for (Page = Y / 8U; (Page * 8U) < YEnd; Page++)
+    {
+        /*Rows of the rectangle in this page*/
+        Mask = 0xFFU;
+        if ((Page * 8U) < Y)
+        {
+            Mask &= (uint8_t)(0xFFU << (Y % 8U));
+        }
+        if (((Page + 1U) * 8U) > YEnd)
+        {
+            Mask &= (uint8_t)(0xFFU >> (((Page + 1U) * 8U) - YEnd));
+        }
+        pRow = &pDisp->Frame[Page * SSD1306_WIDTH];
+        SSD1306_MarkDirty(pDisp, Page, X, (uint8_t)(XEnd - 1U));
+        for (Col = X; Col < XEnd; Col++)
+        {
+            pRow[Col] = (On == TRUE) ? (pRow[Col] | Mask) : (pRow[Col] & (uint8_t)~Mask);
+        }
+    }
+}
+
+/**
+ * @brief This function draws a bitmap in the draw buffer, its lit pixels are ORed (the others are transparent).
+ *        The bitmap uses the display layout: (Height + 7) / 8 pages of Width bytes, bit n of a byte is the row
+ *        page * 8 + n. It is clipped to the display, so a sprite can enter from any edge.
+ *
+ * @param pDisp Display handle
+ * @param X Left column, can be negative
+ * @param Y Top row, can be negative
+ * @param pBitmap Bitmap
+ * @param Width Width in pixels
+ * @param Height Height in pixels
+ */
+void SSD1306_DrawSprite(SSD1306_t * pDisp, int16_t X, int16_t Y, const uint8_t * pBitmap, uint8_t Width, uint8_t Height)
+{
+    uint8_t Pages = (Height + 7U) / 8U;
+    uint8_t Page, Col, Bits;
+    int16_t Dx, Dy;
+
+    for (Page = 0U; Page < Pages; Page++)
+    {
+        Dy = Y + (int16_t)(Page * 8U);
+        if ((Dy <= -8) || (Dy >= (int16_t)SSD1306_HEIGHT))
+        {
+            continue;
+        }
+        for (Col = 0U; Col < Width; Col++)
+        {
+            Dx = X + (int16_t)Col;
+            if ((Dx < 0) || (Dx >= (int16_t)SSD1306_WIDTH))
+            {
+                continue;
+            }
+            Bits = pBitmap[(Page * Width) + Col];
+            if (((Page + 1U) * 8U) > Height)
+            {
+                /*Last page, drop the rows below the bitmap*/
+                Bits &= (uint8_t)(0xFFU >> (((Page + 1U) * 8U) - Height));
+            }
+            SSD1306_OrColumn(pDisp, (uint8_t)Dx, Dy, Bits);
+        }
+    }
+}
+
+/**
+ * @brief This function gets the flush statistics.
+ *
+ * @param pDisp Display handle
+ *
+ * @return const SSD1306_Stats_t*
+ */
+const SSD1306_Stats_t * SSD1306_GetStats(const SSD1306_t * pDisp)
+{
+    return &pDisp->Stats;
+}
+
+/**
+ * @brief This function is called from the I2C interrupt when a transfer of the display ends.
+ *
+ * @param pXfer Transfer of the display, its Context is the bus interface
+ */
+static void SSD1306_I2C_Done(I2C_Transfer_t * pXfer)
+{
+    SSD1306_I2C_t * pI2C = (SSD1306_I2C_t *)pXfer->Context;
+
+    if (pI2C->Done != NULL)
+    {
+        pI2C->Done((pXfer->Status == I2C_STATUS_OK) ? TRUE : FALSE, pI2C->Context);
+    }
+}
+
+/**
+ * @brief This function is the I2C bus interface (SSD1306_Bus_t Write): the bytes are queued on the I2C
+ *        as one transfer, the control byte first. The frame data is moved by DMA when the I2C uses it.
+ *
+ * @param pBus I2C bus interface (SSD1306_I2C_t)
+ * @param Control Kind of the bytes, @ref SSD1306_Control
+ * @param pData Bytes to be sent
+ * @param Length Number of bytes
+ * @param Done Called from the I2C interrupt when the bytes are sent
+ * @param Context Given to Done
+ *
+ * @return uint8_t TRUE if the transfer is queued, FALSE if the previous one is not finished
+ */
+uint8_t SSD1306_I2C_Write(void * pBus, uint8_t Control, const uint8_t * pData, uint16_t Length,
+                          SSD1306_Done_t Done, void * Context)
+{
+    SSD1306_I2C_t * pI2C = (SSD1306_I2C_t *)pBus;
+    I2C_Transfer_t * pXfer = &pI2C->Xfer;
+
+    if (pXfer->Status == I2C_STATUS_PENDING)
+    {
+        return FALSE;
+    }
+    pI2C->Done = Done;
+    pI2C->Context = Context;
+    pXfer->Address = pI2C->Address;
+    pXfer->Header[0] = Control;
+    pXfer->HeaderLength = 1U;
+    pXfer->pTxData = pData;
+    pXfer->TxLength = Length;
+    pXfer->pRxData = NULL;
+    pXfer->RxLength = 0U;
+    pXfer->Done = SSD1306_I2C_Done;
+    pXfer->Context = pI2C;
+    return I2C_Submit(pI2C->I2Cx, pXfer);
+}
+
+/**
+ * @brief This function is called by the SPI driver when a transfer of the display starts: the D/C# pin
+ *        selects commands or display RAM data.
+ *
+ * @param pXfer Transfer of the display, its Context is the bus interface
+ */
+static void SSD1306_SPI_Begin(SPI_Transfer_t * pXfer)
+{
+    SSD1306_SPI_t * pSPI = (SSD1306_SPI_t *)pXfer->Context;
+
+    GPIO_PinWrite(pSPI->pDcPort, pSPI->DcPin, (pSPI->Control == SSD1306_CTRL_DATA) ? BIT_SET : BIT_RESET);
+}
+
+/**
+ * @brief This function is called from the SPI interrupt when a transfer of the display ends.
+ *
+ * @param pXfer Transfer of the display, its Context is the bus interface
+ */
+static void SSD1306_SPI_Done(SPI_Transfer_t * pXfer)
+{
+    SSD1306_SPI_t * pSPI = (SSD1306_SPI_t *)pXfer->Context;
+
+    if (pSPI->Done != NULL)
+    {
+        pSPI->Done((pXfer->Status == SPI_STATUS_OK) ? TRUE : FALSE, pSPI->Context);
+    }
+}
+
+/**
+ * @brief This function is the SPI bus interface (SSD1306_Bus_t Write): the bytes are queued on the SPI
+ *        as one transmit only transfer. The frame data is moved by DMA when the SPI uses it.
+ *
+ * @param pBus SPI bus interface (SSD1306_SPI_t)
+ * @param Control Kind of the bytes, @ref SSD1306_Control
+ * @param pData Bytes to be sent
+ * @param Length Number of bytes
+ * @param Done Called from the SPI interrupt when the bytes are sent
+ * @param Context Given to Done
+ *
+ * @return uint8_t TRUE if the transfer is queued, FALSE if the previous one is not finished
+ */
+uint8_t SSD1306_SPI_Write(void * pBus, uint8_t Control, const uint8_t * pData, uint16_t Length,
+                          SSD1306_Done_t Done, void * Context)
+{
+    SSD1306_SPI_t * pSPI = (SSD1306_SPI_t *)pBus;
+    SPI_Transfer_t * pXfer = &pSPI->Xfer;
+
+    if (pXfer->Status == SPI_STATUS_PENDING)
+    {
+        return FALSE;
+    }
+    pSPI->Control = Control;
+    pSPI->Done = Done;
+    pSPI->Context = Context;
+    pXfer->pDevice = &pSPI->Device;
+    pXfer->pTxData = pData;
+    pXfer->pRxData = NULL;
+    pXfer->Length = Length;
+    pXfer->Begin = SSD1306_SPI_Begin;
+    pXfer->Done = SSD1306_SPI_Done;
+    pXfer->Context = pSPI;
+    return SPI_Submit(pSPI->SPIx, pXfer);
+}
@@ -0,0 +1,216 @@
+#include "stm32f407xx_dma_driver.h"
+
+/*Bit offset of the stream flags in the LISR/HISR and LIFCR/HIFCR registers*/
+static const uint8_t DMA_FlagOffset[4] = {0U, 6U, 16U, 22U};
+
+/*Stream callback table*/
+static DMA_Callback_t DMA_Callback[2][8];
+static void * DMA_CallbackContext[2][8];
+
+/**
+ * @brief This function initializes a DMA stream according to the specified settings.
+ *        The stream is disabled before being configured.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param DMA_Conf Structer that contains the configuration information of the stream
+ */
+void DMA_Init(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Conf_t DMA_Conf)
+{
+    DMA_Stream_RegDef_t * pStream = &DMAx->S[Stream];
+    uint32_t temp = 0;
+
+    /*1. Disable the stream and wait until it is really disabled*/
+    DMA_Stop(DMAx, Stream);
+    /*2. Build the stream configuration*/
+    temp |= ((uint32_t)DMA_Conf.Channel << DMA_SXCR_CHSEL);
+    temp |= ((uint32_t)DMA_Conf.Priority << DMA_SXCR_PL);
+    temp |= ((uint32_t)DMA_Conf.MemDataSize << DMA_SXCR_MSIZE);
+    temp |= ((uint32_t)DMA_Conf.PeriphDataSize << DMA_SXCR_PSIZE);
+    temp |= ((uint32_t)DMA_Conf.MemInc << DMA_SXCR_MINC);
+    temp |= ((uint32_t)DMA_Conf.PeriphInc << DMA_SXCR_PINC);
+    temp |= ((uint32_t)DMA_Conf.Mode << DMA_SXCR_CIRC);
+    temp |= ((uint32_t)DMA_Conf.Direction << DMA_SXCR_DIR);
+    pStream->CR = temp;
+    /*3. Use the direct mode (FIFO disabled)*/
+    pStream->FCR = 0U;
+    /*4. Clear the stale flags of the stream*/
+    DMA_ClearFlags(DMAx, Stream, DMA_FLAG_ALL);
+}
+
+/**
+ * @brief This function starts a transfer on a configured DMA stream.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param PeriphAddr Peripheral (or source memory in memory to memory mode) address
+ * @param MemAddr Memory address
+ * @param Length Number of data items to transfer
+ */
+void DMA_Start(DMA_RegDef_t * DMAx, uint8_t Stream, uint32_t PeriphAddr, uint32_t MemAddr, uint16_t Length)
+{
+    DMA_Stream_RegDef_t * pStream = &DMAx->S[Stream];
+
+    /*The flags of the previous transfer must be cleared before enabling the stream*/
+    DMA_ClearFlags(DMAx, Stream, DMA_FLAG_ALL);
+    pStream->PAR  = PeriphAddr;
+    pStream->M0AR = MemAddr;
+    pStream->NDTR = Length;
+    pStream->CR |= (0x01U << DMA_SXCR_EN);
+}
+
+/**
+ * @brief This function stops a DMA stream and waits until the on-going transfer is finished.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ */
+void DMA_Stop(DMA_RegDef_t * DMAx, uint8_t Stream)
+{
+    DMA_Stream_RegDef_t * pStream = &DMAx->S[Stream];
+
+    pStream->CR &= ~(0x01U << DMA_SXCR_EN);
+    while (((pStream->CR >> DMA_SXCR_EN) & 0x01U) == BIT_SET)
+    {
+        /*The current data item transfer is completed before the stream is disabled*/
+    }
+}
+
+/**
+ * @brief This function changes the memory increment and the data size of a stopped stream, the other
+ *        settings (channel, direction, interrupt enables) are kept. It lets one stream serve transfers
+ *        of several formats (e.g, an SPI sending 8 or 16 bit frames from a buffer or a constant).
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param MemInc Memory increment, @ref DMA_Increment
+ * @param DataSize Peripheral and memory data size, @ref DMA_Data_Size
+ */
+void DMA_SetDataFormat(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t MemInc, uint8_t DataSize)
+{
+    DMA_Stream_RegDef_t * pStream = &DMAx->S[Stream];
+    uint32_t temp = pStream->CR;
+
+    temp &= ~((0x01U << DMA_SXCR_MINC) | (0x03U << DMA_SXCR_PSIZE) | (0x03U << DMA_SXCR_MSIZE));
+    temp |= ((uint32_t)MemInc << DMA_SXCR_MINC);
+    temp |= ((uint32_t)DataSize << DMA_SXCR_PSIZE);
+    temp |= ((uint32_t)DataSize << DMA_SXCR_MSIZE);
+    pStream->CR = temp;
+}
+
+/**
+ * @brief This function gets the number of data items remaining in the current transfer.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ *
+ * @return uint16_t Remaining data items
+ */
+uint16_t DMA_GetCounter(DMA_RegDef_t * DMAx, uint8_t Stream)
+{
+    return (uint16_t)DMAx->S[Stream].NDTR;
+}
+
+/**
+ * @brief This function gets the interrupt flags of a DMA stream.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ *
+ * @return uint8_t Flags of the stream, a combination of @ref DMA_Flags
+ */
+uint8_t DMA_GetFlags(DMA_RegDef_t * DMAx, uint8_t Stream)
+{
+    uint32_t ISR;
+
+    ISR = (Stream < 4U) ? DMAx->LISR : DMAx->HISR;
+
+    return (uint8_t)((ISR >> DMA_FlagOffset[Stream % 4U]) & DMA_FLAG_ALL);
+}
+
+/**
+ * @brief This function clears interrupt flags of a DMA stream.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param Flags Flags to be cleared, a combination of @ref DMA_Flags
+ */
+void DMA_ClearFlags(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Flags)
+{
+    uint32_t Mask;
+
+    Mask = ((uint32_t)(Flags & DMA_FLAG_ALL) << DMA_FlagOffset[Stream % 4U]);
+    /*Writing 1 clears the flag, writing 0 has no effect*/
+    if (Stream < 4U)
+    {
+        DMAx->LIFCR = Mask;
+    }
+    else
+    {
+        DMAx->HIFCR = Mask;
+    }
+}
+
+/**
+ * @brief This function enables interrupts of a DMA stream and its IRQ in the NVIC.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param Flags Interrupt sources to be enabled, a combination of DMA_FLAG_TE, DMA_FLAG_HT, DMA_FLAG_TC
+ * @param Priority Interrupt priority to be set
+ */
+void DMA_IT_Init(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Flags, uint8_t Priority)
+{
+    DMA_Stream_RegDef_t * pStream = &DMAx->S[Stream];
+
+    if (Flags & DMA_FLAG_TE)
+    {
+        pStream->CR |= (0x01U << DMA_SXCR_TEIE);
+    }
+    if (Flags & DMA_FLAG_HT)
+    {
+        pStream->CR |= (0x01U << DMA_SXCR_HTIE);
+    }
+    if (Flags & DMA_FLAG_TC)
+    {
+        pStream->CR |= (0x01U << DMA_SXCR_TCIE);
+    }
+    /* Set the interrupt priority for the stream */
+    NVIC_SetPriority(DMA_STREAM_TO_IRQ(DMAx, Stream), Priority);
+    /* Enable the IRQ of the stream */
+    NVIC_EnableIRQ(DMA_STREAM_TO_IRQ(DMAx, Stream));
+}
+
+/**
+ * @brief This function registers the function called by DMA_IRQHandling for a DMA stream.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ * @param Callback Function to be called, NULL to disable
+ * @param Context User pointer passed back to the callback
+ */
+void DMA_RegisterCallback(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Callback_t Callback, void * Context)
+{
+    DMA_CallbackContext[DMAx_TO_INDEX(DMAx)][Stream] = Context;
+    DMA_Callback[DMAx_TO_INDEX(DMAx)][Stream] = Callback;
+}
+
+/**
+ * @brief This function handles the interrupt of a DMA stream.
+ *        It must be called from the DMAx_Streamy_IRQHandler.
+ *
+ * @param DMAx Pointer to the DMA controller (DMA1 or DMA2).
+ * @param Stream Stream number [0..7]
+ */
+void DMA_IRQHandling(DMA_RegDef_t * DMAx, uint8_t Stream)
+{
+    uint8_t Flags;
+    uint8_t Index = DMAx_TO_INDEX(DMAx);
+
+    Flags = DMA_GetFlags(DMAx, Stream);
+    DMA_ClearFlags(DMAx, Stream, Flags);
+    if ((Flags != 0U) && (DMA_Callback[Index][Stream] != NULL))
+    {
+        DMA_Callback[Index][Stream](Flags, DMA_CallbackContext[Index][Stream]);
+    }
+}
@@ -1,5 +1,8 @@
 #include "stm32f407xx_gpio_driver.h"
 
+/*Dispatch state of the EXTI lines 0 to 15*/
+static GPIO_EXTI_Line_t GPIO_EXTI_Line[GPIO_EXTI_LINE_NUM];
+
 /**
  * @brief This function initilize GPIOx peripheral
  * 
@@ -12,10 +15,17 @@ void GPIO_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t PinConf)
     GPIOx->MODER &= ~(0x03 << PinConf.GPIO_PinNumber * 2);
     GPIOx->MODER |= (PinConf.GPIO_PinMode << PinConf.GPIO_PinNumber * 2);
 
-    /*Initialize output type*/
-    if (PinConf.GPIO_PinMode == GPIO_MODE_OUTPUT)
+    /*Initialize pull-up/pull-down*/
+    GPIOx->PUPDR &= ~(0x03 << PinConf.GPIO_PinNumber * 2);
+    GPIOx->PUPDR |= ((PinConf.GPIO_PUPD & 0x03) << PinConf.GPIO_PinNumber * 2);
+
+    /*Initialize output type and speed*/
+    if ((PinConf.GPIO_PinMode == GPIO_MODE_OUTPUT) || (PinConf.GPIO_PinMode == GPIO_MODE_ALT))
     {
-        GPIOx->OTYPER |= (PinConf.GPIO_OutType << PinConf.GPIO_PinNumber);
+        GPIOx->OTYPER &= ~(0x01 << PinConf.GPIO_PinNumber);
+        GPIOx->OTYPER |= ((PinConf.GPIO_OutType & 0x01) << PinConf.GPIO_PinNumber);
+        GPIOx->OSPEEDR &= ~(0x03 << PinConf.GPIO_PinNumber * 2);
+        GPIOx->OSPEEDR |= ((PinConf.GPIO_Speed & 0x03) << PinConf.GPIO_PinNumber * 2);
     }
 
     if (PinConf.GPIO_PinMode == GPIO_MODE_ALT)
@@ -35,21 +45,35 @@ void GPIO_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t PinConf)
     }
 }
 
+/**
+ * @brief This function writes an output pin with a single BSRR store, it is safe against the interrupts
+ *        writing the other pins of the port.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param PinNumber GPIO pin number
+ * @param Value BIT_SET or BIT_RESET
+ */
 void GPIO_PinWrite(GPIO_RegDef_t * GPIOx, uint8_t PinNumber, uint8_t Value)
 {
     if (Value == BIT_SET)
     {
-        GPIOx->ODR |= (0x01 << PinNumber);
+        GPIOx->BSRR = GPIO_PIN_MASK(PinNumber);
     }
     else
     {
-        GPIOx->ODR &= ~(0x01 << PinNumber);
+        GPIOx->BSRR = ((uint32_t)GPIO_PIN_MASK(PinNumber) << GPIO_BSRR_RESET_POS);
     }
 }
 
+/**
+ * @brief This function toggles an output pin, the new level is written with a single BSRR store.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param PinNumber GPIO pin number
+ */
 void GPIO_PinToggle(GPIO_RegDef_t * GPIOx, uint8_t PinNumber)
 {
-    GPIOx->ODR ^= (0x01 << PinNumber);
+    GPIO_PortToggleMask(GPIOx, GPIO_PIN_MASK(PinNumber));
 }
 
 uint8_t GPIO_PinRead(GPIO_RegDef_t * GPIOx, uint8_t PinNumber)
@@ -61,6 +85,66 @@ uint8_t GPIO_PinRead(GPIO_RegDef_t * GPIOx, uint8_t PinNumber)
     return ret;
 }
 
+/**
+ * @brief This function writes several output pins of a port in one BSRR store, the other pins are not changed.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param Mask Pins to be written (bit n = pin n)
+ * @param Value New levels of the pins in Mask (bit n = pin n)
+ */
+void GPIO_PortWrite(GPIO_RegDef_t * GPIOx, uint16_t Mask, uint16_t Value)
+{
+    GPIOx->BSRR = ((uint32_t)(Mask & ~Value) << GPIO_BSRR_RESET_POS) | (uint32_t)(Mask & Value);
+}
+
+/**
+ * @brief This function sets several output pins of a port in one BSRR store.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param Mask Pins to be set (bit n = pin n)
+ */
+void GPIO_PortSetMask(GPIO_RegDef_t * GPIOx, uint16_t Mask)
+{
+    GPIOx->BSRR = Mask;
+}
+
+/**
+ * @brief This function resets several output pins of a port in one BSRR store.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param Mask Pins to be reset (bit n = pin n)
+ */
+void GPIO_PortClearMask(GPIO_RegDef_t * GPIOx, uint16_t Mask)
+{
+    GPIOx->BSRR = ((uint32_t)Mask << GPIO_BSRR_RESET_POS);
+}
+
+/**
+ * @brief This function toggles several output pins of a port, the new levels are written in one BSRR store.
+ *        Only an interrupt writing the same pins between the ODR read and the store is lost.
+ * 
+ * @param GPIOx GPIO peripheral
+ * @param Mask Pins to be toggled (bit n = pin n)
+ */
+void GPIO_PortToggleMask(GPIO_RegDef_t * GPIOx, uint16_t Mask)
+{
+    uint32_t Odr = GPIOx->ODR;
+
+    GPIOx->BSRR = ((Odr & Mask) << GPIO_BSRR_RESET_POS) | (~Odr & Mask);
+}
+
+/**
+ * @brief This function reads the input levels of all the pins of a port.
+ * 
+ * @param GPIOx GPIO peripheral
+ * 
+ * @return uint16_t Input levels (bit n = pin n)
+ */
+uint16_t GPIO_PortRead(GPIO_RegDef_t * GPIOx)
+{
+    return (uint16_t)GPIOx->IDR;
+}
+
 void GPIO_IT_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t GPIOPinConf, uint8_t Priority)
 {
     uint8_t index, bitpos, portcode;
@@ -118,4 +202,140 @@ void GPIO_IT_Init(GPIO_RegDef_t * GPIOx, GPIO_PinConf_t GPIOPinConf, uint8_t Pri
     NVIC_SetPriority(GPIO_PIN_TO_IRQ(GPIOPinConf.GPIO_PinNumber), Priority);
     /*3.2 Enable interrupt request*/
     NVIC_EnableIRQ(GPIO_PIN_TO_IRQ(GPIOPinConf.GPIO_PinNumber));
-}
\ No newline at end of file
+}
+
+/**
+ * @brief This function sets the callback of an EXTI line, the line itself is configured by GPIO_IT_Init or Board_Init.
+ *        The edge timestamp and the hit counter are cleared.
+ *
+ * @param Line EXTI line (pin number)
+ * @param Callback Function called from the EXTI interrupt on each edge
+ * @param Context Given to the callback
+ *
+ * @return uint8_t TRUE on success, FALSE if a parameter is not valid
+ */
+uint8_t GPIO_EXTI_Register(uint8_t Line, GPIO_EXTI_Callback_t Callback, void * Context)
+{
+    uint32_t primask;
+
+    if ((Line >= GPIO_EXTI_LINE_NUM) || (Callback == NULL))
+    {
+        return FALSE;
+    }
+    /*The callback and its context are changed together, the interrupt never sees a mix of both*/
+    primask = CM4_IRQSave();
+    GPIO_EXTI_Line[Line].Callback  = Callback;
+    GPIO_EXTI_Line[Line].Context   = Context;
+    GPIO_EXTI_Line[Line].EdgeStamp = 0U;
+    GPIO_EXTI_Line[Line].HitCount  = 0U;
+    CM4_IRQRestore(primask);
+
+    return TRUE;
+}
+
+/**
+ * @brief This function removes the callback of an EXTI line, its edges are still cleared and counted.
+ *
+ * @param Line EXTI line (pin number)
+ *
+ * @return uint8_t TRUE on success, FALSE if Line is not valid
+ */
+uint8_t GPIO_EXTI_Unregister(uint8_t Line)
+{
+    if (Line >= GPIO_EXTI_LINE_NUM)
+    {
+        return FALSE;
+    }
+    GPIO_EXTI_Line[Line].Callback = NULL;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the dispatch state of an EXTI line: last edge timestamp and hit counter.
+ *
+ * @param Line EXTI line (pin number)
+ *
+ * @return const GPIO_EXTI_Line_t* Dispatch state, NULL if Line is not valid
+ */
+const GPIO_EXTI_Line_t * GPIO_EXTI_GetLine(uint8_t Line)
+{
+    if (Line >= GPIO_EXTI_LINE_NUM)
+    {
+        return NULL;
+    }
+
+    return &GPIO_EXTI_Line[Line];
+}
+
+/**
+ * @brief This function dispatches the pending EXTI lines of a vector, it is called from the EXTIx_IRQHandler.
+ *        The pending bits are cleared in one write before the callbacks are called, lowest line first.
+ *
+ * @param Lines EXTI lines of the vector (bit n = line n)
+ */
+void GPIO_EXTI_IRQHandling(uint16_t Lines)
+{
+    GPIO_EXTI_Line_t * pLine;
+    GPIO_EXTI_Callback_t Callback;
+    uint32_t Pending, Stamp;
+    uint8_t Line;
+
+    Pending = EXTI->PR & Lines;
+    EXTI->PR = Pending;
+    Stamp = DWT->CYCCNT;
+    while (Pending != 0U)
+    {
+        Line = (uint8_t)__builtin_ctz(Pending);
+        Pending &= (Pending - 1U);
+        pLine = &GPIO_EXTI_Line[Line];
+        pLine->EdgeStamp = Stamp;
+        pLine->HitCount++;
+        Callback = pLine->Callback;
+        if (Callback != NULL)
+        {
+            Callback(Line, pLine->Context);
+        }
+    }
+}
+
+#if (GPIO_EXTI_VECTORS == 1)
+/**
+ * @brief These are the interrupt service routines for the EXTI lines 0 to 15.
+ *
+ */
+void EXTI0_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_PIN_MASK(0U));
+}
+
+void EXTI1_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_PIN_MASK(1U));
+}
+
+void EXTI2_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_PIN_MASK(2U));
+}
+
+void EXTI3_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_PIN_MASK(3U));
+}
+
+void EXTI4_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_PIN_MASK(4U));
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_EXTI_LINES_9_5);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    GPIO_EXTI_IRQHandling(GPIO_EXTI_LINES_15_10);
+}
+#endif
@@ -0,0 +1,921 @@
+#include "stm32f407xx_i2c_driver.h"
+#include "timebase.h"
+#include "work_queue.h"
+
+/*I2C_Phase: step of the running transfer*/
+#define I2C_PHASE_IDLE              0U      /*No transfer*/
+#define I2C_PHASE_START_TX          1U      /*START sent, the address is sent in write mode*/
+#define I2C_PHASE_TX                2U      /*Header and data bytes written by the event interrupt*/
+#define I2C_PHASE_TX_DMA            3U      /*Data bytes written by DMA*/
+#define I2C_PHASE_START_RX          4U      /*(Repeated) START sent, the address is sent in read mode*/
+#define I2C_PHASE_RX                5U      /*Data bytes read by the event interrupt*/
+#define I2C_PHASE_RX_DMA            6U      /*Data bytes read by DMA*/
+
+/*Index of the stream and channel values in an I2C_DMA_STREAMS entry*/
+#define I2C_DMA_TX_STREAM           0U
+#define I2C_DMA_TX_CHANNEL          1U
+#define I2C_DMA_RX_STREAM           2U
+#define I2C_DMA_RX_CHANNEL          3U
+
+/*Maximum number of status reads while the previous STOP is being sent*/
+#define I2C_STOP_WAIT_MAX           1000U
+/*Half period of the SCL pulses of the bus recovery in us (100 kHz)*/
+#define I2C_RECOVERY_HALF_PERIOD    5U
+
+#if defined(I2C_HOST_MOCK)
+/*The host build runs everything on one thread*/
+#define I2C_LOCK()                  0U
+#define I2C_UNLOCK(State)           ((void)(State))
+#else
+#define I2C_LOCK()                  CM4_IRQSave()
+#define I2C_UNLOCK(State)           CM4_IRQRestore(State)
+#endif
+
+/*Driver state of one I2C*/
+typedef struct
+{
+    I2C_Conf_t Conf;
+    uint8_t Initialized;
+    uint8_t Phase;                      /*@ref I2C_Phase*/
+    uint8_t Recovering;                 /*Bus recovery posted after a bus error, the queue waits for it*/
+    uint16_t Index;                     /*Bytes of the current part written (header included) or read*/
+    uint16_t Queued;                    /*Number of transfers waiting in the queue*/
+    I2C_Transfer_t * pCurrent;          /*Running transfer, NULL when the bus is idle*/
+    I2C_Transfer_t * pHead;             /*Queue of the waiting transfers*/
+    I2C_Transfer_t * pTail;
+    uint32_t StartCycles;               /*Timebase_NowCycles value at the start of the running transfer*/
+    I2C_Stats_t Stats;
+} I2C_State_t;
+
+/*Driver state of each I2C*/
+static I2C_State_t I2C_State[I2C_INSTANCE_NUM];
+/*I2Cs of the driver state tables, in the I2Cx_TO_INDEX order*/
+static I2C_RegDef_t * const I2C_Instance[I2C_INSTANCE_NUM] = {I2C1, I2C2, I2C3};
+/*DMA1 streams and channels of each I2C*/
+static const uint8_t I2C_DmaMap[I2C_INSTANCE_NUM][4] = I2C_DMA_STREAMS;
+/*The clock change callback is registered once*/
+static uint8_t I2C_ClockCallbackRegistered = FALSE;
+
+static void I2C_StartTransfer(I2C_RegDef_t * I2Cx, I2C_State_t * pState);
+static void I2C_StartNext(I2C_RegDef_t * I2Cx, I2C_State_t * pState);
+
+/**
+ * @brief This function writes one byte in the data register.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param Data Byte to be sent
+ */
+static void I2C_WriteData(I2C_RegDef_t * I2Cx, uint8_t Data)
+{
+    I2Cx->DR = Data;
+#if defined(I2C_HOST_MOCK)
+    I2C_MockDataWritten(I2Cx);
+#endif
+}
+
+/**
+ * @brief This function reads one byte from the data register.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ *
+ * @return uint8_t Received byte
+ */
+static uint8_t I2C_ReadData(I2C_RegDef_t * I2Cx)
+{
+    uint8_t Data = (uint8_t)I2Cx->DR;
+
+#if defined(I2C_HOST_MOCK)
+    I2C_MockDataRead(I2Cx);
+#endif
+    return Data;
+}
+
+/**
+ * @brief This function clears the ADDR flag (SR1 read followed by a SR2 read), the clock stretching stops.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ */
+static void I2C_ClearAddr(I2C_RegDef_t * I2Cx)
+{
+    uint32_t temp;
+
+    temp = I2Cx->SR1;
+    temp = I2Cx->SR2;
+    (void)temp;
+#if defined(I2C_HOST_MOCK)
+    I2C_MockAddrCleared(I2Cx);
+#endif
+}
+
+/**
+ * @brief This function sets the clock control registers for the configured speed from the current PCLK1
+ *        and enables the peripheral.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pConf Configuration of the I2C
+ *
+ * @return uint8_t TRUE on success, FALSE if the speed or PCLK1 is out of range
+ */
+static uint8_t I2C_SetTiming(I2C_RegDef_t * I2Cx, const I2C_Conf_t * pConf)
+{
+    uint32_t Pclk = RCC_GetPCLK1Val();
+    uint32_t FreqMHz = Pclk / 1000000U;
+    uint32_t Ccr;
+
+    /*FREQ range [2..42] MHz, 4 MHz at least for the fast mode*/
+    if ((pConf->ClockSpeed == 0U) || (pConf->ClockSpeed > I2C_SPEED_FAST) || (FreqMHz < 2U) || (FreqMHz > 42U)
+        || ((pConf->ClockSpeed > I2C_SPEED_STANDARD) && (FreqMHz < 4U)))
+    {
+        return FALSE;
+    }
+    /*The clock registers are written with the peripheral disabled*/
+    I2Cx->CR1 &= ~(0x01U << I2C_CR1_PE);
+    I2Cx->CR2 = (I2Cx->CR2 & ~(0x3FU << I2C_CR2_FREQ)) | (FreqMHz << I2C_CR2_FREQ);
+    if (pConf->ClockSpeed <= I2C_SPEED_STANDARD)
+    {
+        /*Thigh = Tlow = CCR * Tpclk1, rounded up so that SCL does not exceed the speed, 4 at least*/
+        Ccr = (Pclk + (2U * pConf->ClockSpeed) - 1U) / (2U * pConf->ClockSpeed);
+        if (Ccr < 4U)
+        {
+            Ccr = 4U;
+        }
+        /*Maximum rise time 1000 ns*/
+        I2Cx->TRISE = FreqMHz + 1U;
+    }
+    else
+    {
+        if (pConf->DutyCycle == I2C_DUTY_16_9)
+        {
+            /*Thigh = 9 * CCR * Tpclk1, Tlow = 16 * CCR * Tpclk1*/
+            Ccr = (Pclk + (25U * pConf->ClockSpeed) - 1U) / (25U * pConf->ClockSpeed);
+            Ccr |= (0x01U << I2C_CCR_DUTY);
+        }
+        else
+        {
+            /*Thigh = CCR * Tpclk1, Tlow = 2 * CCR * Tpclk1*/
+            Ccr = (Pclk + (3U * pConf->ClockSpeed) - 1U) / (3U * pConf->ClockSpeed);
+        }
+        if ((Ccr & 0x0FFFU) == 0U)
+        {
+            Ccr |= 0x01U;
+        }
+        Ccr |= (0x01U << I2C_CCR_FS);
+        /*Maximum rise time 300 ns*/
+        I2Cx->TRISE = ((FreqMHz * 300U) / 1000U) + 1U;
+    }
+    I2Cx->CCR = Ccr;
+    I2Cx->CR1 |= (0x01U << I2C_CR1_PE);
+    return TRUE;
+}
+
+/**
+ * @brief This function resets the peripheral (SWRST clears all its registers) and configures it again.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pConf Configuration of the I2C
+ */
+static void I2C_Reset(I2C_RegDef_t * I2Cx, const I2C_Conf_t * pConf)
+{
+    I2Cx->CR1 |= (0x01U << I2C_CR1_SWRST);
+    I2Cx->CR1 &= ~(0x01U << I2C_CR1_SWRST);
+    (void)I2C_SetTiming(I2Cx, pConf);
+}
+
+/**
+ * @brief This function recomputes the clock control registers of the initialized I2Cs after a clock tree change.
+ *
+ * @note A transfer running while the clock changes is corrupted.
+ *
+ * @param pClocks New clock frequencies
+ */
+static void I2C_ClockChangeCallback(const RCC_ClockState_t * pClocks)
+{
+    uint8_t i;
+
+    (void)pClocks;
+    for (i = 0U; i < I2C_INSTANCE_NUM; i++)
+    {
+        if (I2C_State[i].Initialized == TRUE)
+        {
+            (void)I2C_SetTiming(I2C_Instance[i], &I2C_State[i].Conf);
+        }
+    }
+}
+
+/**
+ * @brief This function ends the running transfer, calls its Done callback and starts the next queued transfer.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ * @param Status Result of the transfer, @ref I2C_Status
+ */
+static void I2C_Complete(I2C_RegDef_t * I2Cx, I2C_State_t * pState, uint8_t Status)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+
+    I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITBUFEN) | (0x01U << I2C_CR2_DMAEN) | (0x01U << I2C_CR2_LAST));
+    I2Cx->CR1 &= ~(0x01U << I2C_CR1_POS);
+    pState->Stats.Transfers++;
+    pState->Stats.ActiveTime += Timebase_CyclesToUs(Timebase_ElapsedCycles(pState->StartCycles));
+    if (Status == I2C_STATUS_OK)
+    {
+        pState->Stats.BytesTx += (uint32_t)pXfer->HeaderLength + pXfer->TxLength;
+        pState->Stats.BytesRx += pXfer->RxLength;
+    }
+    pState->pCurrent = NULL;
+    pState->Phase = I2C_PHASE_IDLE;
+    pXfer->Status = Status;
+    if (pXfer->Done != NULL)
+    {
+        pXfer->Done(pXfer);
+    }
+    /*Next queued transfer, unless Done submitted one on an empty queue, which is already started,
+      or a bus recovery is pending*/
+    if ((pState->pCurrent == NULL) && (pState->Recovering == FALSE))
+    {
+        I2C_StartNext(I2Cx, pState);
+    }
+}
+
+/**
+ * @brief This function starts the first queued transfer, if any. The bus must be idle (pState->pCurrent NULL).
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ */
+static void I2C_StartNext(I2C_RegDef_t * I2Cx, I2C_State_t * pState)
+{
+    if (pState->pHead == NULL)
+    {
+        return;
+    }
+    pState->pCurrent = pState->pHead;
+    pState->pHead = pState->pCurrent->pNext;
+    if (pState->pHead == NULL)
+    {
+        pState->pTail = NULL;
+    }
+    pState->Queued--;
+    I2C_StartTransfer(I2Cx, pState);
+}
+
+/**
+ * @brief This function is the deferred bus recovery after a bus error, it is run from PendSV (work queue).
+ *        The bus is freed through GPIO, then the queued transfers are started again.
+ *
+ * @param Context Pointer to the I2C peripheral
+ */
+static void I2C_RecoverWork(void * Context)
+{
+    I2C_RegDef_t * I2Cx = (I2C_RegDef_t *)Context;
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+    uint32_t Lock;
+
+    I2C_Recover(I2Cx);
+    Lock = I2C_LOCK();
+    pState->Recovering = FALSE;
+    if (pState->pCurrent == NULL)
+    {
+        I2C_StartNext(I2Cx, pState);
+    }
+    I2C_UNLOCK(Lock);
+}
+
+/**
+ * @brief This function sends the START condition of the current transfer (pState->pCurrent).
+ *        It is also used to restart a transfer after an arbitration loss.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ */
+static void I2C_StartTransfer(I2C_RegDef_t * I2Cx, I2C_State_t * pState)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+    uint32_t Wait = 0U;
+
+    pState->StartCycles = Timebase_NowCycles();
+    pState->Index = 0U;
+    if (((pXfer->HeaderLength + pXfer->TxLength) == 0U) && (pXfer->RxLength != 0U))
+    {
+        pState->Phase = I2C_PHASE_START_RX;
+    }
+    else
+    {
+        pState->Phase = I2C_PHASE_START_TX;
+    }
+    /*The STOP of the previous transfer is sent after its last byte, a START requested before is lost*/
+    while ((((I2Cx->CR1 >> I2C_CR1_STOP) & 0x01U) == BIT_SET) && (Wait < I2C_STOP_WAIT_MAX))
+    {
+        Wait++;
+    }
+    I2Cx->CR1 &= ~(0x01U << I2C_CR1_POS);
+    I2Cx->CR1 |= (0x01U << I2C_CR1_ACK);
+    I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITBUFEN) | (0x01U << I2C_CR2_DMAEN) | (0x01U << I2C_CR2_LAST));
+    I2Cx->CR2 |= (0x01U << I2C_CR2_ITEVTEN) | (0x01U << I2C_CR2_ITERREN);
+    I2Cx->CR1 |= (0x01U << I2C_CR1_START);
+}
+
+/**
+ * @brief This function handles the ADDR event of a write: the bytes are sent on TXE.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ */
+static void I2C_AddrTx(I2C_RegDef_t * I2Cx, I2C_State_t * pState)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+
+    I2C_ClearAddr(I2Cx);
+    pState->Phase = I2C_PHASE_TX;
+    if ((pXfer->HeaderLength + pXfer->TxLength) == 0U)
+    {
+        /*Address probe*/
+        I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+        I2C_Complete(I2Cx, pState, I2C_STATUS_OK);
+    }
+    else
+    {
+        I2Cx->CR2 |= (0x01U << I2C_CR2_ITBUFEN);
+    }
+}
+
+/**
+ * @brief This function handles the ADDR event of a read. The end of the read depends on its length
+ *        (RM0090 master receiver): the NACK and the STOP must be set before the last byte is received.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ */
+static void I2C_AddrRx(I2C_RegDef_t * I2Cx, I2C_State_t * pState)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+    uint8_t Index = I2Cx_TO_INDEX(I2Cx);
+
+    pState->Index = 0U;
+    pState->Phase = I2C_PHASE_RX;
+    if ((pState->Conf.UseDMA == TRUE) && (pXfer->RxLength >= I2C_DMA_MIN))
+    {
+        /*DMA: LAST makes the peripheral NACK the last byte, the DMA completion sends the STOP*/
+        pState->Phase = I2C_PHASE_RX_DMA;
+        I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITBUFEN) | (0x01U << I2C_CR2_ITEVTEN));
+        I2Cx->CR2 |= (0x01U << I2C_CR2_DMAEN) | (0x01U << I2C_CR2_LAST);
+        DMA_Start(DMA1, I2C_DmaMap[Index][I2C_DMA_RX_STREAM], (uint32_t)&I2Cx->DR,
+                  (uint32_t)pXfer->pRxData, pXfer->RxLength);
+        I2C_ClearAddr(I2Cx);
+    }
+    else if (pXfer->RxLength == 1U)
+    {
+        /*NACK and STOP right after the address, the byte is read on RXNE*/
+        I2Cx->CR1 &= ~(0x01U << I2C_CR1_ACK);
+        I2C_ClearAddr(I2Cx);
+        I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+        I2Cx->CR2 |= (0x01U << I2C_CR2_ITBUFEN);
+    }
+    else if (pXfer->RxLength == 2U)
+    {
+        /*The NACK applies to the second byte, both bytes are read on BTF*/
+        I2Cx->CR1 |= (0x01U << I2C_CR1_POS);
+        I2Cx->CR1 &= ~(0x01U << I2C_CR1_ACK);
+        I2C_ClearAddr(I2Cx);
+        I2Cx->CR2 &= ~(0x01U << I2C_CR2_ITBUFEN);
+    }
+    else
+    {
+        /*Bytes read on RXNE until 3 bytes are left, then on BTF*/
+        I2Cx->CR1 |= (0x01U << I2C_CR1_ACK);
+        I2C_ClearAddr(I2Cx);
+        if (pXfer->RxLength == 3U)
+        {
+            I2Cx->CR2 &= ~(0x01U << I2C_CR2_ITBUFEN);
+        }
+        else
+        {
+            I2Cx->CR2 |= (0x01U << I2C_CR2_ITBUFEN);
+        }
+    }
+}
+
+/**
+ * @brief This function handles the TXE and BTF events of a write.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ * @param Sr1 Value of the SR1 register
+ * @param Cr2 Value of the CR2 register
+ */
+static void I2C_HandleTx(I2C_RegDef_t * I2Cx, I2C_State_t * pState, uint32_t Sr1, uint32_t Cr2)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+    uint16_t Total = pXfer->HeaderLength + pXfer->TxLength;
+    uint8_t Index = I2Cx_TO_INDEX(I2Cx);
+
+    if ((((Sr1 >> I2C_SR1_TXE) & 0x01U) == BIT_SET) && (((Cr2 >> I2C_CR2_ITBUFEN) & 0x01U) == BIT_SET)
+        && (pState->Index < Total))
+    {
+        if ((pState->Conf.UseDMA == TRUE) && (pState->Index == pXfer->HeaderLength)
+            && (pXfer->TxLength >= I2C_DMA_MIN))
+        {
+            /*The data part is written by DMA, the event interrupt is back for the BTF of the last byte*/
+            pState->Phase = I2C_PHASE_TX_DMA;
+            I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITBUFEN) | (0x01U << I2C_CR2_ITEVTEN));
+            I2Cx->CR2 |= (0x01U << I2C_CR2_DMAEN);
+            DMA_Start(DMA1, I2C_DmaMap[Index][I2C_DMA_TX_STREAM], (uint32_t)&I2Cx->DR,
+                      (uint32_t)pXfer->pTxData, pXfer->TxLength);
+            return;
+        }
+        if (pState->Index < pXfer->HeaderLength)
+        {
+            I2C_WriteData(I2Cx, pXfer->Header[pState->Index]);
+        }
+        else
+        {
+            I2C_WriteData(I2Cx, pXfer->pTxData[pState->Index - pXfer->HeaderLength]);
+        }
+        pState->Index++;
+        if (pState->Index == Total)
+        {
+            /*The write ends on the BTF of the last byte*/
+            I2Cx->CR2 &= ~(0x01U << I2C_CR2_ITBUFEN);
+        }
+    }
+    else if ((((Sr1 >> I2C_SR1_BTF) & 0x01U) == BIT_SET) && (pState->Index == Total))
+    {
+        if (pXfer->RxLength != 0U)
+        {
+            /*Repeated START for the read part*/
+            pState->Phase = I2C_PHASE_START_RX;
+            I2Cx->CR1 |= (0x01U << I2C_CR1_START);
+        }
+        else
+        {
+            I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+            I2C_Complete(I2Cx, pState, I2C_STATUS_OK);
+        }
+    }
+}
+
+/**
+ * @brief This function handles the RXNE and BTF events of a read.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pState Driver state of the I2C
+ * @param Sr1 Value of the SR1 register
+ * @param Cr2 Value of the CR2 register
+ */
+static void I2C_HandleRx(I2C_RegDef_t * I2Cx, I2C_State_t * pState, uint32_t Sr1, uint32_t Cr2)
+{
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+    uint16_t Remaining = pXfer->RxLength - pState->Index;
+
+    if ((((Sr1 >> I2C_SR1_RXNE) & 0x01U) == BIT_SET) && (((Cr2 >> I2C_CR2_ITBUFEN) & 0x01U) == BIT_SET))
+    {
+        if (Remaining > 3U)
+        {
+            pXfer->pRxData[pState->Index++] = I2C_ReadData(I2Cx);
+            if ((Remaining - 1U) == 3U)
+            {
+                /*The last 3 bytes are read on BTF*/
+                I2Cx->CR2 &= ~(0x01U << I2C_CR2_ITBUFEN);
+            }
+        }
+        else if (Remaining == 1U)
+        {
+            /*Single byte read, the STOP is already set*/
+            pXfer->pRxData[pState->Index++] = I2C_ReadData(I2Cx);
+            I2C_Complete(I2Cx, pState, I2C_STATUS_OK);
+        }
+    }
+    else if (((Sr1 >> I2C_SR1_BTF) & 0x01U) == BIT_SET)
+    {
+        if (Remaining == 3U)
+        {
+            /*Byte N-2 in DR, N-1 in the shift register: NACK the last byte*/
+            I2Cx->CR1 &= ~(0x01U << I2C_CR1_ACK);
+            pXfer->pRxData[pState->Index++] = I2C_ReadData(I2Cx);
+        }
+        else if (Remaining == 2U)
+        {
+            /*Byte N-1 in DR, N in the shift register*/
+            I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+            pXfer->pRxData[pState->Index++] = I2C_ReadData(I2Cx);
+            pXfer->pRxData[pState->Index++] = I2C_ReadData(I2Cx);
+            I2C_Complete(I2Cx, pState, I2C_STATUS_OK);
+        }
+    }
+}
+
+/**
+ * @brief This function is called from the DMA interrupt at the end of the data part of a write.
+ *
+ * @param Flags DMA flags of the stream (DMA_FLAG_TC, DMA_FLAG_TE)
+ * @param Context I2C peripheral
+ */
+static void I2C_TxDMACallback(uint8_t Flags, void * Context)
+{
+    I2C_RegDef_t * I2Cx = (I2C_RegDef_t *)Context;
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+
+    if (pState->Phase != I2C_PHASE_TX_DMA)
+    {
+        return;
+    }
+    I2Cx->CR2 &= ~(0x01U << I2C_CR2_DMAEN);
+    if ((Flags & DMA_FLAG_TE) != 0U)
+    {
+        I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+        I2C_Complete(I2Cx, pState, I2C_STATUS_BUS_ERROR);
+        return;
+    }
+    /*The last byte is still being sent, its BTF ends the write*/
+    pState->Index = pState->pCurrent->HeaderLength + pState->pCurrent->TxLength;
+    pState->Phase = I2C_PHASE_TX;
+    I2Cx->CR2 |= (0x01U << I2C_CR2_ITEVTEN);
+}
+
+/**
+ * @brief This function is called from the DMA interrupt at the end of a read.
+ *
+ * @param Flags DMA flags of the stream (DMA_FLAG_TC, DMA_FLAG_TE)
+ * @param Context I2C peripheral
+ */
+static void I2C_RxDMACallback(uint8_t Flags, void * Context)
+{
+    I2C_RegDef_t * I2Cx = (I2C_RegDef_t *)Context;
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+
+    if (pState->Phase != I2C_PHASE_RX_DMA)
+    {
+        return;
+    }
+    /*The last byte was NACKed (LAST)*/
+    I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+    pState->Index = pState->pCurrent->RxLength;
+    I2Cx->CR2 |= (0x01U << I2C_CR2_ITEVTEN);
+    I2C_Complete(I2Cx, pState, ((Flags & DMA_FLAG_TE) != 0U) ? I2C_STATUS_BUS_ERROR : I2C_STATUS_OK);
+}
+
+/**
+ * @brief This function initializes an I2C as bus master according to the specified settings.
+ *        The pins and the peripheral clock are set by the board tables. A bus held low by a slave
+ *        (e.g, reset during a read) is freed.
+ *
+ * @note The queued transfers are dropped, the bus must be idle.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param I2C_Conf Structer that contains the configuration information of the I2C
+ *
+ * @return uint8_t TRUE on success, FALSE if the I2C is not handled or the speed or PCLK1 is out of range
+ */
+uint8_t I2C_Init(I2C_RegDef_t * I2Cx, I2C_Conf_t I2C_Conf)
+{
+    uint8_t Index = I2Cx_TO_INDEX(I2Cx);
+    I2C_State_t * pState;
+    const uint8_t * pDma;
+    DMA_Conf_t DmaConf;
+    I2C_Stats_t Empty = {0};
+
+    if (Index >= I2C_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
+    pState = &I2C_State[Index];
+    pDma = I2C_DmaMap[Index];
+    /*1. Reset the peripheral and the driver state*/
+    I2Cx->CR1 = (0x01U << I2C_CR1_SWRST);
+    I2Cx->CR1 = 0U;
+    pState->Conf = I2C_Conf;
+    pState->Initialized = FALSE;
+    pState->Phase = I2C_PHASE_IDLE;
+    pState->Recovering = FALSE;
+    pState->pCurrent = NULL;
+    pState->pHead = NULL;
+    pState->pTail = NULL;
+    pState->Queued = 0U;
+    pState->Stats = Empty;
+    /*2. Set the clock control registers and enable the peripheral, they are kept in sync with the clock changes*/
+    if (I2C_SetTiming(I2Cx, &pState->Conf) == FALSE)
+    {
+        return FALSE;
+    }
+    if (I2C_ClockCallbackRegistered == FALSE)
+    {
+        I2C_ClockCallbackRegistered = RCC_RegisterClockChangeCallback(I2C_ClockChangeCallback);
+    }
+    /*3. DMA streams, byte transfers between the data register and the transfer buffers*/
+    if (I2C_Conf.UseDMA == TRUE)
+    {
+        DmaConf.PeriphInc = DMA_INC_DISABLE;
+        DmaConf.MemInc = DMA_INC_ENABLE;
+        DmaConf.PeriphDataSize = DMA_SIZE_BYTE;
+        DmaConf.MemDataSize = DMA_SIZE_BYTE;
+        DmaConf.Mode = DMA_MODE_NORMAL;
+        DmaConf.Priority = DMA_PRIORITY_MEDIUM;
+        DmaConf.Channel = pDma[I2C_DMA_TX_CHANNEL];
+        DmaConf.Direction = DMA_DIR_M2P;
+        DMA_Init(DMA1, pDma[I2C_DMA_TX_STREAM], DmaConf);
+        DMA_RegisterCallback(DMA1, pDma[I2C_DMA_TX_STREAM], I2C_TxDMACallback, I2Cx);
+        DmaConf.Channel = pDma[I2C_DMA_RX_CHANNEL];
+        DmaConf.Direction = DMA_DIR_P2M;
+        DMA_Init(DMA1, pDma[I2C_DMA_RX_STREAM], DmaConf);
+        DMA_RegisterCallback(DMA1, pDma[I2C_DMA_RX_STREAM], I2C_RxDMACallback, I2Cx);
+    }
+    pState->Initialized = TRUE;
+    /*4. Free the bus if a slave holds it*/
+    if (I2C_GetBusyFlag(I2Cx) == TRUE)
+    {
+        I2C_Recover(I2Cx);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function sets the priority and enables the event and error interrupts of an I2C,
+ *        and the interrupts of its DMA streams when it uses DMA. I2C_Init must be called first.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param Priority Priority of the interrupts, shared by the DMA streams so they never preempt each other
+ */
+void I2C_IT_Init(I2C_RegDef_t * I2Cx, uint8_t Priority)
+{
+    const uint8_t * pDma;
+
+    if (I2Cx_TO_INDEX(I2Cx) >= I2C_INSTANCE_NUM)
+    {
+        return;
+    }
+    pDma = I2C_DmaMap[I2Cx_TO_INDEX(I2Cx)];
+    NVIC_SetPriority(I2Cx_TO_EV_IRQ(I2Cx), Priority);
+    NVIC_SetPriority(I2Cx_TO_EV_IRQ(I2Cx) + 1U, Priority);
+    NVIC_EnableIRQ(I2Cx_TO_EV_IRQ(I2Cx));
+    NVIC_EnableIRQ(I2Cx_TO_EV_IRQ(I2Cx) + 1U);
+    if (I2C_State[I2Cx_TO_INDEX(I2Cx)].Conf.UseDMA == TRUE)
+    {
+        DMA_IT_Init(DMA1, pDma[I2C_DMA_TX_STREAM], DMA_FLAG_TC | DMA_FLAG_TE, Priority);
+        DMA_IT_Init(DMA1, pDma[I2C_DMA_RX_STREAM], DMA_FLAG_TC | DMA_FLAG_TE, Priority);
+    }
+}
+
+/**
+ * @brief This function queues a transfer, it is started at once if the bus is idle.
+ *        The transfer must stay valid and unchanged until its Done callback is called.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ * @param pXfer Transfer to be queued, its Status is I2C_STATUS_PENDING until the end of the transfer
+ *
+ * @return uint8_t TRUE if the transfer is queued, FALSE if the I2C is not handled or the transfer is not valid
+ *         or already queued
+ */
+uint8_t I2C_Submit(I2C_RegDef_t * I2Cx, I2C_Transfer_t * pXfer)
+{
+    I2C_State_t * pState;
+    uint32_t Lock;
+
+    if (I2Cx_TO_INDEX(I2Cx) >= I2C_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
+    pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+    if ((pXfer == NULL) || (pState->Initialized == FALSE) || (pXfer->Address > 0x7FU)
+        || (pXfer->HeaderLength > I2C_HEADER_MAX) || (pXfer->Status == I2C_STATUS_PENDING)
+        || ((pXfer->TxLength != 0U) && (pXfer->pTxData == NULL))
+        || ((pXfer->RxLength != 0U) && (pXfer->pRxData == NULL)))
+    {
+        return FALSE;
+    }
+    pXfer->Status = I2C_STATUS_PENDING;
+    pXfer->Retries = 0U;
+    pXfer->pNext = NULL;
+    Lock = I2C_LOCK();
+    /*A transfer submitted from a Done callback waits behind the queued ones, all wait for a pending bus recovery*/
+    if ((pState->pCurrent == NULL) && (pState->pHead == NULL) && (pState->Recovering == FALSE))
+    {
+        pState->pCurrent = pXfer;
+        I2C_StartTransfer(I2Cx, pState);
+    }
+    else
+    {
+        if (pState->pTail == NULL)
+        {
+            pState->pHead = pXfer;
+        }
+        else
+        {
+            pState->pTail->pNext = pXfer;
+        }
+        pState->pTail = pXfer;
+        pState->Queued++;
+        if (pState->Queued > pState->Stats.HighWater)
+        {
+            pState->Stats.HighWater = pState->Queued;
+        }
+    }
+    I2C_UNLOCK(Lock);
+    return TRUE;
+}
+
+/**
+ * @brief This function checks if an I2C has no running or queued transfer.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ *
+ * @return uint8_t TRUE if idle, FALSE otherwise
+ */
+uint8_t I2C_IsIdle(I2C_RegDef_t * I2Cx)
+{
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+
+    return ((pState->pCurrent == NULL) && (pState->pHead == NULL)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function gets the bus busy flag (SCL or SDA low, or a transfer on the bus).
+ *
+ * @note Reading SR2 clears a pending ADDR flag, it must not be called while a transfer is running.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ *
+ * @return uint8_t TRUE if the bus is busy, FALSE otherwise
+ */
+uint8_t I2C_GetBusyFlag(I2C_RegDef_t * I2Cx)
+{
+    return (uint8_t)((I2Cx->SR2 >> I2C_SR2_BUSY) & 0x01U);
+}
+
+/**
+ * @brief This function frees the bus and resets the peripheral. A slave that was interrupted while sending
+ *        holds SDA low until it gets enough clocks to finish its byte: SCL is pulsed through GPIO until SDA
+ *        is released (I2C_RECOVERY_PULSES at most), then a STOP is sent. The pins are given back to the
+ *        peripheral, which is reset (SWRST) and configured again.
+ *
+ * @note The SCL and SDA pins must be open drain. It waits about 100 us, so it is not called from an interrupt:
+ *       after a bus error it is run from PendSV (work queue). It must not be called during a transfer.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ */
+void I2C_Recover(I2C_RegDef_t * I2Cx)
+{
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+    const I2C_Conf_t * pConf = &pState->Conf;
+    uint32_t SclModer, SdaModer;
+    uint8_t i;
+
+    pState->Stats.Recoveries++;
+    I2Cx->CR1 &= ~(0x01U << I2C_CR1_PE);
+    if ((pConf->pSclPort != NULL) && (pConf->pSdaPort != NULL))
+    {
+        /*1. Both pins released (high) as GPIO outputs*/
+        SclModer = pConf->pSclPort->MODER;
+        SdaModer = pConf->pSdaPort->MODER;
+        GPIO_PinWrite(pConf->pSclPort, pConf->SclPin, BIT_SET);
+        GPIO_PinWrite(pConf->pSdaPort, pConf->SdaPin, BIT_SET);
+        pConf->pSclPort->MODER = (SclModer & ~(0x03UL << (pConf->SclPin * 2U)))
+                                 | ((uint32_t)GPIO_MODE_OUTPUT << (pConf->SclPin * 2U));
+        pConf->pSdaPort->MODER = (pConf->pSdaPort->MODER & ~(0x03UL << (pConf->SdaPin * 2U)))
+                                 | ((uint32_t)GPIO_MODE_OUTPUT << (pConf->SdaPin * 2U));
+        /*2. Clock pulses until the slave releases SDA*/
+        for (i = 0U; (i < I2C_RECOVERY_PULSES) && (GPIO_PinRead(pConf->pSdaPort, pConf->SdaPin) == BIT_RESET); i++)
+        {
+            GPIO_PinWrite(pConf->pSclPort, pConf->SclPin, BIT_RESET);
+            Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+            GPIO_PinWrite(pConf->pSclPort, pConf->SclPin, BIT_SET);
+            Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+        }
+        /*3. STOP: SDA rises while SCL is high*/
+        GPIO_PinWrite(pConf->pSclPort, pConf->SclPin, BIT_RESET);
+        Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+        GPIO_PinWrite(pConf->pSdaPort, pConf->SdaPin, BIT_RESET);
+        Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+        GPIO_PinWrite(pConf->pSclPort, pConf->SclPin, BIT_SET);
+        Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+        GPIO_PinWrite(pConf->pSdaPort, pConf->SdaPin, BIT_SET);
+        Timebase_DelayUs(I2C_RECOVERY_HALF_PERIOD);
+        /*4. Give the pins back to the peripheral*/
+        pConf->pSclPort->MODER = SclModer;
+        pConf->pSdaPort->MODER = (pConf->pSdaPort->MODER & ~(0x03UL << (pConf->SdaPin * 2U)))
+                                 | (SdaModer & (0x03UL << (pConf->SdaPin * 2U)));
+    }
+    /*5. Reset the peripheral*/
+    I2C_Reset(I2Cx, pConf);
+}
+
+/**
+ * @brief This function gets the statistics of an I2C.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ *
+ * @return const I2C_Stats_t*
+ */
+const I2C_Stats_t * I2C_GetStats(I2C_RegDef_t * I2Cx)
+{
+    return &I2C_State[I2Cx_TO_INDEX(I2Cx)].Stats;
+}
+
+/**
+ * @brief This function handles the event interrupt of an I2C, it runs the transfer state machine.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ */
+void I2C_EV_IRQHandling(I2C_RegDef_t * I2Cx)
+{
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+    I2C_Transfer_t * pXfer = pState->pCurrent;
+    uint32_t Sr1 = I2Cx->SR1;
+    uint32_t Cr2 = I2Cx->CR2;
+
+    if (pXfer == NULL)
+    {
+        /*Late event of a finished transfer, the interrupts are enabled again by the next START*/
+        I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITEVTEN) | (0x01U << I2C_CR2_ITBUFEN));
+        return;
+    }
+    if (((Sr1 >> I2C_SR1_SB) & 0x01U) == BIT_SET)
+    {
+        /*The address write clears SB*/
+        I2C_WriteData(I2Cx, (uint8_t)((pXfer->Address << 1U) | ((pState->Phase == I2C_PHASE_START_RX) ? 1U : 0U)));
+    }
+    else if (((Sr1 >> I2C_SR1_ADDR) & 0x01U) == BIT_SET)
+    {
+        if (pState->Phase == I2C_PHASE_START_RX)
+        {
+            I2C_AddrRx(I2Cx, pState);
+        }
+        else
+        {
+            I2C_AddrTx(I2Cx, pState);
+        }
+    }
+    else if (pState->Phase == I2C_PHASE_TX)
+    {
+        I2C_HandleTx(I2Cx, pState, Sr1, Cr2);
+    }
+    else if (pState->Phase == I2C_PHASE_RX)
+    {
+        I2C_HandleRx(I2Cx, pState, Sr1, Cr2);
+    }
+}
+
+/**
+ * @brief This function handles the error interrupt of an I2C.
+ *        NACK: STOP and the transfer ends. Arbitration loss: the transfer is restarted up to I2C_RETRY_MAX
+ *        times (the peripheral is back in slave mode). Bus error: the peripheral is reset and the transfer ends,
+ *        the bus recovery (I2C_Recover) is deferred to PendSV and the queue waits for it.
+ *
+ * @param I2Cx Pointer to the I2C peripheral (I2C1, I2C2 or I2C3).
+ */
+void I2C_ER_IRQHandling(I2C_RegDef_t * I2Cx)
+{
+    I2C_State_t * pState = &I2C_State[I2Cx_TO_INDEX(I2Cx)];
+    const uint8_t * pDma = I2C_DmaMap[I2Cx_TO_INDEX(I2Cx)];
+    uint32_t Errors;
+
+    /*The error flags are cleared by writing 0, writing 1 does not change the other flags*/
+    Errors = I2Cx->SR1 & ((0x01U << I2C_SR1_BERR) | (0x01U << I2C_SR1_ARLO) | (0x01U << I2C_SR1_AF)
+                          | (0x01U << I2C_SR1_OVR));
+    I2Cx->SR1 &= ~Errors;
+    if ((pState->Phase == I2C_PHASE_TX_DMA) || (pState->Phase == I2C_PHASE_RX_DMA))
+    {
+        DMA_Stop(DMA1, pDma[(pState->Phase == I2C_PHASE_TX_DMA) ? I2C_DMA_TX_STREAM : I2C_DMA_RX_STREAM]);
+        I2Cx->CR2 |= (0x01U << I2C_CR2_ITEVTEN);
+    }
+    I2Cx->CR2 &= ~((0x01U << I2C_CR2_ITBUFEN) | (0x01U << I2C_CR2_DMAEN) | (0x01U << I2C_CR2_LAST));
+    if (((Errors >> I2C_SR1_BERR) & 0x01U) == BIT_SET)
+    {
+        pState->Stats.BusErrors++;
+        I2C_Reset(I2Cx, &pState->Conf);
+        if (pState->Recovering == FALSE)
+        {
+            /*If the work queue is full the queue goes on without the GPIO recovery*/
+            pState->Recovering = WorkQueue_Post(I2C_RecoverWork, I2Cx);
+        }
+        if (pState->pCurrent != NULL)
+        {
+            I2C_Complete(I2Cx, pState, I2C_STATUS_BUS_ERROR);
+        }
+    }
+    else if (((Errors >> I2C_SR1_ARLO) & 0x01U) == BIT_SET)
+    {
+        pState->Stats.ArbitrationLost++;
+        if (pState->pCurrent == NULL)
+        {
+            return;
+        }
+        if (pState->pCurrent->Retries < I2C_RETRY_MAX)
+        {
+            pState->pCurrent->Retries++;
+            I2C_StartTransfer(I2Cx, pState);
+        }
+        else
+        {
+            I2C_Complete(I2Cx, pState, I2C_STATUS_ARLO);
+        }
+    }
+    else if (((Errors >> I2C_SR1_AF) & 0x01U) == BIT_SET)
+    {
+        pState->Stats.Nacks++;
+        if (pState->pCurrent != NULL)
+        {
+            I2Cx->CR1 |= (0x01U << I2C_CR1_STOP);
+            I2C_Complete(I2Cx, pState, I2C_STATUS_NACK);
+        }
+    }
+}
@@ -0,0 +1,490 @@
+#include "stm32f407xx_i2c_driver.h"
+
+#if defined(I2C_HOST_MOCK)
+#include "timebase.h"
+#include "work_queue.h"
+
+/*  Host model of the I2C master (RM0090 event sequences) and of the devices on each bus, to test the transfer
+    state machine without the board. The bytes move instantly, the model runs step by step in I2C_MockRun and
+    calls the event and error handlers while their interrupt conditions are set. A protocol error is counted
+    when the driver reads an empty data register, writes a byte without TXE, or ends a read without a NACK.
+    The other drivers used by the I2C driver are replaced by the stubs at the end of this file, the posted work
+    items (deferred bus recovery) wait until I2C_MockRunWork, as they would wait for PendSV.
+    Built with I2C_HOST_MOCK by the driver test (test/test_i2c.c). */
+
+#define I2C_MOCK_DEVICE_MAX         4U
+/*Steps of I2C_MockRun before the bus is considered stuck*/
+#define I2C_MOCK_STEP_MAX           100000U
+/*Number of posted work items kept by the work queue stub*/
+#define I2C_MOCK_WORK_MAX           4U
+
+/*I2C_Mock_State*/
+#define I2C_MOCK_IDLE               0U      /*No transfer, or the address was NACKed*/
+#define I2C_MOCK_ADDRESS            1U      /*START sent, the address is expected*/
+#define I2C_MOCK_ADDR_WAIT          2U      /*Address acknowledged, ADDR not cleared*/
+#define I2C_MOCK_TX                 3U      /*Master writes*/
+#define I2C_MOCK_RX                 4U      /*Master reads*/
+
+typedef struct
+{
+    I2C_MockDevice_t * pDevices[I2C_MOCK_DEVICE_MAX];
+    uint8_t DeviceNum;
+    I2C_MockDevice_t * pSelected;       /*Addressed device*/
+    uint8_t State;                      /*@ref I2C_Mock_State*/
+    uint8_t Read;                       /*TRUE if the address byte selects a read*/
+    uint8_t FirstByte;                  /*TRUE: the next byte written selects the register*/
+    uint8_t Shift;                      /*Receive shift register*/
+    uint8_t ShiftFull;
+    uint8_t Nacked;                     /*The last byte read was NACKed, the device stops sending*/
+    uint8_t RxCount;                    /*Bytes received since the address*/
+    uint8_t InjectedError;              /*SR1 error flag position applied on the next data write, 0: none*/
+    uint32_t ProtocolErrors;
+} I2C_MockBus_t;
+
+I2C_RegDef_t I2C_MockRegs[I2C_INSTANCE_NUM];
+static I2C_MockBus_t I2C_MockBus[I2C_INSTANCE_NUM];
+static uint32_t I2C_MockCycleCount = 0U;
+/*Work items posted to the work queue stub*/
+static WorkQueue_Item_t I2C_MockWork[I2C_MOCK_WORK_MAX];
+static uint8_t I2C_MockWorkNum = 0U;
+
+/**
+ * @brief This function sets SR1 flags of a mock I2C.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ * @param Mask Flags to be set
+ */
+static void I2C_MockSet(I2C_RegDef_t * I2Cx, uint32_t Mask)
+{
+    I2Cx->SR1 |= Mask;
+}
+
+/**
+ * @brief This function clears SR1 flags of a mock I2C.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ * @param Mask Flags to be cleared
+ */
+static void I2C_MockClear(I2C_RegDef_t * I2Cx, uint32_t Mask)
+{
+    I2Cx->SR1 &= ~Mask;
+}
+
+/**
+ * @brief This function attaches a device to a mock bus.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ * @param pDevice Device, its Address must be set
+ */
+void I2C_MockAttach(I2C_RegDef_t * I2Cx, I2C_MockDevice_t * pDevice)
+{
+    I2C_MockBus_t * pBus = &I2C_MockBus[I2Cx_TO_INDEX(I2Cx)];
+
+    if (pBus->DeviceNum < I2C_MOCK_DEVICE_MAX)
+    {
+        pBus->pDevices[pBus->DeviceNum++] = pDevice;
+    }
+}
+
+/**
+ * @brief This function makes the next data byte written on a mock bus fail.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ * @param FlagPos Error flag: I2C_SR1_AF, I2C_SR1_ARLO or I2C_SR1_BERR
+ */
+void I2C_MockInjectError(I2C_RegDef_t * I2Cx, uint8_t FlagPos)
+{
+    I2C_MockBus[I2Cx_TO_INDEX(I2Cx)].InjectedError = FlagPos;
+}
+
+/**
+ * @brief This function gets the number of protocol errors of a mock bus.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ *
+ * @return uint32_t
+ */
+uint32_t I2C_MockGetProtocolErrors(I2C_RegDef_t * I2Cx)
+{
+    return I2C_MockBus[I2Cx_TO_INDEX(I2Cx)].ProtocolErrors;
+}
+
+/**
+ * @brief This function is called by the driver after a data register write.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ */
+void I2C_MockDataWritten(I2C_RegDef_t * I2Cx)
+{
+    I2C_MockBus_t * pBus = &I2C_MockBus[I2Cx_TO_INDEX(I2Cx)];
+    uint8_t Data = (uint8_t)I2Cx->DR;
+    uint8_t Error = pBus->InjectedError;
+    uint8_t i;
+
+    if (pBus->State == I2C_MOCK_ADDRESS)
+    {
+        /*Address byte, the write clears SB*/
+        I2C_MockClear(I2Cx, 0x01U << I2C_SR1_SB);
+        pBus->Read = Data & 0x01U;
+        pBus->pSelected = NULL;
+        for (i = 0U; i < pBus->DeviceNum; i++)
+        {
+            if (pBus->pDevices[i]->Address == (Data >> 1U))
+            {
+                pBus->pSelected = pBus->pDevices[i];
+            }
+        }
+        if (pBus->pSelected == NULL)
+        {
+            I2C_MockSet(I2Cx, 0x01U << I2C_SR1_AF);
+            pBus->State = I2C_MOCK_IDLE;
+            return;
+        }
+        pBus->State = I2C_MOCK_ADDR_WAIT;
+        pBus->FirstByte = (pBus->Read == 0U) ? TRUE : FALSE;
+        I2C_MockSet(I2Cx, 0x01U << I2C_SR1_ADDR);
+        I2Cx->SR2 = (0x01U << I2C_SR2_MSL) | (0x01U << I2C_SR2_BUSY) | ((pBus->Read == 0U) ? (0x01U << I2C_SR2_TRA) : 0U);
+        return;
+    }
+    if ((pBus->State != I2C_MOCK_TX) || (((I2Cx->SR1 >> I2C_SR1_TXE) & 0x01U) == BIT_RESET))
+    {
+        pBus->ProtocolErrors++;
+        return;
+    }
+    if (Error != 0U)
+    {
+        pBus->InjectedError = 0U;
+        I2C_MockSet(I2Cx, 0x01U << Error);
+        if (Error != I2C_SR1_AF)
+        {
+            /*Arbitration loss or misplaced START/STOP: the peripheral is back in slave mode*/
+            I2C_MockClear(I2Cx, (0x01U << I2C_SR1_TXE) | (0x01U << I2C_SR1_BTF));
+            I2Cx->SR2 = 0U;
+            pBus->State = I2C_MOCK_IDLE;
+        }
+        return;
+    }
+    if (pBus->FirstByte == TRUE)
+    {
+        pBus->FirstByte = FALSE;
+        pBus->pSelected->Pointer = Data;
+    }
+    else
+    {
+        pBus->pSelected->Regs[pBus->pSelected->Pointer++] = Data;
+    }
+    pBus->pSelected->Writes++;
+    I2C_MockSet(I2Cx, (0x01U << I2C_SR1_TXE) | (0x01U << I2C_SR1_BTF));
+}
+
+/**
+ * @brief This function is called by the driver after a data register read.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ */
+void I2C_MockDataRead(I2C_RegDef_t * I2Cx)
+{
+    I2C_MockBus_t * pBus = &I2C_MockBus[I2Cx_TO_INDEX(I2Cx)];
+
+    if (((I2Cx->SR1 >> I2C_SR1_RXNE) & 0x01U) == BIT_RESET)
+    {
+        pBus->ProtocolErrors++;
+        return;
+    }
+    I2C_MockClear(I2Cx, (0x01U << I2C_SR1_RXNE) | (0x01U << I2C_SR1_BTF));
+    if (pBus->ShiftFull == TRUE)
+    {
+        pBus->ShiftFull = FALSE;
+        I2Cx->DR = pBus->Shift;
+        I2C_MockSet(I2Cx, 0x01U << I2C_SR1_RXNE);
+    }
+}
+
+/**
+ * @brief This function is called by the driver after the ADDR flag is cleared.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ */
+void I2C_MockAddrCleared(I2C_RegDef_t * I2Cx)
+{
+    I2C_MockBus_t * pBus = &I2C_MockBus[I2Cx_TO_INDEX(I2Cx)];
+
+    if (pBus->State != I2C_MOCK_ADDR_WAIT)
+    {
+        return;
+    }
+    I2C_MockClear(I2Cx, 0x01U << I2C_SR1_ADDR);
+    if (pBus->Read == 0U)
+    {
+        pBus->State = I2C_MOCK_TX;
+        I2C_MockSet(I2Cx, 0x01U << I2C_SR1_TXE);
+    }
+    else
+    {
+        pBus->State = I2C_MOCK_RX;
+        pBus->Nacked = FALSE;
+        pBus->ShiftFull = FALSE;
+        pBus->RxCount = 0U;
+    }
+}
+
+/**
+ * @brief This function runs one step of the bus: START, STOP or the reception of one byte.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ *
+ * @return uint8_t TRUE if the bus state changed
+ */
+static uint8_t I2C_MockStep(I2C_RegDef_t * I2Cx)
+{
+    I2C_MockBus_t * pBus = &I2C_MockBus[I2Cx_TO_INDEX(I2Cx)];
+    uint8_t RxFull = ((((I2Cx->SR1 >> I2C_SR1_RXNE) & 0x01U) == BIT_SET) && (pBus->ShiftFull == TRUE)) ? TRUE : FALSE;
+    uint8_t Ack;
+
+    if (((I2Cx->CR1 >> I2C_CR1_PE) & 0x01U) == BIT_RESET)
+    {
+        return FALSE;
+    }
+    if (pBus->State == I2C_MOCK_RX)
+    {
+        /*In reception the STOP follows the byte being received, nothing is received once both registers are full*/
+        if ((((I2Cx->CR1 >> I2C_CR1_STOP) & 0x01U) == BIT_SET) && ((RxFull == TRUE) || (pBus->Nacked == TRUE)))
+        {
+            if (pBus->Nacked == FALSE)
+            {
+                pBus->ProtocolErrors++;
+            }
+            I2Cx->CR1 &= ~(0x01U << I2C_CR1_STOP);
+            I2Cx->SR2 = 0U;
+            pBus->State = I2C_MOCK_IDLE;
+            return TRUE;
+        }
+        else if ((RxFull == FALSE) && (pBus->Nacked == FALSE) && (pBus->ShiftFull == FALSE))
+        {
+            /*With POS, ACK applies to the next byte: the first byte is acknowledged*/
+            if ((((I2Cx->CR1 >> I2C_CR1_POS) & 0x01U) == BIT_SET) && (pBus->RxCount == 0U))
+            {
+                Ack = TRUE;
+            }
+            else
+            {
+                Ack = (uint8_t)((I2Cx->CR1 >> I2C_CR1_ACK) & 0x01U);
+            }
+            pBus->RxCount++;
+            pBus->pSelected->Reads++;
+            pBus->Nacked = (Ack == TRUE) ? FALSE : TRUE;
+            if (((I2Cx->SR1 >> I2C_SR1_RXNE) & 0x01U) == BIT_RESET)
+            {
+                I2Cx->DR = pBus->pSelected->Regs[pBus->pSelected->Pointer++];
+                I2C_MockSet(I2Cx, 0x01U << I2C_SR1_RXNE);
+            }
+            else
+            {
+                pBus->Shift = pBus->pSelected->Regs[pBus->pSelected->Pointer++];
+                pBus->ShiftFull = TRUE;
+                I2C_MockSet(I2Cx, 0x01U << I2C_SR1_BTF);
+            }
+            return TRUE;
+        }
+        return FALSE;
+    }
+    /*STOP before START: a transfer started right after the STOP of the previous one*/
+    if (((I2Cx->CR1 >> I2C_CR1_STOP) & 0x01U) == BIT_SET)
+    {
+        if (pBus->State == I2C_MOCK_ADDR_WAIT)
+        {
+            return FALSE;
+        }
+        I2Cx->CR1 &= ~(0x01U << I2C_CR1_STOP);
+        I2C_MockClear(I2Cx, (0x01U << I2C_SR1_TXE) | (0x01U << I2C_SR1_BTF));
+        I2Cx->SR2 = 0U;
+        pBus->State = I2C_MOCK_IDLE;
+        return TRUE;
+    }
+    if (((I2Cx->CR1 >> I2C_CR1_START) & 0x01U) == BIT_SET)
+    {
+        /*(Repeated) START, it clears BTF*/
+        if ((pBus->State == I2C_MOCK_IDLE) || (pBus->State == I2C_MOCK_TX))
+        {
+            I2Cx->CR1 &= ~(0x01U << I2C_CR1_START);
+            I2C_MockClear(I2Cx, (0x01U << I2C_SR1_TXE) | (0x01U << I2C_SR1_BTF));
+            I2C_MockSet(I2Cx, 0x01U << I2C_SR1_SB);
+            I2Cx->SR2 = (0x01U << I2C_SR2_MSL) | (0x01U << I2C_SR2_BUSY);
+            pBus->State = I2C_MOCK_ADDRESS;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief This function runs a mock bus until nothing happens: bus steps and interrupt handler calls.
+ *
+ * @param I2Cx Pointer to the mock I2C
+ *
+ * @return uint32_t Number of interrupt handler calls
+ */
+uint32_t I2C_MockRun(I2C_RegDef_t * I2Cx)
+{
+    uint32_t Calls = 0U;
+    uint32_t Step;
+    uint32_t Sr1, Cr2;
+    uint8_t Busy;
+
+    for (Step = 0U; Step < I2C_MOCK_STEP_MAX; Step++)
+    {
+        Busy = I2C_MockStep(I2Cx);
+        Sr1 = I2Cx->SR1;
+        Cr2 = I2Cx->CR2;
+        if ((((Cr2 >> I2C_CR2_ITERREN) & 0x01U) == BIT_SET)
+            && ((Sr1 & ((0x01U << I2C_SR1_BERR) | (0x01U << I2C_SR1_ARLO) | (0x01U << I2C_SR1_AF))) != 0U))
+        {
+            I2C_ER_IRQHandling(I2Cx);
+            Calls++;
+            Busy = TRUE;
+        }
+        else if ((((Cr2 >> I2C_CR2_ITEVTEN) & 0x01U) == BIT_SET)
+                 && (((Sr1 & ((0x01U << I2C_SR1_SB) | (0x01U << I2C_SR1_ADDR) | (0x01U << I2C_SR1_BTF))) != 0U)
+                     || ((((Cr2 >> I2C_CR2_ITBUFEN) & 0x01U) == BIT_SET)
+                         && ((Sr1 & ((0x01U << I2C_SR1_TXE) | (0x01U << I2C_SR1_RXNE))) != 0U))))
+        {
+            I2C_EV_IRQHandling(I2Cx);
+            Calls++;
+            Busy = TRUE;
+        }
+        if (Busy == FALSE)
+        {
+            return Calls;
+        }
+    }
+    I2C_MockBus[I2Cx_TO_INDEX(I2Cx)].ProtocolErrors++;
+    return Calls;
+}
+
+/**
+ * @brief This function runs the posted work items in the posting order, like PendSV.
+ *
+ * @return uint32_t Number of work items run
+ */
+uint32_t I2C_MockRunWork(void)
+{
+    uint32_t Runs = 0U;
+
+    while (Runs < I2C_MockWorkNum)
+    {
+        I2C_MockWork[Runs].Handler(I2C_MockWork[Runs].Context);
+        Runs++;
+    }
+    I2C_MockWorkNum = 0U;
+    return Runs;
+}
+
+/*Stubs of the drivers used by the I2C driver*/
+uint8_t WorkQueue_Post(WorkQueue_Handler_t Handler, void * Context)
+{
+    if (I2C_MockWorkNum >= I2C_MOCK_WORK_MAX)
+    {
+        return FALSE;
+    }
+    I2C_MockWork[I2C_MockWorkNum].Handler = Handler;
+    I2C_MockWork[I2C_MockWorkNum].Context = Context;
+    I2C_MockWorkNum++;
+    return TRUE;
+}
+
+uint32_t RCC_GetPCLK1Val(void)
+{
+    return 42000000U;
+}
+
+uint8_t RCC_RegisterClockChangeCallback(RCC_ClockChangeCallback_t Callback)
+{
+    (void)Callback;
+    return TRUE;
+}
+
+void DMA_Init(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Conf_t DMA_Conf)
+{
+    (void)DMAx;
+    (void)Stream;
+    (void)DMA_Conf;
+}
+
+void DMA_Start(DMA_RegDef_t * DMAx, uint8_t Stream, uint32_t PeriphAddr, uint32_t MemAddr, uint16_t Length)
+{
+    (void)DMAx;
+    (void)Stream;
+    (void)PeriphAddr;
+    (void)MemAddr;
+    (void)Length;
+}
+
+void DMA_Stop(DMA_RegDef_t * DMAx, uint8_t Stream)
+{
+    (void)DMAx;
+    (void)Stream;
+}
+
+void DMA_IT_Init(DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Flags, uint8_t Priority)
+{
+    (void)DMAx;
+    (void)Stream;
+    (void)Flags;
+    (void)Priority;
+}
+
+void DMA_RegisterCallback(DMA_RegDef_t * DMAx, uint8_t Stream, DMA_Callback_t Callback, void * Context)
+{
+    (void)DMAx;
+    (void)Stream;
+    (void)Callback;
+    (void)Context;
+}
+
+void NVIC_SetPriority(uint8_t IRQNumber, uint8_t Priority)
+{
+    (void)IRQNumber;
+    (void)Priority;
+}
+
+void NVIC_EnableIRQ(uint8_t IRQNumber)
+{
+    (void)IRQNumber;
+}
+
+void GPIO_PinWrite(GPIO_RegDef_t * GPIOx, uint8_t PinNumber, uint8_t Value)
+{
+    (void)GPIOx;
+    (void)PinNumber;
+    (void)Value;
+}
+
+uint8_t GPIO_PinRead(GPIO_RegDef_t * GPIOx, uint8_t PinNumber)
+{
+    (void)GPIOx;
+    (void)PinNumber;
+    return BIT_SET;
+}
+
+/*1 us per call at 168 MHz*/
+uint32_t Timebase_NowCycles(void)
+{
+    I2C_MockCycleCount += 168U;
+    return I2C_MockCycleCount;
+}
+
+uint32_t Timebase_ElapsedCycles(uint32_t StartCycles)
+{
+    return Timebase_NowCycles() - StartCycles;
+}
+
+uint32_t Timebase_CyclesToUs(uint32_t Cycles)
+{
+    return Cycles / 168U;
+}
+
+void Timebase_DelayUs(uint32_t Us)
+{
+    (void)Us;
+}
+#endif
@@ -0,0 +1,409 @@
+#include "stm32f407xx_rcc_driver.h"
+
+/*AHB prescaler*/
+uint16_t AHB_PreScaler[8] = {2, 4, 8, 16, 64, 128, 256, 512};
+/*APB prescaler*/
+uint16_t APB_PreScaler[4] = {2, 4, 8, 16};
+
+/*Cached clock frequencies, initialized with the reset state (16 MHz HSI, no prescaler)*/
+static RCC_ClockState_t RCC_ClockState =
+{
+    HSI_VALUE, HSI_VALUE, HSI_VALUE, HSI_VALUE, HSI_VALUE, HSI_VALUE
+};
+/*Registered clock change callbacks*/
+static RCC_ClockChangeCallback_t RCC_ClockCallback[RCC_CLOCK_CALLBACK_MAX];
+static uint8_t RCC_ClockCallbackNum = 0U;
+
+/**
+ * @brief This function converts a CFGR HPRE bit field value into the AHB divider.
+ *
+ * @param HPRE Value of the HPRE bit field
+ *
+ * @return uint16_t AHB divider
+ */
+static uint16_t RCC_AHBDiv(uint8_t HPRE)
+{
+    /*Values below 8 mean the system clock is not divided*/
+    return (HPRE < 8U) ? 1U : AHB_PreScaler[HPRE - 8U];
+}
+
+/**
+ * @brief This function converts a CFGR PPRE1/PPRE2 bit field value into the APB divider.
+ *
+ * @param PPRE Value of the PPRE1/PPRE2 bit field
+ *
+ * @return uint16_t APB divider
+ */
+static uint16_t RCC_APBDiv(uint8_t PPRE)
+{
+    /*Values below 4 mean the AHB clock is not divided*/
+    return (PPRE < 4U) ? 1U : APB_PreScaler[PPRE - 4U];
+}
+
+/**
+ * @brief This function waits until a flag of the RCC_CR register reaches the expected state.
+ *
+ * @param FlagPos Bit position of the flag in RCC_CR
+ * @param State Expected state (BIT_SET or BIT_RESET)
+ *
+ * @return uint8_t TRUE if the flag reached the state, FALSE on timeout
+ */
+static uint8_t RCC_WaitCRFlag(uint8_t FlagPos, uint8_t State)
+{
+    uint32_t Timeout = RCC_STARTUP_TIMEOUT;
+
+    while (((RCC->CR >> FlagPos) & 0x01U) != State)
+    {
+        if (Timeout == 0U)
+        {
+            return FALSE;
+        }
+        Timeout--;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief This function switches the system clock source and waits until the switch is done.
+ *
+ * @param Source System clock source, a value of @ref RCC_SysClk_Source
+ */
+static void RCC_SwitchSysClk(uint8_t Source)
+{
+    RCC->CFGR &= ~(0x03U << RCC_CFGR_SW);
+    RCC->CFGR |= ((uint32_t)Source << RCC_CFGR_SW);
+    while (((RCC->CFGR >> RCC_CFGR_SWS) & 0x03U) != Source)
+    {
+        /*Wait until the clock switch is completed*/
+    }
+}
+
+/**
+ * @brief This function sets the flash wait states for the given HCLK and enables the ART accelerator
+ *        (prefetch buffer, instruction cache and data cache).
+ *
+ * @param HCLK AHB clock frequency in Hz
+ */
+static void RCC_FlashConfig(uint32_t HCLK)
+{
+    uint32_t Latency;
+
+    Latency = (HCLK - 1U) / RCC_FLASH_WS_STEP;
+    /*The caches must be disabled before they are reset*/
+    FLASH->ACR &= ~((0x01U << FLASH_ACR_ICEN) | (0x01U << FLASH_ACR_DCEN));
+    FLASH->ACR |= ((0x01U << FLASH_ACR_ICRST) | (0x01U << FLASH_ACR_DCRST));
+    FLASH->ACR &= ~((0x01U << FLASH_ACR_ICRST) | (0x01U << FLASH_ACR_DCRST));
+    /*Set the wait states*/
+    FLASH->ACR &= ~(0x07U << FLASH_ACR_LATENCY);
+    FLASH->ACR |= (Latency << FLASH_ACR_LATENCY);
+    while (((FLASH->ACR >> FLASH_ACR_LATENCY) & 0x07U) != Latency)
+    {
+        /*The new number of wait states must be taken into account before the clock changes*/
+    }
+    /*Enable the ART accelerator*/
+    FLASH->ACR |= ((0x01U << FLASH_ACR_PRFTEN) | (0x01U << FLASH_ACR_ICEN) | (0x01U << FLASH_ACR_DCEN));
+}
+
+/**
+ * @brief This function configures the system clock tree according to the specified settings.
+ *        Example for 168 MHz from the 8 MHz HSE: PLLM = 8, PLLN = 336, PLLP = 2, PLLQ = 7,
+ *        AHB /1 (168 MHz), APB1 /4 (42 MHz), APB2 /2 (84 MHz).
+ *
+ * @param RCC_ClkConf Structer that contains the clock tree configuration
+ *
+ * @return uint8_t TRUE on success, FALSE if an oscillator or the PLL failed to start
+ *         (the system clock is then left on the HSI and the cached frequencies follow it)
+ */
+uint8_t RCC_SysClkConfig(RCC_ClkConf_t RCC_ClkConf)
+{
+    uint32_t SrcClk, NewHCLK, OldHCLK, temp;
+
+    OldHCLK = RCC_ClockState.HCLK;
+
+    /*1. Start the HSI, it is the safe clock while the tree is reconfigured*/
+    RCC->CR |= (0x01U << RCC_CR_HSION);
+    if (RCC_WaitCRFlag(RCC_CR_HSIRDY, BIT_SET) == FALSE)
+    {
+        return FALSE;
+    }
+    if (((RCC->CFGR >> RCC_CFGR_SWS) & 0x03U) == RCC_SYSCLK_PLL)
+    {
+        /*The PLL can not be reconfigured while it clocks the system*/
+        RCC_SwitchSysClk(RCC_SYSCLK_HSI);
+    }
+    /*From here on a failure leaves the system on the HSI, refresh the cached frequencies before returning*/
+
+    /*2. Start the HSE if it is used*/
+    if ((RCC_ClkConf.SysClkSource == RCC_SYSCLK_HSE) ||
+       ((RCC_ClkConf.SysClkSource == RCC_SYSCLK_PLL) && (RCC_ClkConf.PLLSource == RCC_PLLSOURCE_HSE)))
+    {
+        RCC->CR |= (0x01U << RCC_CR_HSEON);
+        if (RCC_WaitCRFlag(RCC_CR_HSERDY, BIT_SET) == FALSE)
+        {
+            RCC_UpdateClockState();
+            return FALSE;
+        }
+    }
+
+    /*3. Configure and start the main PLL*/
+    if (RCC_ClkConf.SysClkSource == RCC_SYSCLK_PLL)
+    {
+        RCC->CR &= ~(0x01U << RCC_CR_PLLON);
+        if (RCC_WaitCRFlag(RCC_CR_PLLRDY, BIT_RESET) == FALSE)
+        {
+            RCC_UpdateClockState();
+            return FALSE;
+        }
+        temp = RCC->PLLCFGR;
+        temp &= ~((0x3FUL << RCC_PLLCFGR_PLLM) | (0x1FFUL << RCC_PLLCFGR_PLLN) | (0x03UL << RCC_PLLCFGR_PLLP)
+                | (0x01UL << RCC_PLLCFGR_PLLSRC) | (0x0FUL << RCC_PLLCFGR_PLLQ));
+        temp |= ((uint32_t)RCC_ClkConf.PLLM << RCC_PLLCFGR_PLLM);
+        temp |= ((uint32_t)RCC_ClkConf.PLLN << RCC_PLLCFGR_PLLN);
+        temp |= ((uint32_t)((RCC_ClkConf.PLLP / 2U) - 1U) << RCC_PLLCFGR_PLLP);
+        temp |= ((uint32_t)RCC_ClkConf.PLLSource << RCC_PLLCFGR_PLLSRC);
+        temp |= ((uint32_t)RCC_ClkConf.PLLQ << RCC_PLLCFGR_PLLQ);
+        RCC->PLLCFGR = temp;
+        /*Voltage scale 1 is needed above 144 MHz*/
+        PWR_CLK_ENB();
+        PWR->CR |= (0x01U << PWR_CR_VOS);
+        RCC->CR |= (0x01U << RCC_CR_PLLON);
+        if (RCC_WaitCRFlag(RCC_CR_PLLRDY, BIT_SET) == FALSE)
+        {
+            RCC_UpdateClockState();
+            return FALSE;
+        }
+    }
+
+    /*4. Compute the new HCLK*/
+    SrcClk = (RCC_ClkConf.PLLSource == RCC_PLLSOURCE_HSE) ? HSE_VALUE : HSI_VALUE;
+    switch (RCC_ClkConf.SysClkSource)
+    {
+        case RCC_SYSCLK_HSE:
+        {
+            SrcClk = HSE_VALUE;
+            break;
+        }
+        case RCC_SYSCLK_PLL:
+        {
+            SrcClk = ((SrcClk / RCC_ClkConf.PLLM) * RCC_ClkConf.PLLN) / RCC_ClkConf.PLLP;
+            break;
+        }
+        default:
+        {
+            SrcClk = HSI_VALUE;
+            break;
+        }
+    }
+    NewHCLK = SrcClk / RCC_AHBDiv(RCC_ClkConf.AHBPrescaler);
+
+    /*5. Increase the flash wait states before the clock gets faster*/
+    if (NewHCLK > OldHCLK)
+    {
+        RCC_FlashConfig(NewHCLK);
+    }
+
+    /*6. Switch the system clock with the slowest APB clocks, then set the APB prescalers*/
+    RCC->CFGR |= ((0x07U << RCC_CFGR_PPRE1) | (0x07U << RCC_CFGR_PPRE2));
+    RCC->CFGR &= ~(0x0FU << RCC_CFGR_HPRE);
+    RCC->CFGR |= ((uint32_t)RCC_ClkConf.AHBPrescaler << RCC_CFGR_HPRE);
+    RCC_SwitchSysClk(RCC_ClkConf.SysClkSource);
+    temp = RCC->CFGR;
+    temp &= ~((0x07U << RCC_CFGR_PPRE1) | (0x07U << RCC_CFGR_PPRE2));
+    temp |= ((uint32_t)RCC_ClkConf.APB1Prescaler << RCC_CFGR_PPRE1);
+    temp |= ((uint32_t)RCC_ClkConf.APB2Prescaler << RCC_CFGR_PPRE2);
+    RCC->CFGR = temp;
+
+    /*7. Decrease the flash wait states after the clock got slower*/
+    if (NewHCLK <= OldHCLK)
+    {
+        RCC_FlashConfig(NewHCLK);
+    }
+
+    /*8. Refresh the cached frequencies and let the drivers follow the new clock*/
+    RCC_UpdateClockState();
+
+    return TRUE;
+}
+
+/**
+ * @brief This function decodes the PLL clock frequency (main PLL P output) from PLLCFGR.
+ *
+ * @return uint32_t
+ */
+static uint32_t RCC_DecodePLLOutputClock(void)
+{
+    uint32_t PLL_In, PLL_M, PLL_N, PLL_P;
+
+    /*PLL entry clock source*/
+    PLL_In = (((RCC->PLLCFGR >> RCC_PLLCFGR_PLLSRC) & 0x01U) == RCC_PLLSOURCE_HSE) ? HSE_VALUE : HSI_VALUE;
+    PLL_M = (RCC->PLLCFGR >> RCC_PLLCFGR_PLLM) & 0x3FU;
+    PLL_N = (RCC->PLLCFGR >> RCC_PLLCFGR_PLLN) & 0x1FFU;
+    PLL_P = (((RCC->PLLCFGR >> RCC_PLLCFGR_PLLP) & 0x03U) + 1U) * 2U;
+    if (PLL_M == 0U)
+    {
+        /*Not applicable*/
+        return 0;
+    }
+
+    /*VCO = PLL input / M * N, the PLL input is an integer number of MHz on this board*/
+    return ((PLL_In / PLL_M) * PLL_N) / PLL_P;
+}
+
+/**
+ * @brief This function decodes the system clock frequency from CFGR.
+ *
+ * @return uint32_t
+ */
+static uint32_t RCC_DecodeSysClk(void)
+{
+    uint32_t SYS_Clk;
+    uint8_t Clk_Src;
+
+    /*Clock source in the MCU*/
+    Clk_Src = (RCC->CFGR >> RCC_CFGR_SWS) & 0x03;
+
+    switch (Clk_Src)
+    {
+        case RCC_SYSCLK_HSI: /* HSI oscillator used as the system clock */
+        {
+            SYS_Clk = HSI_VALUE;
+            break;
+        }
+        case RCC_SYSCLK_HSE: /* HSE oscillator used as the system clock */
+        {
+            SYS_Clk = HSE_VALUE;
+            break;
+        }
+        case RCC_SYSCLK_PLL: /* PLL used as the system clock */
+        {
+            SYS_Clk = RCC_DecodePLLOutputClock();
+            break;
+        }
+        default: /* Not applicable */
+        {
+            SYS_Clk = 0;
+            break;
+        }
+    }
+
+    return SYS_Clk;
+}
+
+/**
+ * @brief This function decodes the clock tree registers once, caches the frequencies and
+ *        calls the registered clock change callbacks.
+ *        It is called by RCC_SysClkConfig and must be called after any other change of RCC_CFGR or RCC_PLLCFGR.
+ */
+void RCC_UpdateClockState(void)
+{
+    uint8_t PPRE1, PPRE2, i;
+
+    PPRE1 = (RCC->CFGR >> RCC_CFGR_PPRE1) & 0x07;
+    PPRE2 = (RCC->CFGR >> RCC_CFGR_PPRE2) & 0x07;
+
+    RCC_ClockState.SysClk  = RCC_DecodeSysClk();
+    RCC_ClockState.HCLK    = RCC_ClockState.SysClk / RCC_AHBDiv((RCC->CFGR >> RCC_CFGR_HPRE) & 0x0F);
+    RCC_ClockState.PCLK1   = RCC_ClockState.HCLK / RCC_APBDiv(PPRE1);
+    RCC_ClockState.PCLK2   = RCC_ClockState.HCLK / RCC_APBDiv(PPRE2);
+    /*The timer clock is twice the APB clock when the APB prescaler is not 1*/
+    RCC_ClockState.TimClk1 = (RCC_APBDiv(PPRE1) == 1U) ? RCC_ClockState.PCLK1 : (2U * RCC_ClockState.PCLK1);
+    RCC_ClockState.TimClk2 = (RCC_APBDiv(PPRE2) == 1U) ? RCC_ClockState.PCLK2 : (2U * RCC_ClockState.PCLK2);
+
+    for (i = 0; i < RCC_ClockCallbackNum; i++)
+    {
+        RCC_ClockCallback[i](&RCC_ClockState);
+    }
+}
+
+/**
+ * @brief This function gets the cached clock frequencies.
+ *
+ * @return const RCC_ClockState_t*
+ */
+const RCC_ClockState_t * RCC_GetClockState(void)
+{
+    return &RCC_ClockState;
+}
+
+/**
+ * @brief This function registers a function called after each clock tree change,
+ *        so that a driver can recompute its prescalers.
+ *
+ * @param Callback Function to be called
+ *
+ * @return uint8_t TRUE on success, FALSE if the callback table is full
+ */
+uint8_t RCC_RegisterClockChangeCallback(RCC_ClockChangeCallback_t Callback)
+{
+    if (RCC_ClockCallbackNum >= RCC_CLOCK_CALLBACK_MAX)
+    {
+        return FALSE;
+    }
+    RCC_ClockCallback[RCC_ClockCallbackNum] = Callback;
+    RCC_ClockCallbackNum++;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function gets PLL clock frequency (main PLL P output).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetPLLOutputClock(void)
+{
+    return RCC_DecodePLLOutputClock();
+}
+
+/**
+ * @brief This function is used to get the system clock frequency (cached).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetSysClkVal(void)
+{
+    return RCC_ClockState.SysClk;
+}
+
+/**
+ * @brief This function is used to get AHB clock (HCLK) frequency (cached).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetHCLKVal(void)
+{
+    return RCC_ClockState.HCLK;
+}
+
+/**
+ * @brief This function is used to get APB1 clock frequency (cached).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetPCLK1Val(void)
+{
+    return RCC_ClockState.PCLK1;
+}
+
+/**
+ * @brief This function is used to get APB2 clock frequency (cached).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetPCLK2Val(void)
+{
+    return RCC_ClockState.PCLK2;
+}
+
+/**
+ * @brief This function is used to get the clock frequency of a timer (CK_INT, cached).
+ *
+ * @param TIMx Pointer to the TIMx (e.g, TIM4, TIM6).
+ *
+ * @return uint32_t
+ */
+uint32_t RCC_GetTIMxClkVal(TIM_RegDef_t * TIMx)
+{
+    return TIMx_ON_APB2(TIMx) ? RCC_ClockState.TimClk2 : RCC_ClockState.TimClk1;
+}
@@ -0,0 +1,503 @@
+#include "stm32f407xx_spi_driver.h"
+#include "timebase.h"
+
+/*Maximum number of status reads while the last frame leaves the shift register*/
+#define SPI_BUSY_WAIT_MAX           1000U
+
+/*DMA streams of one SPI*/
+typedef struct
+{
+    DMA_RegDef_t * DMAx;
+    uint8_t TxStream;
+    uint8_t TxChannel;
+    uint8_t RxStream;
+    uint8_t RxChannel;
+} SPI_DMAMap_t;
+
+/*Driver state of one SPI*/
+typedef struct
+{
+    SPI_Conf_t Conf;
+    uint8_t Initialized;
+    uint8_t UsingDMA;                   /*TRUE if the running transfer is moved by DMA*/
+    uint16_t Index;                     /*Frames of the running transfer received (interrupt mode)*/
+    uint16_t Queued;                    /*Number of transfers waiting in the queue*/
+    SPI_Transfer_t * pCurrent;          /*Running transfer, NULL when the bus is idle*/
+    SPI_Transfer_t * pHead;             /*Queue of the waiting transfers*/
+    SPI_Transfer_t * pTail;
+    uint32_t StartCycles;               /*Timebase_NowCycles value at the start of the running transfer*/
+    SPI_Stats_t Stats;
+} SPI_State_t;
+
+/*Driver state of each SPI*/
+static SPI_State_t SPI_State[SPI_INSTANCE_NUM];
+/*DMA streams of each SPI*/
+static const SPI_DMAMap_t SPI_DmaMap[SPI_INSTANCE_NUM] = SPI_DMA_STREAMS;
+/*Source of the frames sent and sink of the frames dropped by a DMA transfer without data buffer*/
+static const uint16_t SPI_DummyTx = SPI_DUMMY_FRAME;
+static uint16_t SPI_DummyRx;
+
+/**
+ * @brief This function applies the settings of a device, the SPI is disabled only if they change.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pDevice Device of the transfer
+ */
+static void SPI_ApplyDevice(SPI_RegDef_t * SPIx, const SPI_Device_t * pDevice)
+{
+    uint32_t Cr1;
+
+    /*Master, software slave management (NSS kept high internally)*/
+    Cr1 = (0x01U << SPI_CR1_MSTR) | (0x01U << SPI_CR1_SSM) | (0x01U << SPI_CR1_SSI);
+    Cr1 |= ((uint32_t)(pDevice->BaudPrescaler & 0x07U) << SPI_CR1_BR);
+    Cr1 |= ((uint32_t)pDevice->CPOL << SPI_CR1_CPOL);
+    Cr1 |= ((uint32_t)pDevice->CPHA << SPI_CR1_CPHA);
+    Cr1 |= ((uint32_t)pDevice->FrameFormat << SPI_CR1_DFF);
+    Cr1 |= ((uint32_t)pDevice->LsbFirst << SPI_CR1_LSBFIRST);
+    if ((SPIx->CR1 & ~(0x01U << SPI_CR1_SPE)) != Cr1)
+    {
+        /*The frame format and the clock settings are changed with the SPI disabled*/
+        SPIx->CR1 &= ~(0x01U << SPI_CR1_SPE);
+        SPIx->CR1 = Cr1;
+    }
+    SPIx->CR1 = Cr1 | (0x01U << SPI_CR1_SPE);
+}
+
+/**
+ * @brief This function writes one frame of the running transfer in the data register.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pXfer Running transfer
+ * @param Index Frame index
+ */
+static void SPI_WriteFrame(SPI_RegDef_t * SPIx, const SPI_Transfer_t * pXfer, uint16_t Index)
+{
+    if (pXfer->pTxData == NULL)
+    {
+        SPIx->DR = SPI_DUMMY_FRAME;
+    }
+    else if (pXfer->pDevice->FrameFormat == SPI_FRAME_16BIT)
+    {
+        SPIx->DR = ((const uint16_t *)pXfer->pTxData)[Index];
+    }
+    else
+    {
+        SPIx->DR = ((const uint8_t *)pXfer->pTxData)[Index];
+    }
+}
+
+/**
+ * @brief This function reads one frame of the running transfer from the data register.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pXfer Running transfer
+ * @param Index Frame index
+ */
+static void SPI_ReadFrame(SPI_RegDef_t * SPIx, SPI_Transfer_t * pXfer, uint16_t Index)
+{
+    uint16_t Frame = (uint16_t)SPIx->DR;
+
+    if (pXfer->pRxData == NULL)
+    {
+        return;
+    }
+    if (pXfer->pDevice->FrameFormat == SPI_FRAME_16BIT)
+    {
+        ((uint16_t *)pXfer->pRxData)[Index] = Frame;
+    }
+    else
+    {
+        ((uint8_t *)pXfer->pRxData)[Index] = (uint8_t)Frame;
+    }
+}
+
+/**
+ * @brief This function starts the current transfer (pState->pCurrent): device settings, chip select,
+ *        then the first frame or the DMA streams.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pState Driver state of the SPI
+ */
+static void SPI_StartTransfer(SPI_RegDef_t * SPIx, SPI_State_t * pState)
+{
+    SPI_Transfer_t * pXfer = pState->pCurrent;
+    const SPI_DMAMap_t * pDma = &SPI_DmaMap[SPIx_TO_INDEX(SPIx)];
+    uint8_t Size;
+    uint32_t temp;
+
+    pState->StartCycles = Timebase_NowCycles();
+    pState->Index = 0U;
+    SPI_ApplyDevice(SPIx, pXfer->pDevice);
+    /*Drop a frame left by an aborted transfer and clear the overrun flag (DR then SR read)*/
+    temp = SPIx->DR;
+    temp = SPIx->SR;
+    (void)temp;
+    if (pXfer->Begin != NULL)
+    {
+        pXfer->Begin(pXfer);
+    }
+    if (pXfer->pDevice->pCsPort != NULL)
+    {
+        GPIO_PinWrite(pXfer->pDevice->pCsPort, pXfer->pDevice->CsPin, BIT_RESET);
+    }
+    if ((pState->Conf.UseDMA == TRUE) && (pXfer->Length >= SPI_DMA_MIN))
+    {
+        /*The reception stream is enabled first, so no received frame is lost*/
+        pState->UsingDMA = TRUE;
+        pState->Stats.DMATransfers++;
+        Size = (pXfer->pDevice->FrameFormat == SPI_FRAME_16BIT) ? DMA_SIZE_HALFWORD : DMA_SIZE_BYTE;
+        DMA_SetDataFormat(pDma->DMAx, pDma->RxStream,
+                          (pXfer->pRxData != NULL) ? DMA_INC_ENABLE : DMA_INC_DISABLE, Size);
+        DMA_SetDataFormat(pDma->DMAx, pDma->TxStream,
+                          (pXfer->pTxData != NULL) ? DMA_INC_ENABLE : DMA_INC_DISABLE, Size);
+        DMA_Start(pDma->DMAx, pDma->RxStream, (uint32_t)&SPIx->DR,
+                  (pXfer->pRxData != NULL) ? (uint32_t)pXfer->pRxData : (uint32_t)&SPI_DummyRx, pXfer->Length);
+        DMA_Start(pDma->DMAx, pDma->TxStream, (uint32_t)&SPIx->DR,
+                  (pXfer->pTxData != NULL) ? (uint32_t)pXfer->pTxData : (uint32_t)&SPI_DummyTx, pXfer->Length);
+        SPIx->CR2 |= (0x01U << SPI_CR2_RXDMAEN);
+        SPIx->CR2 |= (0x01U << SPI_CR2_TXDMAEN);
+    }
+    else
+    {
+        /*One frame in flight, the next one is written when the previous one is received*/
+        pState->UsingDMA = FALSE;
+        SPIx->CR2 |= (0x01U << SPI_CR2_RXNEIE) | (0x01U << SPI_CR2_ERRIE);
+        SPI_WriteFrame(SPIx, pXfer, 0U);
+    }
+}
+
+/**
+ * @brief This function ends the running transfer, releases the chip select, calls the Done callback and
+ *        starts the next queued transfer.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pState Driver state of the SPI
+ * @param Status Result of the transfer, @ref SPI_Status
+ */
+static void SPI_Complete(SPI_RegDef_t * SPIx, SPI_State_t * pState, uint8_t Status)
+{
+    SPI_Transfer_t * pXfer = pState->pCurrent;
+    uint32_t Wait = 0U;
+
+    SPIx->CR2 &= ~((0x01U << SPI_CR2_RXNEIE) | (0x01U << SPI_CR2_ERRIE)
+                   | (0x01U << SPI_CR2_RXDMAEN) | (0x01U << SPI_CR2_TXDMAEN));
+    /*The last frame is received, the clock stops half a bit later*/
+    while ((((SPIx->SR >> SPI_SR_BSY) & 0x01U) == BIT_SET) && (Wait < SPI_BUSY_WAIT_MAX))
+    {
+        Wait++;
+    }
+    if (pXfer->pDevice->pCsPort != NULL)
+    {
+        GPIO_PinWrite(pXfer->pDevice->pCsPort, pXfer->pDevice->CsPin, BIT_SET);
+    }
+    pState->Stats.Transfers++;
+    pState->Stats.ActiveTime += Timebase_CyclesToUs(Timebase_ElapsedCycles(pState->StartCycles));
+    if (Status == SPI_STATUS_OK)
+    {
+        pState->Stats.Frames += pXfer->Length;
+    }
+    else
+    {
+        pState->Stats.Errors++;
+    }
+    pState->pCurrent = NULL;
+    pState->UsingDMA = FALSE;
+    pXfer->Status = Status;
+    if (pXfer->Done != NULL)
+    {
+        pXfer->Done(pXfer);
+    }
+    /*Next queued transfer, unless Done submitted one on an empty queue, which is already started*/
+    if ((pState->pCurrent == NULL) && (pState->pHead != NULL))
+    {
+        pState->pCurrent = pState->pHead;
+        pState->pHead = pState->pCurrent->pNext;
+        if (pState->pHead == NULL)
+        {
+            pState->pTail = NULL;
+        }
+        pState->Queued--;
+        SPI_StartTransfer(SPIx, pState);
+    }
+}
+
+/**
+ * @brief This function is called from the DMA interrupt when the reception stream of an SPI ends,
+ *        the last frame is received: the transfer is done.
+ *
+ * @param Flags DMA flags of the stream (DMA_FLAG_TC, DMA_FLAG_TE)
+ * @param Context SPI peripheral
+ */
+static void SPI_RxDMACallback(uint8_t Flags, void * Context)
+{
+    SPI_RegDef_t * SPIx = (SPI_RegDef_t *)Context;
+    SPI_State_t * pState = &SPI_State[SPIx_TO_INDEX(SPIx)];
+    const SPI_DMAMap_t * pDma = &SPI_DmaMap[SPIx_TO_INDEX(SPIx)];
+
+    if ((pState->pCurrent == NULL) || (pState->UsingDMA == FALSE))
+    {
+        return;
+    }
+    if ((Flags & DMA_FLAG_TE) != 0U)
+    {
+        DMA_Stop(pDma->DMAx, pDma->TxStream);
+        SPI_Complete(SPIx, pState, SPI_STATUS_ERROR);
+    }
+    else if ((Flags & DMA_FLAG_TC) != 0U)
+    {
+        SPI_Complete(SPIx, pState, SPI_STATUS_OK);
+    }
+}
+
+/**
+ * @brief This function is called from the DMA interrupt on a transmission stream error.
+ *
+ * @param Flags DMA flags of the stream (DMA_FLAG_TE)
+ * @param Context SPI peripheral
+ */
+static void SPI_TxDMACallback(uint8_t Flags, void * Context)
+{
+    SPI_RegDef_t * SPIx = (SPI_RegDef_t *)Context;
+    SPI_State_t * pState = &SPI_State[SPIx_TO_INDEX(SPIx)];
+    const SPI_DMAMap_t * pDma = &SPI_DmaMap[SPIx_TO_INDEX(SPIx)];
+
+    if ((pState->pCurrent == NULL) || (pState->UsingDMA == FALSE) || ((Flags & DMA_FLAG_TE) == 0U))
+    {
+        return;
+    }
+    DMA_Stop(pDma->DMAx, pDma->RxStream);
+    SPI_Complete(SPIx, pState, SPI_STATUS_ERROR);
+}
+
+/**
+ * @brief This function initializes an SPI as full duplex master. The pins and the peripheral clock are set
+ *        by the board tables, the chip select pins are GPIO outputs set high. The device settings are applied
+ *        by each transfer.
+ *
+ * @note The queued transfers are dropped, the bus must be idle.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param SPI_Conf Structer that contains the configuration information of the SPI
+ *
+ * @return uint8_t TRUE on success, FALSE if the SPI is not handled
+ */
+uint8_t SPI_Init(SPI_RegDef_t * SPIx, SPI_Conf_t SPI_Conf)
+{
+    uint8_t Index = SPIx_TO_INDEX(SPIx);
+    SPI_State_t * pState;
+    const SPI_DMAMap_t * pDma;
+    DMA_Conf_t DmaConf;
+    SPI_Stats_t Empty = {0};
+
+    if (Index >= SPI_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
+    pState = &SPI_State[Index];
+    pDma = &SPI_DmaMap[Index];
+    /*1. Master with software slave management, disabled until the first transfer*/
+    SPIx->CR1 = (0x01U << SPI_CR1_MSTR) | (0x01U << SPI_CR1_SSM) | (0x01U << SPI_CR1_SSI);
+    SPIx->CR2 = 0U;
+    /*2. Reset the driver state*/
+    pState->Conf = SPI_Conf;
+    pState->UsingDMA = FALSE;
+    pState->pCurrent = NULL;
+    pState->pHead = NULL;
+    pState->pTail = NULL;
+    pState->Queued = 0U;
+    pState->Stats = Empty;
+    /*3. DMA streams, the memory increment and the data size are set by each transfer*/
+    if (SPI_Conf.UseDMA == TRUE)
+    {
+        DmaConf.PeriphInc = DMA_INC_DISABLE;
+        DmaConf.MemInc = DMA_INC_ENABLE;
+        DmaConf.PeriphDataSize = DMA_SIZE_BYTE;
+        DmaConf.MemDataSize = DMA_SIZE_BYTE;
+        DmaConf.Mode = DMA_MODE_NORMAL;
+        DmaConf.Priority = DMA_PRIORITY_HIGH;
+        DmaConf.Channel = pDma->TxChannel;
+        DmaConf.Direction = DMA_DIR_M2P;
+        DMA_Init(pDma->DMAx, pDma->TxStream, DmaConf);
+        DMA_RegisterCallback(pDma->DMAx, pDma->TxStream, SPI_TxDMACallback, SPIx);
+        DmaConf.Channel = pDma->RxChannel;
+        DmaConf.Direction = DMA_DIR_P2M;
+        DMA_Init(pDma->DMAx, pDma->RxStream, DmaConf);
+        DMA_RegisterCallback(pDma->DMAx, pDma->RxStream, SPI_RxDMACallback, SPIx);
+    }
+    pState->Initialized = TRUE;
+    return TRUE;
+}
+
+/**
+ * @brief This function sets the priority and enables the interrupt of an SPI, and the interrupts of its
+ *        DMA streams when it uses DMA. SPI_Init must be called first.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param Priority Priority of the interrupts, shared by the DMA streams so they never preempt each other
+ *
+ * @return uint8_t TRUE on success, FALSE if the SPI is not handled
+ */
+uint8_t SPI_IT_Init(SPI_RegDef_t * SPIx, uint8_t Priority)
+{
+    const SPI_DMAMap_t * pDma;
+
+    if (SPIx_TO_INDEX(SPIx) >= SPI_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
+    pDma = &SPI_DmaMap[SPIx_TO_INDEX(SPIx)];
+    NVIC_SetPriority(SPIx_TO_IRQ(SPIx), Priority);
+    NVIC_EnableIRQ(SPIx_TO_IRQ(SPIx));
+    if (SPI_State[SPIx_TO_INDEX(SPIx)].Conf.UseDMA == TRUE)
+    {
+        DMA_IT_Init(pDma->DMAx, pDma->TxStream, DMA_FLAG_TE, Priority);
+        DMA_IT_Init(pDma->DMAx, pDma->RxStream, DMA_FLAG_TC | DMA_FLAG_TE, Priority);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the smallest baud prescaler giving a clock not above a maximum speed,
+ *        from the current clock of the SPI (PCLK2 for SPI1, PCLK1 for SPI2 and SPI3).
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param MaxSpeed Maximum clock of the device in Hz
+ *
+ * @return uint8_t Prescaler, @ref SPI_Baud (SPI_BAUD_DIV256 if MaxSpeed can not be reached)
+ */
+uint8_t SPI_GetBaudPrescaler(SPI_RegDef_t * SPIx, uint32_t MaxSpeed)
+{
+    uint32_t Clock = (SPIx == SPI1) ? RCC_GetPCLK2Val() : RCC_GetPCLK1Val();
+    uint8_t Prescaler;
+
+    for (Prescaler = SPI_BAUD_DIV2; Prescaler < SPI_BAUD_DIV256; Prescaler++)
+    {
+        if ((Clock >> (Prescaler + 1U)) <= MaxSpeed)
+        {
+            break;
+        }
+    }
+    return Prescaler;
+}
+
+/**
+ * @brief This function queues a transfer, it is started at once if the bus is idle.
+ *        The transfer must stay valid and unchanged until its Done callback is called.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ * @param pXfer Transfer to be queued, its Status is SPI_STATUS_PENDING until the end of the transfer
+ *
+ * @return uint8_t TRUE if the transfer is queued, FALSE if the SPI is not handled or the transfer is not valid
+ *         or already queued
+ */
+uint8_t SPI_Submit(SPI_RegDef_t * SPIx, SPI_Transfer_t * pXfer)
+{
+    SPI_State_t * pState;
+    uint32_t Lock;
+
+    if (SPIx_TO_INDEX(SPIx) >= SPI_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
+    pState = &SPI_State[SPIx_TO_INDEX(SPIx)];
+    if ((pXfer == NULL) || (pState->Initialized == FALSE) || (pXfer->pDevice == NULL) || (pXfer->Length == 0U)
+        || (pXfer->Status == SPI_STATUS_PENDING))
+    {
+        return FALSE;
+    }
+    pXfer->Status = SPI_STATUS_PENDING;
+    pXfer->pNext = NULL;
+    Lock = CM4_IRQSave();
+    /*A transfer submitted from a Done callback waits behind the queued ones*/
+    if ((pState->pCurrent == NULL) && (pState->pHead == NULL))
+    {
+        pState->pCurrent = pXfer;
+        SPI_StartTransfer(SPIx, pState);
+    }
+    else
+    {
+        if (pState->pTail == NULL)
+        {
+            pState->pHead = pXfer;
+        }
+        else
+        {
+            pState->pTail->pNext = pXfer;
+        }
+        pState->pTail = pXfer;
+        pState->Queued++;
+        if (pState->Queued > pState->Stats.HighWater)
+        {
+            pState->Stats.HighWater = pState->Queued;
+        }
+    }
+    CM4_IRQRestore(Lock);
+    return TRUE;
+}
+
+/**
+ * @brief This function checks if an SPI has no running or queued transfer.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ *
+ * @return uint8_t TRUE if idle, FALSE otherwise
+ */
+uint8_t SPI_IsIdle(SPI_RegDef_t * SPIx)
+{
+    SPI_State_t * pState = &SPI_State[SPIx_TO_INDEX(SPIx)];
+
+    return ((pState->pCurrent == NULL) && (pState->pHead == NULL)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function gets the statistics of an SPI.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ *
+ * @return const SPI_Stats_t*
+ */
+const SPI_Stats_t * SPI_GetStats(SPI_RegDef_t * SPIx)
+{
+    return &SPI_State[SPIx_TO_INDEX(SPIx)].Stats;
+}
+
+/**
+ * @brief This function handles the interrupt of an SPI (interrupt mode transfers): each received frame
+ *        is stored and the next one is sent, an overrun ends the transfer.
+ *
+ * @param SPIx Pointer to the SPI peripheral (SPI1, SPI2 or SPI3).
+ */
+void SPI_IRQHandling(SPI_RegDef_t * SPIx)
+{
+    SPI_State_t * pState = &SPI_State[SPIx_TO_INDEX(SPIx)];
+    SPI_Transfer_t * pXfer = pState->pCurrent;
+    uint32_t Sr = SPIx->SR;
+    uint32_t temp;
+
+    if ((pXfer == NULL) || (pState->UsingDMA == TRUE))
+    {
+        SPIx->CR2 &= ~((0x01U << SPI_CR2_RXNEIE) | (0x01U << SPI_CR2_ERRIE));
+        return;
+    }
+    if (((Sr >> SPI_SR_OVR) & 0x01U) == BIT_SET)
+    {
+        /*The overrun flag is cleared by a DR read followed by a SR read*/
+        temp = SPIx->DR;
+        temp = SPIx->SR;
+        (void)temp;
+        SPI_Complete(SPIx, pState, SPI_STATUS_ERROR);
+    }
+    else if (((Sr >> SPI_SR_RXNE) & 0x01U) == BIT_SET)
+    {
+        SPI_ReadFrame(SPIx, pXfer, pState->Index);
+        pState->Index++;
+        if (pState->Index < pXfer->Length)
+        {
+            SPI_WriteFrame(SPIx, pXfer, pState->Index);
+        }
+        else
+        {
+            SPI_Complete(SPIx, pState, SPI_STATUS_OK);
+        }
+    }
+}
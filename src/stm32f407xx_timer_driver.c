@@ -1,21 +1,72 @@
 #include "stm32f407xx_timer_driver.h"
 
+/*Timers of the driver state tables, in the TIMx_TO_INDEX order*/
+static TIM_RegDef_t * const TIM_Instance[TIM_INSTANCE_NUM] = {TIM2, TIM3, TIM4, TIM5, TIM6, TIM7};
+/*Requested counter clock of each timer, 0 when the prescaler is fixed*/
+static uint32_t TIM_CounterClock[TIM_INSTANCE_NUM];
+/*The clock change callback is registered once*/
+static uint8_t TIM_ClockCallbackRegistered = FALSE;
+
+/**
+ * @brief This function recomputes the prescaler of the timers initialized with a counter clock
+ *        after a clock tree change. The new prescaler is taken into account at the next update event.
+ * 
+ * @param pClocks New clock frequencies
+ */
+static void TIM_ClockChangeCallback(const RCC_ClockState_t * pClocks)
+{
+    uint8_t i;
+
+    (void)pClocks;
+    for (i = 0; i < TIM_INSTANCE_NUM; i++)
+    {
+        if (TIM_CounterClock[i] != 0U)
+        {
+            TIM_Instance[i]->PSC = TIM_CalcPrescaler(TIM_Instance[i], TIM_CounterClock[i]);
+        }
+    }
+}
+
 /**
  * @brief This function is used to initialize the timer base unit
  * 
  * @param TIMx Pointer to the TIMx (e.g, TIM4, TIM6).
  * @param TIM_BaseConf Structer that contains the configuration information of a specified TIMx.
+ * 
+ * @return uint8_t TRUE if the timer is initialized, FALSE if it is not handled by the driver (TIM2 to TIM7)
  */
-void TIM_Base_Init(TIM_RegDef_t * TIMx, TIM_Base_Conf_t TIM_BaseConf)
+uint8_t TIM_Base_Init(TIM_RegDef_t * TIMx, TIM_Base_Conf_t TIM_BaseConf)
 {
+    uint8_t Index = TIMx_TO_INDEX(TIMx);
+
+    if (Index >= TIM_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
     /*Set the auto-reload preload*/
     TIMx->CR1 |= (TIM_BaseConf.AutoReloadPreload << TIM_CR1_ARPE);
     /*Set the auto-reload value*/
     TIMx->ARR = TIM_BaseConf.Period;
-    /*Set the prescaler value*/
-    TIMx->PSC = TIM_BaseConf.Prescaler;
+    /*Set the prescaler value, or derive it from the counter clock and follow the clock changes*/
+    TIM_CounterClock[Index] = TIM_BaseConf.CounterClock;
+    if (TIM_BaseConf.CounterClock != 0U)
+    {
+        TIMx->PSC = TIM_CalcPrescaler(TIMx, TIM_BaseConf.CounterClock);
+        if (TIM_ClockCallbackRegistered == FALSE)
+        {
+            TIM_ClockCallbackRegistered = RCC_RegisterClockChangeCallback(TIM_ClockChangeCallback);
+        }
+    }
+    else
+    {
+        TIMx->PSC = TIM_BaseConf.Prescaler;
+    }
     /*Set timer counting mode*/
     TIMx->CR1 |= (TIM_BaseConf.CounterMode << TIM_CR1_DIR);
+    /*Set the sampling clock of the input filters*/
+    TIMx->CR1 &= ~(0x03U << TIM_CR1_CKD);
+    TIMx->CR1 |= (TIM_BaseConf.ClockDivision << TIM_CR1_CKD);
+    return TRUE;
 }
 
 void TIM_Base_ForceUpdate(TIM_RegDef_t * TIMx)
@@ -87,4 +138,113 @@ void TIM_OC_Init(TIM_RegDef_t * TIMx, TIM_OC_Conf_t TIM_OCConf, uint8_t Channel)
     TIMx->CCR[Channel] = TIM_OCConf.Pulse;
     /*Enable the compare*/
     TIMx->CCER |= (ENABLE << Channel*4);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief This function computes the prescaler value giving the requested counter clock
+ *        from the current timer clock (see RCC_GetTIMxClkVal).
+ * 
+ * @param TIMx Pointer to the TIMx (e.g, TIM4, TIM6).
+ * @param CounterClock Requested counter clock in Hz
+ * 
+ * @return uint16_t Value to be used as TIM_Base_Conf_t.Prescaler, saturated to 0xFFFF
+ */
+uint16_t TIM_CalcPrescaler(TIM_RegDef_t * TIMx, uint32_t CounterClock)
+{
+    uint32_t Prescaler;
+
+    Prescaler = RCC_GetTIMxClkVal(TIMx) / CounterClock;
+    if (Prescaler == 0U)
+    {
+        return 0U;
+    }
+    if (Prescaler > 0x10000U)
+    {
+        return 0xFFFFU;
+    }
+
+    return (uint16_t)(Prescaler - 1U);
+}
+
+/**
+ * @brief This function is used to initialize an input capture channel.
+ *        The counter value is latched in CCRx by the hardware on each selected edge, after the input filter.
+ * 
+ * @param TIMx Pointer to the TIMx (e.g, TIM2, TIM5).
+ * @param TIM_ICConf Structer that contains the input capture configuration.
+ * @param Channel Input capture channel to be configured.
+ */
+void TIM_IC_Init(TIM_RegDef_t * TIMx, TIM_IC_Conf_t TIM_ICConf, uint8_t Channel)
+{
+    uint8_t CCMR_Reg_Index, CCMR_Bit_Offset;
+    uint32_t temp;
+    CCMR_Reg_Index = Channel / 2;
+    CCMR_Bit_Offset = (Channel % 2) * 8;
+
+    /*The channel must be disabled while CCxS is written*/
+    TIMx->CCER &= ~(0x01U << (Channel*4 + TIM_CCER_CCE));
+    /*Set the input selection, prescaler and filter*/
+    temp = TIMx->CCMR[CCMR_Reg_Index];
+    temp &= ~(0xFFU << CCMR_Bit_Offset);
+    temp |= ((uint32_t)TIM_ICConf.ICSelection << (CCMR_Bit_Offset + TIM_CCMR_CCS));
+    temp |= ((uint32_t)TIM_ICConf.ICPrescaler << (CCMR_Bit_Offset + TIM_CCMR_ICPSC));
+    temp |= ((uint32_t)(TIM_ICConf.ICFilter & 0x0FU) << (CCMR_Bit_Offset + TIM_CCMR_ICF));
+    TIMx->CCMR[CCMR_Reg_Index] = temp;
+    /*Set the active edge, CCxP is bit 0 and CCxNP is bit 2 of the polarity value*/
+    TIMx->CCER &= ~(((0x01U << TIM_CCER_CCP) | (0x01U << TIM_CCER_CCNP)) << (Channel*4));
+    TIMx->CCER |= ((uint32_t)TIM_ICConf.ICPolarity << (Channel*4 + TIM_CCER_CCP));
+    /*Enable the capture*/
+    TIMx->CCER |= (ENABLE << (Channel*4 + TIM_CCER_CCE));
+}
+
+/**
+ * @brief This function enables the capture interrupt of a channel
+ * 
+ * @param TIMx Pointer to the TIMx (e.g, TIM2, TIM5).
+ * @param Channel Input capture channel.
+ * @param Priority Interrupt priority to be set
+ */
+void TIM_IC_IT_Init(TIM_RegDef_t * TIMx, uint8_t Channel, uint8_t Priority)
+{
+    /* Set the interrupt priority for TIMx */
+    NVIC_SetPriority(TIMx_TO_IRQ(TIMx), Priority);
+    /* Enable the IRQ of TIMx */
+    NVIC_EnableIRQ(TIMx_TO_IRQ(TIMx));
+    /* Enable the capture interrupt of the channel */
+    TIMx->DIER |= (0x01U << (TIM_DIER_CC1IE + Channel));
+}
+
+/**
+ * @brief This function enables the DMA request of a capture channel, the DMA stream then copies
+ *        CCRx (peripheral address &TIMx->CCR[Channel]) to memory on each capture.
+ * 
+ * @param TIMx Pointer to the TIMx (e.g, TIM2, TIM5).
+ * @param Channel Input capture channel.
+ */
+void TIM_IC_DMA_Enable(TIM_RegDef_t * TIMx, uint8_t Channel)
+{
+    TIMx->DIER |= (0x01U << (TIM_DIER_CC1DE + Channel));
+}
+
+/**
+ * @brief This function reads the last capture of a channel if a new one is available.
+ *        Reading CCRx clears the capture flag, the overcapture flag (captures lost before this read) is cleared too.
+ * 
+ * @param TIMx Pointer to the TIMx (e.g, TIM2, TIM5).
+ * @param Channel Input capture channel.
+ * @param pCapture Captured counter value
+ * 
+ * @return uint8_t TRUE if a new capture was read, FALSE otherwise
+ */
+uint8_t TIM_IC_GetCapture(TIM_RegDef_t * TIMx, uint8_t Channel, uint32_t * pCapture)
+{
+    if (((TIMx->SR >> (TIM_SR_CC1IF + Channel)) & 0x01U) == 0U)
+    {
+        return FALSE;
+    }
+    *pCapture = TIMx->CCR[Channel];
+    /*The flags are cleared by writing 0, writing 1 has no effect*/
+    TIMx->SR = ~(0x01U << (TIM_SR_CC1OF + Channel));
+
+    return TRUE;
+}
@@ -1,159 +1,68 @@
 #include "stm32f407xx_usart_driver.h"
 
-/*AHB prescaler*/
-uint16_t AHB_PreScaler[8] = {2, 4, 8, 16, 64, 128, 256, 512};
-/*APB prescaler*/
-uint16_t APB_PreScaler[4] = {2, 4, 8, 16};
+/*Interrupt driven transmit state of each USART*/
+static USART_TxState_t USART_TxState[USART_INSTANCE_NUM];
+/*DMA circular reception state of each USART*/
+static USART_RxDMAState_t USART_RxDMAState[USART_INSTANCE_NUM];
+/*USARTs of the driver state tables, in the USARTx_TO_INDEX order*/
+static USART_RegDef_t * const USART_Instance[USART_INSTANCE_NUM] = {USART1, USART2, USART3, UART4, UART5, USART6};
+/*Baud rate of each initialized USART, 0 when the USART is not initialized*/
+static uint32_t USART_BaudRate[USART_INSTANCE_NUM];
+/*The clock change callback is registered once*/
+static uint8_t USART_ClockCallbackRegistered = FALSE;
 
 /**
- * @brief This function gets PLL clock frequency.
- *        It is a dummy function and always return 0.
- *        The implementation should be completed in when PLL is applied in project.
+ * @brief This function recomputes the baud rate register of the initialized USARTs after a clock tree change.
  * 
- * @return uint32_t 
- */
-uint32_t RCC_GetPLLOutputClock(void)
-{
-    /*PLL clock is not used in this application*/
-    return 0;
-}
-
-/**
- * @brief This function is used to get APB1 clock frequency.
- *        Change the value of HSI and and HSE as respect to the MCU. 
+ * @note A byte being transferred while the clock changes is corrupted.
  * 
- * @return uint32_t 
+ * @param pClocks New clock frequencies
  */
-uint32_t RCC_GetPCLK1Val(void)
+static void USART_ClockChangeCallback(const RCC_ClockState_t * pClocks)
 {
-    uint32_t P_Clk1, SYS_Clk;
-    uint8_t Clk_Src, temp, AHB_Pre, APB1_Pre;
-
-    /*Clock source in the MCU*/
-    Clk_Src = (RCC->CFGR >> 2) & 0x03;
+    uint8_t i;
 
-    switch (Clk_Src)
+    (void)pClocks;
+    for (i = 0; i < USART_INSTANCE_NUM; i++)
     {
-        case 0: /* HSI oscillator used as the system clock */
+        if (USART_BaudRate[i] != 0U)
         {
-            SYS_Clk = 16000000;
-            break;
+            USART_SetBaudRate(USART_Instance[i], USART_BaudRate[i]);
         }
-        case 1: /* HSE oscillator used as the system clock */
-        {
-            SYS_Clk = 8000000;
-            break;
-        }
-        case 2: /* PLL used as the system clock */
-        {
-            SYS_Clk = RCC_GetPLLOutputClock();
-            break;
-        }
-        default: /* Not applicable */
-        {
-					SYS_Clk = 0;
-            break;
-        } 
-    }
-
-    /* Get the AHB PreScasler */
-    temp = (RCC->CFGR >> 4) & 0x0F;
-    if (temp < 8)
-    {
-        /*System clock is not divided*/
-        AHB_Pre = 1;
-    }
-    else
-    {
-        /*System clock is divided*/
-        AHB_Pre = AHB_PreScaler[temp - 8];
-    }
-
-    /* Get the APB1 PreScasler */
-    temp = (RCC->CFGR >> 10) & 0x07;
-    if (temp < 4)
-    {
-        /*AHB clock is not divided*/
-        APB1_Pre = 1;
-    }
-    else
-    {
-        /*AHB clock is divided*/
-        APB1_Pre = APB_PreScaler[temp - 4];
     }
-    /*Set peripheral clock*/
-    P_Clk1 = (SYS_Clk / AHB_Pre) / APB1_Pre;
-
-    return P_Clk1;
 }
 
 /**
- * @brief This function is used to get APB2 clock frequency.
- *        Change the value of HSI and and HSE as respect to the MCU. 
+ * @brief This function sets the BRR register for the given baud rate from the current
+ *        peripheral clock and the oversampling mode already set in CR1.
  * 
- * @return uint32_t 
+ * @param USARTx Pointer to the USART port to be configured (e.g, USART1, USART2).
+ * @param BaudRate Baud rate in bit per second, a value of @ref USART_Common_Baudrate
  */
-uint32_t RCC_GetPCLK2Val(void)
+void USART_SetBaudRate(USART_RegDef_t * USARTx, uint32_t BaudRate)
 {
-    uint32_t P_Clk2, SYS_Clk;
-    uint8_t Clk_Src, temp, AHB_Pre, APB2_Pre;
-
-    /*Clock source in the MCU*/
-    Clk_Src = (RCC->CFGR >> 2) & 0x03;
-
-    switch (Clk_Src)
-    {
-        case 0: /* HSI oscillator used as the system clock */
-        {
-            SYS_Clk = 16000000;
-            break;
-        }
-        case 1: /* HSE oscillator used as the system clock */
-        {
-            SYS_Clk = 8000000;
-            break;
-        }
-        case 2: /* PLL used as the system clock */
-        {
-            SYS_Clk = RCC_GetPLLOutputClock();
-            break;
-        }
-        default: /* Not applicable */
-        {
-					  SYS_Clk = 0;
-            break;
-        } 
-    }
+    uint32_t Mantissa, Fraction, Remainder, Scaling;
+    uint32_t USARTx_Clk;
+    uint8_t Index = USARTx_TO_INDEX(USARTx);
 
-    /* Get the AHB PreScasler */
-    temp = (RCC->CFGR >> 4) & 0x0F;
-    if (temp < 8)
-    {
-        /*System clock is not divided*/
-        AHB_Pre = 1;
-    }
-    else
+    if (Index >= USART_INSTANCE_NUM)
     {
-        /*System clock is divided*/
-        AHB_Pre = AHB_PreScaler[temp - 8];
+        return;
     }
-
-    /* Get the APB2 PreScasler */
-    temp = (RCC->CFGR >> 13) & 0x07;
-    if (temp < 4)
+    if ((USARTx == USART1) || (USARTx == USART6))
     {
-        /*AHB clock is not divided*/
-        APB2_Pre = 1;
+        USARTx_Clk = RCC_GetPCLK2Val(); 
     }
     else
     {
-        /*AHB clock is divided*/
-        APB2_Pre = APB_PreScaler[temp - 4];
+        USARTx_Clk = RCC_GetPCLK1Val(); 
     }
-    /*Set peripheral clock*/
-    P_Clk2 = (SYS_Clk / AHB_Pre) / APB2_Pre;
-
-    return P_Clk2;
+    Scaling = 8 * (2 - ((USARTx->CR1 >> USART_CR1_OVER8) & 0x01U));
+    Mantissa = (USARTx_Clk / (Scaling * BaudRate));
+    Remainder = (USARTx_Clk % (Scaling * BaudRate));
+    Fraction = ((Remainder) + (BaudRate / 2)) / BaudRate; /* Round(Fraction) */
+    USARTx->BRR = (Mantissa << USART_DIV_MANTISSA) + (Fraction << USART_DIV_FRACTION);
+    USART_BaudRate[Index] = BaudRate;
 }
 
 /**
@@ -162,13 +71,16 @@ uint32_t RCC_GetPCLK2Val(void)
  * @param USARTx Pointer to the USART port to be configured (e.g, USART1, USART2).
  * @param USART_Conf Structer that contains the configuration information of a specified USART
  * 
- * @return None
+ * @return uint8_t TRUE if the USART is initialized, FALSE if it is not handled by the driver
  */
-void USART_Init(USART_RegDef_t * USARTx, USART_Conf_t USART_Conf)
+uint8_t USART_Init(USART_RegDef_t * USARTx, USART_Conf_t USART_Conf)
 {
-    uint32_t USARTDIV;
-    uint32_t Mantissa, Fraction, Remainder, Scaling;
-    uint32_t USARTx_Clk;
+    uint8_t Index = USARTx_TO_INDEX(USARTx);
+
+    if (Index >= USART_INSTANCE_NUM)
+    {
+        return FALSE;
+    }
     /*1. Set wordlength in CR1 register*/
     USARTx->CR1 |= (USART_Conf.WordLength << USART_CR1_M);
     /*2. Set parity in CR1 register*/
@@ -182,26 +94,17 @@ void USART_Init(USART_RegDef_t * USARTx, USART_Conf_t USART_Conf)
     /*5. Set stop bit in CR2 register*/
     USARTx->CR2 &= ~(0x03U << USART_CR2_STOP);
     USARTx->CR2 |= (USART_Conf.StopBits << USART_CR2_STOP);
-    /*6. Set baurate in BRR register*/
-    if ((USARTx == USART1) || (USARTx == USART6))
+    /*6. Set baurate in BRR register, it is kept in sync with the clock changes*/
+    USART_SetBaudRate(USARTx, USART_Conf.BaudRate);
+    if (USART_ClockCallbackRegistered == FALSE)
     {
-        USARTx_Clk = RCC_GetPCLK2Val(); 
-    }
-    else
-    {
-        USARTx_Clk = RCC_GetPCLK1Val(); 
+        USART_ClockCallbackRegistered = RCC_RegisterClockChangeCallback(USART_ClockChangeCallback);
     }
-    Scaling = 8 * (2 - USART_Conf.OverSampling);
-    USARTDIV = (USARTx_Clk / (Scaling * USART_Conf.BaudRate));
-    Mantissa = USARTDIV;
-    Remainder = (USARTx_Clk % (Scaling * USART_Conf.BaudRate));
-    Fraction = ((Remainder) + (USART_Conf.BaudRate / 2)) / USART_Conf.BaudRate; /* Round(Fraction) */
-    USARTx->BRR &= ~(0xFFF0 << USART_DIV_MANTISSA);
-    USARTx->BRR &= ~(0x000F << USART_DIV_FRACTION);
-    USARTx->BRR |= (Mantissa << USART_DIV_MANTISSA);
-    USARTx->BRR |= (Fraction << USART_DIV_FRACTION);
-    /*7. Enable the USART peripheral in CR1 register*/
+    /*7. Reset the interrupt driven transmit ring buffer*/
+    RingBuf_Init(&USART_TxState[Index].Ring, USART_TxState[Index].Buffer, USART_TX_BUFFER_SIZE);
+    /*8. Enable the USART peripheral in CR1 register*/
     USARTx->CR1 |= (BIT_SET << USART_CR1_UE);
+    return TRUE;
 }
 
 /**
@@ -335,3 +238,305 @@ void USART_Receive(USART_RegDef_t * USARTx, uint8_t * Mess, uint8_t MessSize)
         }
     }
 }
+
+
+/**
+ * @brief This function enables the USARTx interrupt request in the NVIC.
+ *        The individual interrupt sources are enabled by the driver functions that use them.
+ * 
+ * @param USARTx Pointer to the USART port to be configured (e.g, USART1, USART2).
+ * @param Priority Interrupt priority to be set
+ */
+void USART_IT_Init(USART_RegDef_t * USARTx, uint8_t Priority)
+{
+    if (USARTx_TO_INDEX(USARTx) >= USART_INSTANCE_NUM)
+    {
+        return;
+    }
+    USART_TxState[USARTx_TO_INDEX(USARTx)].IRQPriority = Priority;
+    /* Set the interrupt priority for USARTx */
+    NVIC_SetPriority(USARTx_TO_IRQ(USARTx), Priority);
+    /* Enable the IRQ of USARTx */
+    NVIC_EnableIRQ(USARTx_TO_IRQ(USARTx));
+}
+
+/**
+ * @brief This function queues data to be transmitted by the USARTx interrupt and returns immediately.
+ * 
+ * @note The bytes are copied into the transmit ring buffer, so the message buffer can be reused
+ *       as soon as the function returns. Only 8 bit data frames are handled.
+ *       The USARTx interrupt and the lower priority interrupts are masked (BASEPRI) while the message is queued,
+ *       so the function can be called from the main loop and from interrupts whose priority is not higher
+ *       than the USARTx one. A message is never interleaved with another one.
+ * 
+ * @param USARTx Pointer to the USART port to be used (e.g, USART1, USART2).
+ * @param Mess Pointer to the message that is going to be sent
+ * @param MessSize The size of the transmitted message
+ * 
+ * @return uint16_t The number of bytes queued, less than MessSize if the ring buffer is full
+ */
+uint16_t USART_Transmit_IT(USART_RegDef_t * USARTx, const uint8_t * Mess, uint16_t MessSize)
+{
+    USART_TxState_t * pTxState = &USART_TxState[USARTx_TO_INDEX(USARTx)];
+    uint32_t State;
+    uint16_t Count;
+
+    /*The other producers and the USARTx interrupt (CR1 read-modify-write) must not run meanwhile*/
+    State = CM4_CriticalEnter(pTxState->IRQPriority);
+    /*Queue as much of the message as fits into the ring buffer*/
+    Count = RingBuf_Write(&pTxState->Ring, Mess, MessSize);
+
+    if (Count > 0)
+    {
+        /*Disable the transmission complete interrupt, a new transfer is in progress*/
+        USARTx->CR1 &= ~(0x01U << USART_CR1_TCIE);
+        /*Enable the transmit data register empty interrupt to start draining the ring buffer*/
+        USARTx->CR1 |= (0x01U << USART_CR1_TXEIE);
+    }
+    CM4_CriticalExit(State);
+
+    return Count;
+}
+
+/**
+ * @brief This function gets the number of bytes queued for transmission that have not been sent yet.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ * 
+ * @return uint16_t Number of pending bytes
+ */
+uint16_t USART_GetTxPending(USART_RegDef_t * USARTx)
+{
+    USART_TxState_t * pTxState = &USART_TxState[USARTx_TO_INDEX(USARTx)];
+
+    return RingBuf_Count(&pTxState->Ring);
+}
+
+/**
+ * @brief This function checks if the interrupt driven transmission is over: no byte is queued and
+ *        the TXE and TC interrupts are disabled, so the last stop bit has left the shift register.
+ *        The TC flag can not be used for this, it is cleared after each transmission.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ * 
+ * @return uint8_t TRUE if the transmitter is idle, FALSE otherwise
+ */
+uint8_t USART_IsTxIdle(USART_RegDef_t * USARTx)
+{
+    uint8_t Index = USARTx_TO_INDEX(USARTx);
+
+    if (Index >= USART_INSTANCE_NUM)
+    {
+        return TRUE;
+    }
+    if ((RingBuf_Count(&USART_TxState[Index].Ring) != 0U) ||
+        ((USARTx->CR1 & ((0x01U << USART_CR1_TXEIE) | (0x01U << USART_CR1_TCIE))) != 0U))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief This function registers the callback called when an interrupt driven transmission is completed.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ * @param Callback Function to be called from the USART interrupt, NULL to disable
+ */
+void USART_RegisterTxCpltCallback(USART_RegDef_t * USARTx, USART_TxCpltCallback_t Callback)
+{
+    if (USARTx_TO_INDEX(USARTx) >= USART_INSTANCE_NUM)
+    {
+        return;
+    }
+    USART_TxState[USARTx_TO_INDEX(USARTx)].TxCpltCallback = Callback;
+}
+
+/**
+ * @brief This function hands the bytes written by the DMA since the last call to the application.
+ *        It is called on the IDLE line, half transfer and transfer complete events.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ */
+static void USART_RxDMA_Process(USART_RegDef_t * USARTx)
+{
+    USART_RxDMAState_t * pRxState = &USART_RxDMAState[USARTx_TO_INDEX(USARTx)];
+    uint16_t WritePos;
+
+    if (pRxState->Buffer == NULL)
+    {
+        return;
+    }
+    /*The DMA counts NDTR down from Size, so the write position is Size - NDTR*/
+    WritePos = pRxState->Size - DMA_GetCounter(pRxState->DMAx, pRxState->Stream);
+    if (WritePos == pRxState->Size)
+    {
+        WritePos = 0U;
+    }
+    if (WritePos == pRxState->ReadPos)
+    {
+        /*Nothing new*/
+        return;
+    }
+    if (pRxState->RxEventCallback != NULL)
+    {
+        if (WritePos > pRxState->ReadPos)
+        {
+            /*New data is contiguous*/
+            pRxState->RxEventCallback(USARTx, &pRxState->Buffer[pRxState->ReadPos], WritePos - pRxState->ReadPos);
+        }
+        else
+        {
+            /*New data wraps around the end of the buffer*/
+            pRxState->RxEventCallback(USARTx, &pRxState->Buffer[pRxState->ReadPos], pRxState->Size - pRxState->ReadPos);
+            if (WritePos > 0U)
+            {
+                pRxState->RxEventCallback(USARTx, &pRxState->Buffer[0], WritePos);
+            }
+        }
+    }
+    pRxState->ReadPos = WritePos;
+}
+
+/**
+ * @brief This function is the DMA stream callback of the USART reception.
+ * 
+ * @param Flags DMA stream flags
+ * @param Context USART port served by the stream
+ */
+static void USART_RxDMA_Callback(uint8_t Flags, void * Context)
+{
+    if (Flags & (DMA_FLAG_HT | DMA_FLAG_TC))
+    {
+        USART_RxDMA_Process((USART_RegDef_t *)Context);
+    }
+}
+
+/**
+ * @brief This function starts the reception of USARTx into a circular buffer filled by the DMA.
+ *        The application receives the new bytes through the callback on the IDLE line event
+ *        (end of a message) and when the DMA reaches the half and the end of the buffer.
+ * 
+ * @note USART_IT_Init must be called for USARTx with the same priority, so that the USART and the
+ *       DMA stream interrupts never preempt each other. The RXNE interrupt must not be used.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ * @param DMAx DMA controller serving the USART RX request (see the DMA request mapping table)
+ * @param Stream DMA stream serving the USART RX request
+ * @param Channel DMA channel of the USART RX request
+ * @param Buffer Circular buffer
+ * @param Size Size of the circular buffer
+ * @param Callback Function called from interrupt context with each new span of bytes
+ * @param Priority Interrupt priority of the DMA stream
+ */
+void USART_RxDMA_Start(USART_RegDef_t * USARTx, DMA_RegDef_t * DMAx, uint8_t Stream, uint8_t Channel,
+                       uint8_t * Buffer, uint16_t Size, USART_RxEventCallback_t Callback, uint8_t Priority)
+{
+    USART_RxDMAState_t * pRxState;
+    DMA_Conf_t RxDMA_Conf;
+
+    if (USARTx_TO_INDEX(USARTx) >= USART_INSTANCE_NUM)
+    {
+        return;
+    }
+    pRxState = &USART_RxDMAState[USARTx_TO_INDEX(USARTx)];
+    pRxState->DMAx            = DMAx;
+    pRxState->Stream          = Stream;
+    pRxState->Buffer          = Buffer;
+    pRxState->Size            = Size;
+    pRxState->ReadPos         = 0U;
+    pRxState->RxEventCallback = Callback;
+
+    /*1. Configure the DMA stream in circular peripheral to memory mode*/
+    RxDMA_Conf.Channel        = Channel;
+    RxDMA_Conf.Direction      = DMA_DIR_P2M;
+    RxDMA_Conf.PeriphInc      = DMA_INC_DISABLE;
+    RxDMA_Conf.MemInc         = DMA_INC_ENABLE;
+    RxDMA_Conf.PeriphDataSize = DMA_SIZE_BYTE;
+    RxDMA_Conf.MemDataSize    = DMA_SIZE_BYTE;
+    RxDMA_Conf.Mode           = DMA_MODE_CIRCULAR;
+    RxDMA_Conf.Priority       = DMA_PRIORITY_HIGH;
+    DMA_Init(DMAx, Stream, RxDMA_Conf);
+    DMA_RegisterCallback(DMAx, Stream, USART_RxDMA_Callback, (void *)USARTx);
+    DMA_IT_Init(DMAx, Stream, DMA_FLAG_HT | DMA_FLAG_TC, Priority);
+    DMA_Start(DMAx, Stream, (uint32_t)&USARTx->DR, (uint32_t)Buffer, Size);
+
+    /*2. Let the USART request the DMA on RXNE and interrupt on the IDLE line*/
+    USARTx->CR1 &= ~(0x01U << USART_CR1_RXNEIE);
+    USARTx->CR3 |= (0x01U << USART_CR3_DMAR);
+    USARTx->CR1 |= (0x01U << USART_CR1_IDLEIE);
+}
+
+/**
+ * @brief This function stops the DMA reception of USARTx.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ */
+void USART_RxDMA_Stop(USART_RegDef_t * USARTx)
+{
+    USART_RxDMAState_t * pRxState = &USART_RxDMAState[USARTx_TO_INDEX(USARTx)];
+
+    if (pRxState->Buffer == NULL)
+    {
+        return;
+    }
+    USARTx->CR1 &= ~(0x01U << USART_CR1_IDLEIE);
+    USARTx->CR3 &= ~(0x01U << USART_CR3_DMAR);
+    DMA_Stop(pRxState->DMAx, pRxState->Stream);
+    DMA_RegisterCallback(pRxState->DMAx, pRxState->Stream, NULL, NULL);
+    pRxState->Buffer = NULL;
+}
+
+/**
+ * @brief This function handles the transmit and the DMA reception interrupts of USARTx.
+ *        It must be called from the USARTx_IRQHandler.
+ * 
+ * @param USARTx Pointer to the USART port (e.g, USART1, USART2).
+ */
+void USART_IRQHandling(USART_RegDef_t * USARTx)
+{
+    USART_TxState_t * pTxState = &USART_TxState[USARTx_TO_INDEX(USARTx)];
+    uint8_t Data;
+    volatile uint32_t temp;
+
+    /*IDLE line detected, the sender paused after a message*/
+    if ((((USARTx->CR1 >> USART_CR1_IDLEIE) & 0x01U) == BIT_SET)\
+    && (((USARTx->SR >> USART_SR_IDLE) & 0x01U) == BIT_SET))
+    {
+        /*The IDLE flag is cleared by reading SR followed by DR*/
+        temp = USARTx->DR;
+        (void)temp;
+        USART_RxDMA_Process(USARTx);
+    }
+
+    /*Transmit data register empty*/
+    if ((((USARTx->CR1 >> USART_CR1_TXEIE) & 0x01U) == BIT_SET)\
+    && (((USARTx->SR >> USART_SR_TXE) & 0x01U) == BIT_SET))
+    {
+        if (RingBuf_Get(&pTxState->Ring, &Data) == TRUE)
+        {
+            /*Send the next byte*/
+            USARTx->DR = Data;
+        }
+        else
+        {
+            /*Ring buffer is empty, wait for the last byte to leave the shift register*/
+            USARTx->CR1 &= ~(0x01U << USART_CR1_TXEIE);
+            USARTx->CR1 |= (0x01U << USART_CR1_TCIE);
+        }
+    }
+
+    /*Transmission complete*/
+    if ((((USARTx->CR1 >> USART_CR1_TCIE) & 0x01U) == BIT_SET)\
+    && (((USARTx->SR >> USART_SR_TC) & 0x01U) == BIT_SET))
+    {
+        /*Clear the TC flag by writing 0, the other flags are not affected by writing 1*/
+        USARTx->SR = ~(0x01U << USART_SR_TC);
+        USARTx->CR1 &= ~(0x01U << USART_CR1_TCIE);
+        if (pTxState->TxCpltCallback != NULL)
+        {
+            pTxState->TxCpltCallback(USARTx);
+        }
+    }
+}
@@ -0,0 +1,230 @@
+#include "systick.h"
+
+/*  64 bit tick count. The interrupt changes both words with the interrupts masked when the low word wraps around,
+    the readers check the high word did not change. */
+static volatile uint32_t SysTick_TickLow = 0U;
+static volatile uint32_t SysTick_TickHigh = 0U;
+static uint32_t SysTick_Rate = 0U;
+static uint8_t SysTick_CallbackRegistered = FALSE;
+static SysTick_Hook_t SysTick_Hook[SYSTICK_HOOK_MAX];
+static volatile uint8_t SysTick_HookNum = 0U;
+
+/**
+ * @brief This function programs the reload value and the clock source for the current rate.
+ *
+ * @param HCLK AHB clock frequency in Hz
+ *
+ * @return uint8_t TRUE on success, FALSE if the rate can not be reached from this clock
+ */
+static uint8_t SysTick_SetReload(uint32_t HCLK)
+{
+    uint32_t Reload;
+    uint32_t ClkSource = (0x01UL << SYSTICK_CTRL_CLKSOURCE);
+
+    Reload = HCLK / SysTick_Rate;
+    if (Reload > (SYSTICK_LOAD_MAX + 1U))
+    {
+        /*Too slow for the processor clock, use HCLK / 8*/
+        Reload /= 8U;
+        ClkSource = 0U;
+    }
+    if ((Reload == 0U) || (Reload > (SYSTICK_LOAD_MAX + 1U)))
+    {
+        return FALSE;
+    }
+    SYSTICK->CTRL &= ~(0x01UL << SYSTICK_CTRL_ENABLE);
+    SYSTICK->LOAD = Reload - 1U;
+    SYSTICK->VAL = 0U;
+    SYSTICK->CTRL = ClkSource | (0x01UL << SYSTICK_CTRL_TICKINT) | (0x01UL << SYSTICK_CTRL_ENABLE);
+    return TRUE;
+}
+
+/**
+ * @brief This function keeps the tick rate after a clock change.
+ *
+ * @param pClocks New clock frequencies
+ */
+static void SysTick_ClockChangeCallback(const RCC_ClockState_t * pClocks)
+{
+    if (SysTick_Rate != 0U)
+    {
+        SysTick_SetReload(pClocks->HCLK);
+    }
+}
+
+/**
+ * @brief This function starts (or restarts at a new rate) the SysTick tick, the tick count keeps running.
+ *        It must be called after the clock tree configuration.
+ *
+ * @param RateHz Tick frequency in Hz
+ * @param Priority Priority of the SysTick exception
+ *
+ * @return uint8_t TRUE on success, FALSE if the rate can not be reached from the current HCLK
+ */
+uint8_t SysTick_Init(uint32_t RateHz, uint8_t Priority)
+{
+    if (RateHz == 0U)
+    {
+        return FALSE;
+    }
+    SysTick_Rate = RateHz;
+    if (SysTick_SetReload(RCC_GetHCLKVal()) == FALSE)
+    {
+        SysTick_Stop();
+        return FALSE;
+    }
+    SCB->SHPR[2] &= ~(0xFFU << SCB_SHPR3_PRI_SYSTICK);
+    SCB->SHPR[2] |= (((uint32_t)Priority << (8U - NVIC_PRIO_BITS)) << SCB_SHPR3_PRI_SYSTICK);
+    if (SysTick_CallbackRegistered == FALSE)
+    {
+        SysTick_CallbackRegistered = RCC_RegisterClockChangeCallback(SysTick_ClockChangeCallback);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief This function stops the SysTick tick, the tick count is kept.
+ *
+ */
+void SysTick_Stop(void)
+{
+    SYSTICK->CTRL = 0U;
+    SysTick_Rate = 0U;
+    SCB->ICSR = (0x01U << SCB_ICSR_PENDSTCLR);
+}
+
+/**
+ * @brief This function gets the tick frequency.
+ *
+ * @return uint32_t Tick frequency in Hz, 0 if the tick is stopped
+ */
+uint32_t SysTick_GetRate(void)
+{
+    return SysTick_Rate;
+}
+
+/**
+ * @brief This function gets the number of ticks since the first SysTick_Init. It can be called from any context.
+ *
+ * @return uint64_t
+ */
+uint64_t SysTick_GetTick64(void)
+{
+    uint32_t High, Low;
+
+    /*A tick between the two reads of the high word can only change it when the low word wraps around*/
+    do
+    {
+        High = SysTick_TickHigh;
+        Low = SysTick_TickLow;
+    } while (High != SysTick_TickHigh);
+    return ((uint64_t)High << 32U) | Low;
+}
+
+/**
+ * @brief This function gets the low 32 bits of the tick count, for the elapsed time with unsigned subtraction.
+ *
+ * @return uint32_t
+ */
+uint32_t SysTick_GetTick(void)
+{
+    return SysTick_TickLow;
+}
+
+/**
+ * @brief This function gets the tick count in milliseconds, exact when the rate divides or is a multiple of 1 kHz.
+ *
+ * @return uint64_t
+ */
+uint64_t SysTick_GetMs(void)
+{
+    uint32_t Rate = SysTick_Rate;
+
+    if (Rate == 0U)
+    {
+        return 0U;
+    }
+    return (SysTick_GetTick64() * 1000U) / Rate;
+}
+
+/**
+ * @brief This function adds a function called on each tick.
+ *
+ * @param Hook Function called from the SysTick interrupt
+ *
+ * @return uint8_t TRUE on success, FALSE if the hook table is full
+ */
+uint8_t SysTick_RegisterHook(SysTick_Hook_t Hook)
+{
+    uint32_t primask;
+    uint8_t Status = FALSE;
+
+    primask = CM4_IRQSave();
+    if ((Hook != NULL) && (SysTick_HookNum < SYSTICK_HOOK_MAX))
+    {
+        SysTick_Hook[SysTick_HookNum] = Hook;
+        SysTick_HookNum++;
+        Status = TRUE;
+    }
+    CM4_IRQRestore(primask);
+    return Status;
+}
+
+/**
+ * @brief This function removes a tick hook, the order of the other hooks is kept.
+ *
+ * @param Hook Function given to SysTick_RegisterHook
+ *
+ * @return uint8_t TRUE on success, FALSE if the hook is not registered
+ */
+uint8_t SysTick_UnregisterHook(SysTick_Hook_t Hook)
+{
+    uint32_t primask;
+    uint8_t i;
+    uint8_t Status = FALSE;
+
+    primask = CM4_IRQSave();
+    for (i = 0U; i < SysTick_HookNum; i++)
+    {
+        if (SysTick_Hook[i] == Hook)
+        {
+            for (; i < (SysTick_HookNum - 1U); i++)
+            {
+                SysTick_Hook[i] = SysTick_Hook[i + 1U];
+            }
+            SysTick_HookNum--;
+            Status = TRUE;
+            break;
+        }
+    }
+    CM4_IRQRestore(primask);
+    return Status;
+}
+
+/**
+ * @brief This function handles the SysTick exception, it is called from the SysTick_Handler.
+ *
+ */
+void SysTick_IRQHandling(void)
+{
+    uint8_t i;
+    uint32_t primask;
+    uint32_t Low = SysTick_TickLow + 1U;
+
+    if (Low == 0U)
+    {
+        /*A higher priority reader must not see the wrapped low word with the old high word*/
+        primask = CM4_IRQSave();
+        SysTick_TickHigh++;
+        SysTick_TickLow = 0U;
+        CM4_IRQRestore(primask);
+    }
+    else
+    {
+        SysTick_TickLow = Low;
+    }
+    for (i = 0U; i < SysTick_HookNum; i++)
+    {
+        SysTick_Hook[i]();
+    }
+}
@@ -0,0 +1,186 @@
+#include "timebase.h"
+
+/**
+ * @brief This function applies the new TIM2 prescaler at once after a clock change.
+ *        The timer driver already wrote the preloaded PSC, the update event loads it and clears the counter,
+ *        the counter value is restored right after (a few timer clocks are lost).
+ *
+ * @param pClocks New clock frequencies
+ */
+static void Timebase_ClockChangeCallback(const RCC_ClockState_t * pClocks)
+{
+    uint32_t Count;
+
+    (void)pClocks;
+    Count = TIMEBASE_TIM->CNT;
+    TIM_Base_ForceUpdate(TIMEBASE_TIM);
+    TIMEBASE_TIM->CNT = Count;
+}
+
+/**
+ * @brief This function starts the microsecond time base (TIM2) and the cycle counter (DWT_CYCCNT).
+ *        It must be called after the clock tree configuration.
+ *
+ * @param Priority Priority of the TIM2 interrupt used to wake the delays up
+ */
+void Timebase_Init(uint8_t Priority)
+{
+    TIM_Base_Conf_t Timebase_Conf;
+
+    Timebase_Conf.Period            = 0xFFFFFFFFU;
+    Timebase_Conf.Prescaler         = 0U;
+    Timebase_Conf.CounterClock      = TIMEBASE_COUNTER_CLOCK;
+    Timebase_Conf.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    Timebase_Conf.CounterMode       = TIM_UPCOUNTING;
+    Timebase_Conf.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    TIM2_CLK_ENB();
+    TIM_Base_Init(TIMEBASE_TIM, Timebase_Conf);
+    TIM_Base_ForceUpdate(TIMEBASE_TIM);
+    /*Registered after the timer driver callback, so the new PSC is already written when it runs*/
+    RCC_RegisterClockChangeCallback(Timebase_ClockChangeCallback);
+
+    /*The channel 1 compare interrupt is only enabled during the sleeping delays*/
+    NVIC_SetPriority(TIMx_TO_IRQ(TIMEBASE_TIM), Priority);
+    NVIC_EnableIRQ(TIMx_TO_IRQ(TIMEBASE_TIM));
+    TIM_Base_Start(TIMEBASE_TIM);
+
+    DWT_CycleCounterInit();
+}
+
+/**
+ * @brief This function gets the time since Timebase_Init in microseconds.
+ *
+ * @return uint32_t
+ */
+uint32_t Timebase_NowUs(void)
+{
+    return TIMEBASE_TIM->CNT;
+}
+
+/**
+ * @brief This function gets the number of core clock cycles since Timebase_Init.
+ *
+ * @return uint32_t
+ */
+uint32_t Timebase_NowCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief This function gets the time elapsed since a Timebase_NowUs value.
+ *
+ * @param StartUs Value of Timebase_NowUs at the start
+ *
+ * @return uint32_t Elapsed time in microseconds
+ */
+uint32_t Timebase_ElapsedUs(uint32_t StartUs)
+{
+    return TIMEBASE_TIM->CNT - StartUs;
+}
+
+/**
+ * @brief This function gets the number of core clock cycles elapsed since a Timebase_NowCycles value.
+ *
+ * @param StartCycles Value of Timebase_NowCycles at the start
+ *
+ * @return uint32_t Elapsed cycles
+ */
+uint32_t Timebase_ElapsedCycles(uint32_t StartCycles)
+{
+    return DWT->CYCCNT - StartCycles;
+}
+
+/**
+ * @brief This function checks a timeout without blocking.
+ *
+ * @param StartUs Value of Timebase_NowUs at the start
+ * @param TimeoutUs Timeout in microseconds
+ *
+ * @return uint8_t TRUE if the timeout has elapsed, FALSE otherwise
+ */
+uint8_t Timebase_IsExpired(uint32_t StartUs, uint32_t TimeoutUs)
+{
+    return (Timebase_ElapsedUs(StartUs) >= TimeoutUs) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function converts a number of core clock cycles into microseconds at the current HCLK.
+ *
+ * @param Cycles Number of cycles
+ *
+ * @return uint32_t
+ */
+uint32_t Timebase_CyclesToUs(uint32_t Cycles)
+{
+    return Cycles / (RCC_GetHCLKVal() / 1000000U);
+}
+
+/**
+ * @brief This function waits for the given time.
+ *        From the thread mode the core sleeps (WFI) until the TIM2 compare, other interrupts are served meanwhile.
+ *        From an interrupt handler or for short delays it busy waits on TIM2.
+ *
+ * @param Us Delay in microseconds
+ */
+void Timebase_DelayUs(uint32_t Us)
+{
+    uint32_t Start;
+
+    Start = Timebase_NowUs();
+    if ((Us < TIMEBASE_SLEEP_MIN_US) || CM4_InHandlerMode())
+    {
+        while (Timebase_ElapsedUs(Start) < Us)
+        {
+            /*Busy wait*/
+        }
+        return;
+    }
+
+    /*Wake up at the deadline*/
+    TIMEBASE_TIM->CCR[0] = Start + Us;
+    TIMEBASE_TIM->SR = ~(0x01U << TIM_SR_CC1IF);
+    TIMEBASE_TIM->DIER |= (0x01U << TIM_DIER_CC1IE);
+    while (1)
+    {
+        /*With PRIMASK set, an interrupt arriving after the check still ends the WFI*/
+        CM4_DISABLE_IRQ();
+        if (Timebase_ElapsedUs(Start) >= Us)
+        {
+            CM4_ENABLE_IRQ();
+            break;
+        }
+        CM4_WFI();
+        CM4_ENABLE_IRQ();
+    }
+    TIMEBASE_TIM->DIER &= ~(0x01U << TIM_DIER_CC1IE);
+}
+
+/**
+ * @brief This function waits for the given time, see Timebase_DelayUs.
+ *
+ * @param Ms Delay in milliseconds
+ */
+void Timebase_DelayMs(uint32_t Ms)
+{
+    /*Wait by steps of 1 s so that the microsecond count does not overflow*/
+    while (Ms > 1000U)
+    {
+        Timebase_DelayUs(1000000U);
+        Ms -= 1000U;
+    }
+    Timebase_DelayUs(Ms * 1000U);
+}
+
+/**
+ * @brief This function handles the TIM2 interrupt, it is called from the TIM2_IRQHandler.
+ *
+ */
+void Timebase_IRQHandling(void)
+{
+    if (((TIMEBASE_TIM->SR >> TIM_SR_CC1IF) & 0x01U) == BIT_SET)
+    {
+        /*The interrupt only ends the WFI of Timebase_DelayUs*/
+        TIMEBASE_TIM->SR = ~(0x01U << TIM_SR_CC1IF);
+    }
+}
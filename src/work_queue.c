@@ -0,0 +1,95 @@
+#include "work_queue.h"
+
+static volatile uint32_t WorkQueue_Sequence[WORKQUEUE_SIZE];
+static WorkQueue_Item_t WorkQueue_Item[WORKQUEUE_SIZE];
+static MpscQueue_t WorkQueue_Queue;
+static WorkQueue_Stats_t WorkQueue_Stats;
+
+/**
+ * @brief This function initializes the queue and sets the PendSV priority to the lowest one.
+ *
+ */
+void WorkQueue_Init(void)
+{
+    MpscQueue_Init(&WorkQueue_Queue, WorkQueue_Sequence, WORKQUEUE_SIZE);
+    SCB->SHPR[2] &= ~(0xFFU << SCB_SHPR3_PRI_PENDSV);
+    SCB->SHPR[2] |= ((WORKQUEUE_PRIORITY << (8U - NVIC_PRIO_BITS)) << SCB_SHPR3_PRI_PENDSV);
+}
+
+/**
+ * @brief This function posts a work item and pends PendSV, it can be called from any context.
+ *
+ * @param Handler Function to be called from PendSV
+ * @param Context Given to the handler
+ *
+ * @return uint8_t TRUE if the item was queued, FALSE if the queue is full
+ */
+uint8_t WorkQueue_Post(WorkQueue_Handler_t Handler, void * Context)
+{
+    WorkQueue_Item_t * pItem;
+    uint32_t Pos;
+
+    if (MpscQueue_Reserve(&WorkQueue_Queue, &Pos) == FALSE)
+    {
+        return FALSE;
+    }
+    pItem = &WorkQueue_Item[MPSC_QUEUE_INDEX(&WorkQueue_Queue, Pos)];
+    pItem->Handler   = Handler;
+    pItem->Context   = Context;
+    pItem->PostStamp = Timebase_NowCycles();
+    MpscQueue_Publish(&WorkQueue_Queue, Pos);
+    __atomic_fetch_add(&WorkQueue_Stats.Posted, 1U, __ATOMIC_RELAXED);
+
+    /*Run the queue once no interrupt is active*/
+    SCB->ICSR = (0x01U << SCB_ICSR_PENDSVSET);
+    return TRUE;
+}
+
+/**
+ * @brief This function gets the number of items posted and not run yet.
+ *
+ * @return uint32_t
+ */
+uint32_t WorkQueue_GetDepth(void)
+{
+    return MpscQueue_GetDepth(&WorkQueue_Queue);
+}
+
+/**
+ * @brief This function gets the work queue statistics.
+ *
+ * @return const WorkQueue_Stats_t*
+ */
+const WorkQueue_Stats_t * WorkQueue_GetStats(void)
+{
+    WorkQueue_Stats.Dropped   = WorkQueue_Queue.Dropped;
+    WorkQueue_Stats.HighWater = WorkQueue_Queue.HighWater;
+    return &WorkQueue_Stats;
+}
+
+/**
+ * @brief This function runs the published work items in order, it is called from the PendSV_Handler.
+ *        It stops at the first item not published yet, its producer pends PendSV again when it publishes it.
+ *
+ */
+void WorkQueue_IRQHandling(void)
+{
+    WorkQueue_Item_t Item;
+    uint32_t Pos, Latency;
+
+    while (MpscQueue_Peek(&WorkQueue_Queue, &Pos) == TRUE)
+    {
+        Item = WorkQueue_Item[MPSC_QUEUE_INDEX(&WorkQueue_Queue, Pos)];
+        /*Free the cell before running the handler, it can post again*/
+        MpscQueue_Release(&WorkQueue_Queue, Pos);
+
+        Latency = Timebase_ElapsedCycles(Item.PostStamp);
+        WorkQueue_Stats.LastLatency = Latency;
+        if (Latency > WorkQueue_Stats.MaxLatency)
+        {
+            WorkQueue_Stats.MaxLatency = Latency;
+        }
+        Item.Handler(Item.Context);
+        WorkQueue_Stats.Executed++;
+    }
+}
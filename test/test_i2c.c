@@ -0,0 +1,268 @@
+/*  Host test of the I2C master driver on the register block mock (stm32f407xx_i2c_mock.c): transfers of every
+    length, multi-device queue, NACK, arbitration loss retry, deferred bus error recovery and the statistics.
+    The mock counts a protocol error for every register access out of the RM0090 sequences, there must be none.
+    Build and run from the repository root:
+        gcc -std=gnu11 -Wall -Wno-pointer-to-int-cast -Iheader -DI2C_HOST_MOCK test/test_i2c.c src/stm32f407xx_i2c_driver.c \
+            src/stm32f407xx_i2c_mock.c -o test_i2c && ./test_i2c */
+#include <stdio.h>
+#include <string.h>
+#include "stm32f407xx_i2c_driver.h"
+
+#define TEST_DISPLAY_ADDRESS        0x3CU
+#define TEST_SENSOR_ADDRESS         0x1DU
+#define TEST_ABSENT_ADDRESS         0x50U
+#define TEST_READ_MAX               10U
+/*Register content of the sensor*/
+#define TEST_SENSOR_REG(Reg)        ((uint8_t)((Reg) ^ 0x5AU))
+
+static I2C_MockDevice_t Test_Display = {.Address = TEST_DISPLAY_ADDRESS};
+static I2C_MockDevice_t Test_Sensor = {.Address = TEST_SENSOR_ADDRESS};
+static GPIO_RegDef_t Test_Port;
+/*Register block that is not one of the driver I2Cs*/
+static I2C_RegDef_t Test_Unknown;
+static uint32_t Test_Failures = 0U;
+/*Transfers in completion order*/
+static I2C_Transfer_t * Test_DoneOrder[8];
+static uint8_t Test_DoneNum = 0U;
+static I2C_Transfer_t Test_Chained;
+
+#define TEST_CHECK(Cond) \
+        do { if (!(Cond)) { printf("FAIL line %d: %s\n", __LINE__, #Cond); Test_Failures++; } } while (0)
+
+/**
+ * @brief This function records the completion order of the transfers, a transfer with a Context submits
+ *        Test_Chained from the interrupt.
+ *
+ * @param pXfer Completed transfer
+ */
+static void Test_Done(I2C_Transfer_t * pXfer)
+{
+    if (Test_DoneNum < 8U)
+    {
+        Test_DoneOrder[Test_DoneNum++] = pXfer;
+    }
+    if (pXfer->Context != NULL)
+    {
+        TEST_CHECK(I2C_Submit(I2C1, &Test_Chained) == TRUE);
+    }
+}
+
+/**
+ * @brief This function prepares a register write transfer.
+ */
+static void Test_SetWrite(I2C_Transfer_t * pXfer, uint8_t Address, uint8_t Reg, const uint8_t * pData, uint16_t Length)
+{
+    memset(pXfer, 0, sizeof(I2C_Transfer_t));
+    pXfer->Address = Address;
+    pXfer->Header[0] = Reg;
+    pXfer->HeaderLength = 1U;
+    pXfer->pTxData = pData;
+    pXfer->TxLength = Length;
+    pXfer->Done = Test_Done;
+}
+
+/**
+ * @brief This function prepares a register read transfer (write of the register, repeated start, read).
+ */
+static void Test_SetRead(I2C_Transfer_t * pXfer, uint8_t Address, uint8_t Reg, uint8_t * pData, uint16_t Length)
+{
+    memset(pXfer, 0, sizeof(I2C_Transfer_t));
+    pXfer->Address = Address;
+    pXfer->Header[0] = Reg;
+    pXfer->HeaderLength = 1U;
+    pXfer->pRxData = pData;
+    pXfer->RxLength = Length;
+    pXfer->Done = Test_Done;
+}
+
+/**
+ * @brief This function submits a transfer and runs the bus until it ends.
+ *
+ * @return uint8_t Transfer status
+ */
+static uint8_t Test_Run(I2C_Transfer_t * pXfer)
+{
+    TEST_CHECK(I2C_Submit(I2C1, pXfer) == TRUE);
+    I2C_MockRun(I2C1);
+    TEST_CHECK(I2C_IsIdle(I2C1) == TRUE);
+    return pXfer->Status;
+}
+
+/*Speed settings: 400 kHz duty 2 from the 42 MHz PCLK1, Fm+ and an unknown I2C are refused*/
+static void Test_Init(void)
+{
+    I2C_Conf_t Conf = {0};
+    I2C_Transfer_t Xfer = {0};
+
+    Conf.ClockSpeed = I2C_SPEED_FAST;
+    Conf.DutyCycle  = I2C_DUTY_2;
+    Conf.pSclPort   = &Test_Port;
+    Conf.SclPin     = 6U;
+    Conf.pSdaPort   = &Test_Port;
+    Conf.SdaPin     = 7U;
+    TEST_CHECK(I2C_Init(I2C1, Conf) == TRUE);
+    TEST_CHECK(I2C1->CCR == ((0x01U << I2C_CCR_FS) | 35U));
+    TEST_CHECK(I2C1->TRISE == 13U);
+    TEST_CHECK((I2C1->CR2 & 0x3FU) == 42U);
+    Conf.ClockSpeed = 1000000U;
+    TEST_CHECK(I2C_Init(I2C2, Conf) == FALSE);
+    Conf.ClockSpeed = I2C_SPEED_FAST;
+    TEST_CHECK(I2C_Init(&Test_Unknown, Conf) == FALSE);
+    TEST_CHECK(I2C_Submit(&Test_Unknown, &Xfer) == FALSE);
+    I2C_MockAttach(I2C1, &Test_Display);
+    I2C_MockAttach(I2C1, &Test_Sensor);
+}
+
+/*Writes, reads of 1 to TEST_READ_MAX bytes (the 1, 2 and N byte sequences differ), read without header, probes*/
+static void Test_Transfers(void)
+{
+    const I2C_Stats_t * pStats = I2C_GetStats(I2C1);
+    uint32_t Transfers = pStats->Transfers, BytesTx = pStats->BytesTx, BytesRx = pStats->BytesRx;
+    I2C_Transfer_t Xfer;
+    uint8_t Data[20], Rx[TEST_READ_MAX];
+    uint16_t i, Length;
+
+    for (i = 0U; i < 256U; i++)
+    {
+        Test_Sensor.Regs[i] = TEST_SENSOR_REG(i);
+    }
+    for (i = 0U; i < sizeof(Data); i++)
+    {
+        Data[i] = (uint8_t)(i + 1U);
+    }
+    Test_SetWrite(&Xfer, TEST_DISPLAY_ADDRESS, 0x10U, Data, sizeof(Data));
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_OK);
+    TEST_CHECK(memcmp(&Test_Display.Regs[0x10], Data, sizeof(Data)) == 0);
+    TEST_CHECK(Test_Display.Writes == (1U + sizeof(Data)));
+
+    for (Length = 1U; Length <= TEST_READ_MAX; Length++)
+    {
+        memset(Rx, 0, sizeof(Rx));
+        Test_SetRead(&Xfer, TEST_SENSOR_ADDRESS, 0x20U, Rx, Length);
+        TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_OK);
+        for (i = 0U; i < Length; i++)
+        {
+            TEST_CHECK(Rx[i] == TEST_SENSOR_REG(0x20U + i));
+        }
+    }
+
+    /*Read from the current register pointer*/
+    Test_SetRead(&Xfer, TEST_SENSOR_ADDRESS, 0U, Rx, 4U);
+    Xfer.HeaderLength = 0U;
+    Test_Sensor.Pointer = 0x30U;
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_OK);
+    TEST_CHECK((Rx[0] == TEST_SENSOR_REG(0x30U)) && (Rx[3] == TEST_SENSOR_REG(0x33U)));
+
+    /*Probe of a present device*/
+    memset(&Xfer, 0, sizeof(Xfer));
+    Xfer.Address = TEST_DISPLAY_ADDRESS;
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_OK);
+
+    TEST_CHECK(pStats->Transfers == (Transfers + 1U + TEST_READ_MAX + 2U));
+    TEST_CHECK(pStats->BytesTx == (BytesTx + 1U + sizeof(Data) + TEST_READ_MAX));
+    TEST_CHECK(pStats->BytesRx == (BytesRx + ((TEST_READ_MAX * (TEST_READ_MAX + 1U)) / 2U) + 4U));
+    TEST_CHECK(pStats->Nacks == 0U);
+    TEST_CHECK(I2C_MockGetProtocolErrors(I2C1) == 0U);
+}
+
+/*Queue: transfers to both devices run in submission order, a transfer submitted from Done runs last*/
+static void Test_Queue(void)
+{
+    const I2C_Stats_t * pStats = I2C_GetStats(I2C1);
+    static const uint8_t Data[8] = {1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+    I2C_Transfer_t Read1, Read2, Write;
+    uint8_t Rx1[3], Rx2[2];
+
+    Test_SetRead(&Read1, TEST_SENSOR_ADDRESS, 0x01U, Rx1, sizeof(Rx1));
+    Read1.Context = &Test_Chained;
+    Test_SetRead(&Read2, TEST_SENSOR_ADDRESS, 0x05U, Rx2, sizeof(Rx2));
+    Test_SetWrite(&Write, TEST_DISPLAY_ADDRESS, 0x40U, Data, 5U);
+    Test_SetWrite(&Test_Chained, TEST_DISPLAY_ADDRESS, 0x80U, &Data[5], 3U);
+    Test_DoneNum = 0U;
+
+    TEST_CHECK(I2C_Submit(I2C1, &Read1) == TRUE);
+    TEST_CHECK(I2C_Submit(I2C1, &Read2) == TRUE);
+    TEST_CHECK(I2C_Submit(I2C1, &Write) == TRUE);
+    /*Already queued*/
+    TEST_CHECK(I2C_Submit(I2C1, &Write) == FALSE);
+    TEST_CHECK(I2C_IsIdle(I2C1) == FALSE);
+    TEST_CHECK((Read2.Status == I2C_STATUS_PENDING) && (Write.Status == I2C_STATUS_PENDING));
+    I2C_MockRun(I2C1);
+
+    TEST_CHECK(I2C_IsIdle(I2C1) == TRUE);
+    TEST_CHECK(Test_DoneNum == 4U);
+    TEST_CHECK((Test_DoneOrder[0] == &Read1) && (Test_DoneOrder[1] == &Read2));
+    TEST_CHECK((Test_DoneOrder[2] == &Write) && (Test_DoneOrder[3] == &Test_Chained));
+    TEST_CHECK((Read1.Status == I2C_STATUS_OK) && (Read2.Status == I2C_STATUS_OK));
+    TEST_CHECK((Write.Status == I2C_STATUS_OK) && (Test_Chained.Status == I2C_STATUS_OK));
+    TEST_CHECK((Rx1[0] == TEST_SENSOR_REG(0x01U)) && (Rx1[2] == TEST_SENSOR_REG(0x03U)));
+    TEST_CHECK((Rx2[0] == TEST_SENSOR_REG(0x05U)) && (Rx2[1] == TEST_SENSOR_REG(0x06U)));
+    TEST_CHECK(memcmp(&Test_Display.Regs[0x40], Data, 5U) == 0);
+    TEST_CHECK(memcmp(&Test_Display.Regs[0x80], &Data[5], 3U) == 0);
+    TEST_CHECK(pStats->HighWater == 3U);
+    TEST_CHECK(I2C_MockGetProtocolErrors(I2C1) == 0U);
+}
+
+/*Errors: address and data NACK, arbitration loss retried, bus error recovered*/
+static void Test_Errors(void)
+{
+    const I2C_Stats_t * pStats = I2C_GetStats(I2C1);
+    I2C_Stats_t Before = *pStats;
+    static const uint8_t Data[4] = {0xA0U, 0xA1U, 0xA2U, 0xA3U};
+    I2C_Transfer_t Xfer;
+
+    /*No device at the address*/
+    memset(&Xfer, 0, sizeof(Xfer));
+    Xfer.Address = TEST_ABSENT_ADDRESS;
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_NACK);
+    TEST_CHECK(pStats->Nacks == (Before.Nacks + 1U));
+
+    /*Data byte not acknowledged*/
+    Test_SetWrite(&Xfer, TEST_DISPLAY_ADDRESS, 0x60U, Data, sizeof(Data));
+    I2C_MockInjectError(I2C1, I2C_SR1_AF);
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_NACK);
+    TEST_CHECK(Xfer.Retries == 0U);
+    TEST_CHECK(pStats->Nacks == (Before.Nacks + 2U));
+
+    /*Arbitration lost once, the transfer is restarted and completes*/
+    Test_SetWrite(&Xfer, TEST_DISPLAY_ADDRESS, 0x60U, Data, sizeof(Data));
+    I2C_MockInjectError(I2C1, I2C_SR1_ARLO);
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_OK);
+    TEST_CHECK(Xfer.Retries == 1U);
+    TEST_CHECK(memcmp(&Test_Display.Regs[0x60], Data, sizeof(Data)) == 0);
+    TEST_CHECK(pStats->ArbitrationLost == (Before.ArbitrationLost + 1U));
+
+    /*Bus error: the peripheral is reset in the interrupt, the bus is freed by the deferred work,
+      a transfer submitted meanwhile waits for it*/
+    Test_SetWrite(&Xfer, TEST_DISPLAY_ADDRESS, 0x70U, Data, sizeof(Data));
+    I2C_MockInjectError(I2C1, I2C_SR1_BERR);
+    TEST_CHECK(Test_Run(&Xfer) == I2C_STATUS_BUS_ERROR);
+    TEST_CHECK(pStats->BusErrors == (Before.BusErrors + 1U));
+    TEST_CHECK(pStats->Recoveries == Before.Recoveries);
+    Test_SetWrite(&Xfer, TEST_DISPLAY_ADDRESS, 0x70U, Data, sizeof(Data));
+    TEST_CHECK(I2C_Submit(I2C1, &Xfer) == TRUE);
+    TEST_CHECK(I2C_MockRun(I2C1) == 0U);
+    TEST_CHECK(Xfer.Status == I2C_STATUS_PENDING);
+    TEST_CHECK(I2C_MockRunWork() == 1U);
+    TEST_CHECK(pStats->Recoveries == (Before.Recoveries + 1U));
+    I2C_MockRun(I2C1);
+    TEST_CHECK(Xfer.Status == I2C_STATUS_OK);
+    TEST_CHECK(I2C_IsIdle(I2C1) == TRUE);
+    TEST_CHECK(memcmp(&Test_Display.Regs[0x70], Data, sizeof(Data)) == 0);
+
+    /*Every transfer is counted once when it ends, the restarted one included*/
+    TEST_CHECK(pStats->Transfers == (Before.Transfers + 5U));
+    TEST_CHECK(pStats->ActiveTime > Before.ActiveTime);
+    TEST_CHECK(I2C_MockGetProtocolErrors(I2C1) == 0U);
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Transfers();
+    Test_Queue();
+    Test_Errors();
+
+    printf("%s\n", (Test_Failures == 0U) ? "i2c: OK" : "i2c: FAILED");
+    return (Test_Failures == 0U) ? 0 : 1;
+}
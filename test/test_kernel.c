@@ -0,0 +1,324 @@
+/*  Host test of the kernel scheduling on the simulated port (kernel_port_host.c): priority preemption, round robin
+    within a priority, semaphore timeout, message queue order and blocking, CPU usage counters.
+    The ticks only pass in the idle task and when a busy task calls Kernel_PortSimTick, so the checks are exact.
+    Build and run from the repository root:
+        gcc -std=gnu11 -Wall -Iheader -DKERNEL_PORT_HOST test/test_kernel.c src/kernel.c src/kernel_port_host.c \
+            -o test_kernel && ./test_kernel */
+#include <stdio.h>
+#include "kernel.h"
+#include "kernel_port.h"
+
+#define TEST_STACK_SIZE             KERNEL_STACK_MIN
+#define TEST_TASK_NUM               9U
+#define TEST_TRACE_SIZE             64U
+
+static Kernel_Task_t Test_Tasks[TEST_TASK_NUM];
+static uint32_t Test_Stacks[TEST_TASK_NUM][TEST_STACK_SIZE] __attribute__((aligned(8)));
+static uint32_t Test_Failures = 0U;
+/*Set by the test code to end the busy tasks*/
+static volatile uint8_t Test_Stop = FALSE;
+
+#define TEST_CHECK(Cond) \
+        do { if (!(Cond)) { printf("FAIL line %d: %s\n", __LINE__, #Cond); Test_Failures++; } } while (0)
+
+/**
+ * @brief This function creates a test task.
+ *
+ * @param Index Task index in Test_Tasks
+ * @param Entry Task function
+ * @param Arg Given to the task function
+ * @param Priority Task priority
+ *
+ * @return Kernel_Task_t* Created task
+ */
+static Kernel_Task_t * Test_Create(uint8_t Index, Kernel_TaskEntry_t Entry, void * Arg, uint8_t Priority)
+{
+    TEST_CHECK(Kernel_TaskCreate(&Test_Tasks[Index], "test", Entry, Arg, Priority,
+                                 Test_Stacks[Index], TEST_STACK_SIZE) == TRUE);
+    return &Test_Tasks[Index];
+}
+
+/*1. Priority preemption: a delayed high priority task preempts a busy low priority task at its wake tick*/
+static uint32_t Test_LowTicks = 0U;
+static uint32_t Test_HighWake[5];
+static uint32_t Test_HighLowTicks[5];
+
+static void Test_LowEntry(void * Arg)
+{
+    (void)Arg;
+    while (Test_Stop == FALSE)
+    {
+        Test_LowTicks++;
+        Kernel_PortSimTick();
+    }
+}
+
+static void Test_HighEntry(void * Arg)
+{
+    uint8_t i;
+
+    (void)Arg;
+    for (i = 0U; i < 5U; i++)
+    {
+        Kernel_Delay(5U);
+        Test_HighWake[i] = Kernel_GetTick();
+        Test_HighLowTicks[i] = Test_LowTicks;
+    }
+}
+
+static void Test_Preemption(void)
+{
+    uint32_t Start = Kernel_GetTick();
+    uint8_t i;
+
+    Test_Stop = FALSE;
+    Test_Create(0U, Test_LowEntry, NULL, 4U);
+    Test_Create(1U, Test_HighEntry, NULL, 1U);
+    Kernel_PortSimRun(30U);
+    for (i = 0U; i < 5U; i++)
+    {
+        /*Woken up at the exact tick, the low priority task ran during the delays*/
+        TEST_CHECK(Test_HighWake[i] == (Start + (5U * (i + 1U))));
+        TEST_CHECK(Test_HighLowTicks[i] == (5U * (i + 1U)));
+    }
+    TEST_CHECK(Test_Tasks[1].State == KERNEL_TASK_DORMANT);
+    Test_Stop = TRUE;
+    Kernel_PortSimRun(2U);
+    TEST_CHECK(Test_Tasks[0].State == KERNEL_TASK_DORMANT);
+}
+
+/*2. Round robin: two busy tasks of the same priority share the CPU by time slices*/
+static uint8_t Test_Trace[TEST_TRACE_SIZE];
+static uint32_t Test_TraceStart = 0U;
+
+static void Test_SliceEntry(void * Arg)
+{
+    uint32_t Tick;
+
+    while (Test_Stop == FALSE)
+    {
+        Tick = Kernel_GetTick() - Test_TraceStart;
+        if (Tick < TEST_TRACE_SIZE)
+        {
+            Test_Trace[Tick] = (uint8_t)(uintptr_t)Arg;
+        }
+        Kernel_PortSimTick();
+    }
+}
+
+static void Test_RoundRobin(void)
+{
+    uint32_t i, Count[3] = {0U, 0U, 0U};
+
+    Test_Stop = FALSE;
+    Test_TraceStart = Kernel_GetTick();
+    Test_Create(2U, Test_SliceEntry, (void *)1, 3U);
+    Test_Create(3U, Test_SliceEntry, (void *)2, 3U);
+    Kernel_PortSimRun(TEST_TRACE_SIZE);
+    for (i = 0U; i < TEST_TRACE_SIZE; i++)
+    {
+        Count[Test_Trace[i]]++;
+        /*The running task changes at each time slice only*/
+        TEST_CHECK(Test_Trace[i] == (((i / KERNEL_TIME_SLICE) % 2U) + 1U));
+    }
+    TEST_CHECK(Count[0] == 0U);
+    TEST_CHECK((Count[1] + Count[2]) == TEST_TRACE_SIZE);
+    Test_Stop = TRUE;
+    Kernel_PortSimRun(KERNEL_TIME_SLICE + 2U);
+    TEST_CHECK(Test_Tasks[2].State == KERNEL_TASK_DORMANT);
+    TEST_CHECK(Test_Tasks[3].State == KERNEL_TASK_DORMANT);
+}
+
+/*3. Semaphore: timeout, then a give from a lower priority task wakes the waiting task at once*/
+static Kernel_Sem_t Test_Sem;
+static uint8_t Test_SemResult[3];
+static uint32_t Test_SemTick[2];
+static volatile uint8_t Test_Given = FALSE;
+
+static void Test_WaiterEntry(void * Arg)
+{
+    (void)Arg;
+    Test_SemResult[0] = Kernel_SemTake(&Test_Sem, 20U);
+    Test_SemTick[0] = Kernel_GetTick();
+    Test_SemResult[1] = Kernel_SemTake(&Test_Sem, 50U);
+    Test_SemTick[1] = Kernel_GetTick();
+    /*Preempted the giver before it returned from Kernel_SemGive*/
+    Test_SemResult[2] = Test_Given;
+}
+
+static void Test_GiverEntry(void * Arg)
+{
+    (void)Arg;
+    Kernel_Delay(27U);
+    Kernel_SemGive(&Test_Sem);
+    Test_Given = TRUE;
+}
+
+static void Test_Semaphore(void)
+{
+    uint32_t Start = Kernel_GetTick();
+
+    Kernel_SemInit(&Test_Sem, 0U);
+    Test_Create(4U, Test_WaiterEntry, NULL, 2U);
+    Test_Create(5U, Test_GiverEntry, NULL, 5U);
+    Kernel_PortSimRun(40U);
+    TEST_CHECK(Test_SemResult[0] == FALSE);
+    TEST_CHECK(Test_SemTick[0] == (Start + 20U));
+    TEST_CHECK(Test_SemResult[1] == TRUE);
+    TEST_CHECK(Test_SemTick[1] == (Start + 27U));
+    TEST_CHECK(Test_SemResult[2] == FALSE);
+    TEST_CHECK(Test_Given == TRUE);
+    TEST_CHECK(Test_Sem.Count == 0U);
+    TEST_CHECK(Test_Sem.WaitList == NULL);
+    /*No waiting task: the unit is kept*/
+    TEST_CHECK(Kernel_SemTake(&Test_Sem, KERNEL_NO_WAIT) == FALSE);
+    Kernel_SemGive(&Test_Sem);
+    TEST_CHECK(Kernel_SemTake(&Test_Sem, KERNEL_NO_WAIT) == TRUE);
+}
+
+/*4. Message queue: FIFO order, the sender blocks on a full queue and the receiver on an empty one*/
+#define TEST_QUEUE_CAPACITY         4U
+#define TEST_QUEUE_ITEMS            10U
+#define TEST_QUEUE_LATE_ITEM        100U
+
+static Kernel_Queue_t Test_Queue;
+static uint32_t Test_QueueBuffer[TEST_QUEUE_CAPACITY];
+static uint32_t Test_Received[TEST_QUEUE_ITEMS + 1U];
+static uint32_t Test_ReceivedNum = 0U;
+static uint32_t Test_Sent = 0U;
+static uint32_t Test_SentBeforeReceiver = 0U;
+static uint16_t Test_MaxCount = 0U;
+static uint32_t Test_LateSendTick = 0U;
+static uint32_t Test_LateReceiveTick = 0U;
+static uint8_t Test_TimedReceive = TRUE;
+
+static void Test_SenderEntry(void * Arg)
+{
+    uint32_t i, Item;
+
+    (void)Arg;
+    for (i = 0U; i < TEST_QUEUE_ITEMS; i++)
+    {
+        TEST_CHECK(Kernel_QueueSend(&Test_Queue, &i, KERNEL_WAIT_FOREVER) == TRUE);
+        Test_Sent++;
+        if (Test_Queue.Count > Test_MaxCount)
+        {
+            Test_MaxCount = Test_Queue.Count;
+        }
+    }
+    Kernel_Delay(10U);
+    Item = TEST_QUEUE_LATE_ITEM;
+    Test_LateSendTick = Kernel_GetTick();
+    TEST_CHECK(Kernel_QueueSend(&Test_Queue, &Item, KERNEL_NO_WAIT) == TRUE);
+}
+
+static void Test_ReceiverEntry(void * Arg)
+{
+    uint32_t Item;
+
+    (void)Arg;
+    Test_SentBeforeReceiver = Test_Sent;
+    while (Test_ReceivedNum < TEST_QUEUE_ITEMS)
+    {
+        TEST_CHECK(Kernel_QueueReceive(&Test_Queue, &Test_Received[Test_ReceivedNum], KERNEL_WAIT_FOREVER) == TRUE);
+        Test_ReceivedNum++;
+    }
+    /*Empty queue: a short wait times out, a long one gets the late item*/
+    Test_TimedReceive = Kernel_QueueReceive(&Test_Queue, &Item, 3U);
+    TEST_CHECK(Kernel_QueueReceive(&Test_Queue, &Test_Received[Test_ReceivedNum], KERNEL_WAIT_FOREVER) == TRUE);
+    Test_LateReceiveTick = Kernel_GetTick();
+    Test_ReceivedNum++;
+}
+
+static void Test_MessageQueue(void)
+{
+    uint32_t i, Item = 0U;
+
+    TEST_CHECK(Kernel_QueueInit(&Test_Queue, Test_QueueBuffer, sizeof(uint32_t), TEST_QUEUE_CAPACITY) == TRUE);
+    Test_Create(6U, Test_SenderEntry, NULL, 2U);
+    Test_Create(7U, Test_ReceiverEntry, NULL, 3U);
+    Kernel_PortSimRun(20U);
+    /*The higher priority sender filled the queue and blocked before the receiver ran*/
+    TEST_CHECK(Test_SentBeforeReceiver == TEST_QUEUE_CAPACITY);
+    TEST_CHECK(Test_MaxCount == TEST_QUEUE_CAPACITY);
+    TEST_CHECK(Test_ReceivedNum == (TEST_QUEUE_ITEMS + 1U));
+    for (i = 0U; i < TEST_QUEUE_ITEMS; i++)
+    {
+        TEST_CHECK(Test_Received[i] == i);
+    }
+    TEST_CHECK(Test_TimedReceive == FALSE);
+    TEST_CHECK(Test_Received[TEST_QUEUE_ITEMS] == TEST_QUEUE_LATE_ITEM);
+    TEST_CHECK(Test_LateReceiveTick == Test_LateSendTick);
+    TEST_CHECK(Test_Tasks[6].State == KERNEL_TASK_DORMANT);
+    TEST_CHECK(Test_Tasks[7].State == KERNEL_TASK_DORMANT);
+    /*Full queue without waiting*/
+    for (i = 0U; i < TEST_QUEUE_CAPACITY; i++)
+    {
+        TEST_CHECK(Kernel_QueueSend(&Test_Queue, &i, KERNEL_NO_WAIT) == TRUE);
+    }
+    TEST_CHECK(Kernel_QueueSend(&Test_Queue, &i, KERNEL_NO_WAIT) == FALSE);
+    TEST_CHECK(Kernel_QueueReceive(&Test_Queue, &Item, KERNEL_NO_WAIT) == TRUE);
+    TEST_CHECK(Item == 0U);
+}
+
+/*5. CPU usage: a busy task gets most of the cycles, the counters add up*/
+static void Test_BusyEntry(void * Arg)
+{
+    volatile uint32_t Spin;
+    uint32_t Ticks;
+
+    (void)Arg;
+    for (Ticks = 0U; Ticks < 20U; Ticks++)
+    {
+        for (Spin = 0U; Spin < 200000U; Spin++)
+        {
+        }
+        Kernel_PortSimTick();
+    }
+}
+
+static void Test_CpuUsage(void)
+{
+    const Kernel_Stats_t * pStats = Kernel_GetStats();
+    uint64_t TotalStart = pStats->TotalCycles;
+    uint64_t TasksStart = 0U, TasksEnd = 0U;
+    uint32_t Switches = pStats->SwitchCount;
+    uint32_t Load = 0U;
+    Kernel_Task_t * pBusy;
+    uint8_t i;
+
+    for (i = 0U; i < TEST_TASK_NUM; i++)
+    {
+        TasksStart += Test_Tasks[i].RunCycles;
+    }
+    pBusy = Test_Create(8U, Test_BusyEntry, NULL, 3U);
+    Kernel_PortSimRun(30U);
+    TEST_CHECK(pBusy->State == KERNEL_TASK_DORMANT);
+    TEST_CHECK(pBusy->SwitchCount == 1U);
+    TEST_CHECK(pStats->SwitchCount > Switches);
+    /*The busy task took at least 80 percent of the cycles, the rest went to the idle task*/
+    TEST_CHECK((pBusy->RunCycles * 10U) >= ((pStats->TotalCycles - TotalStart) * 8U));
+    for (i = 0U; i < TEST_TASK_NUM; i++)
+    {
+        TasksEnd += Test_Tasks[i].RunCycles;
+        Load += Kernel_GetTaskLoad(&Test_Tasks[i]);
+    }
+    TEST_CHECK((TasksEnd - TasksStart) == pBusy->RunCycles);
+    TEST_CHECK(Load <= 1000U);
+    TEST_CHECK(Kernel_GetTaskLoad(pBusy) == (uint32_t)((pBusy->RunCycles * 1000U) / pStats->TotalCycles));
+    TEST_CHECK(Kernel_GetStackFree(pBusy) == TEST_STACK_SIZE);
+}
+
+int main(void)
+{
+    Kernel_Init();
+    Kernel_Start();
+    Test_Preemption();
+    Test_RoundRobin();
+    Test_Semaphore();
+    Test_MessageQueue();
+    Test_CpuUsage();
+
+    printf("%s\n", (Test_Failures == 0U) ? "kernel: OK" : "kernel: FAILED");
+    return (Test_Failures == 0U) ? 0 : 1;
+}
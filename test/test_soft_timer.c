@@ -0,0 +1,163 @@
+/*  Host test of the software timer wheel (soft_timer.c), the timers straddle the 2^32 wrap of the wheel time.
+    The driver is included with TIM7 and the time base replaced by a simulation: the time jumps to each alarm
+    programmed in TIM7, so the timers must fire at their expiry tick without a periodic tick.
+    Build and run from the repository root:
+        gcc -std=gnu11 -Wall -Iheader test/test_soft_timer.c -o test_soft_timer && ./test_soft_timer */
+#include <stdio.h>
+#include "soft_timer.h"
+
+static TIM_RegDef_t Test_Tim7;
+#undef TIM7
+#define TIM7                        (&Test_Tim7)
+#undef TIM7_CLK_ENB
+#define TIM7_CLK_ENB()              ((void)0)
+#define CM4_IRQSave()               0U
+#define CM4_IRQRestore(primask)     ((void)(primask))
+#include "../src/soft_timer.c"
+
+#define TEST_TIMER_NUM              8U
+
+typedef struct
+{
+    SoftTimer_t Timer;
+    uint32_t Timeout;
+    uint32_t Period;
+    uint64_t NextUs;                    /*Simulated time of the next expected expiry*/
+    uint32_t NextTick;                  /*Wheel tick of the next expected expiry*/
+    uint32_t Fired;
+    uint32_t Expected;                  /*Number of expiries to be checked, then the timer is stopped*/
+} Test_Timer_t;
+
+static Test_Timer_t Test_Timers[TEST_TIMER_NUM];
+static uint64_t Test_SimUs = 0U;
+static uint8_t Test_AlarmRunning = FALSE;
+static uint32_t Test_Failures = 0U;
+
+#define TEST_CHECK(Cond) \
+        do { if (!(Cond)) { printf("FAIL line %d: %s\n", __LINE__, #Cond); Test_Failures++; } } while (0)
+
+/*Simulated drivers*/
+uint32_t Timebase_NowUs(void)
+{
+    return (uint32_t)Test_SimUs;
+}
+
+uint8_t TIM_Base_Init(TIM_RegDef_t * TIMx, TIM_Base_Conf_t TIM_BaseConf)
+{
+    (void)TIMx;
+    (void)TIM_BaseConf;
+    return TRUE;
+}
+
+void TIM_Base_IT_Init(TIM_RegDef_t * TIMx, uint8_t Priority)
+{
+    (void)TIMx;
+    (void)Priority;
+}
+
+void TIM_Base_ForceUpdate(TIM_RegDef_t * TIMx)
+{
+    (void)TIMx;
+}
+
+void TIM_Base_Start(TIM_RegDef_t * TIMx)
+{
+    (void)TIMx;
+    Test_AlarmRunning = TRUE;
+}
+
+void TIM_Base_Stop(TIM_RegDef_t * TIMx)
+{
+    (void)TIMx;
+    Test_AlarmRunning = FALSE;
+}
+
+/**
+ * @brief This function checks that a timer fires at its expiry tick and not more than a tick late.
+ *
+ * @param Context Test timer
+ */
+static void Test_TimerCallback(void * Context)
+{
+    Test_Timer_t * pTest = (Test_Timer_t *)Context;
+
+    TEST_CHECK(SoftTimer_Now == pTest->NextTick);
+    TEST_CHECK(Test_SimUs >= pTest->NextUs);
+    TEST_CHECK(Test_SimUs < (pTest->NextUs + (2U * SOFTTIMER_US_PER_TICK)));
+    pTest->Fired++;
+    pTest->NextTick += pTest->Period;
+    pTest->NextUs += (uint64_t)pTest->Period * SOFTTIMER_US_PER_TICK;
+    if (pTest->Fired == pTest->Expected)
+    {
+        SoftTimer_Stop(&pTest->Timer);
+    }
+}
+
+/**
+ * @brief This function starts the test timers from the given wheel time and runs the alarms until the wheel
+ *        is empty.
+ *
+ * @param StartTick Wheel time when the timers are started
+ * @param pTimeouts Timeout of each timer
+ * @param pPeriods Period of each timer
+ * @param Count Number of timers
+ */
+static void Test_Run(uint32_t StartTick, const uint32_t * pTimeouts, const uint32_t * pPeriods, uint8_t Count)
+{
+    uint32_t Steps = 0U;
+    uint8_t i;
+
+    SoftTimer_Now = StartTick;
+    SoftTimer_Behind = 0U;
+    for (i = 0U; i < Count; i++)
+    {
+        Test_Timers[i].Timeout  = pTimeouts[i];
+        Test_Timers[i].Period   = pPeriods[i];
+        Test_Timers[i].NextTick = StartTick + pTimeouts[i];
+        Test_Timers[i].NextUs   = Test_SimUs + ((uint64_t)pTimeouts[i] * SOFTTIMER_US_PER_TICK);
+        Test_Timers[i].Fired    = 0U;
+        Test_Timers[i].Expected = (pPeriods[i] != 0U) ? 3U : 1U;
+        SoftTimer_Create(&Test_Timers[i].Timer, Test_TimerCallback, &Test_Timers[i]);
+        TEST_CHECK(SoftTimer_Start(&Test_Timers[i].Timer, pTimeouts[i], pPeriods[i]) == TRUE);
+    }
+    /*Jump to each alarm*/
+    while ((Test_AlarmRunning == TRUE) && (Steps < 2000000U))
+    {
+        Test_SimUs += (uint64_t)(Test_Tim7.ARR + 1U) * SOFTTIMER_US_PER_COUNT;
+        SoftTimer_IRQHandling();
+        Steps++;
+    }
+    TEST_CHECK(SoftTimer_GetArmedCount() == 0U);
+    for (i = 0U; i < Count; i++)
+    {
+        if (Test_Timers[i].Fired != Test_Timers[i].Expected)
+        {
+            printf("FAIL timer %u (timeout %u, period %u) fired %u times\n", i, pTimeouts[i], pPeriods[i],
+                   Test_Timers[i].Fired);
+            Test_Failures++;
+        }
+    }
+}
+
+int main(void)
+{
+    /*One timer per level, one beyond the wheel range (2^24 ticks) and periodic timers, all crossing the wrap*/
+    static const uint32_t Timeouts[TEST_TIMER_NUM] = {1500U, 70000U, 300000U, 5000000U, 20000000U,
+                                                      SOFTTIMER_MAX_TIMEOUT, 900U, 100000U};
+    static const uint32_t Periods[TEST_TIMER_NUM] = {0U, 0U, 0U, 0U, 0U, 0U, 700U, 4000000U};
+    static const uint32_t Short[2] = {10U, 64U};
+    static const uint32_t NoPeriod[2] = {0U, 0U};
+
+    SoftTimer_Init(0U);
+    /*Timers of less than 64 ticks before the wrap*/
+    Test_Run(0xFFFFFFF0U, Short, NoPeriod, 2U);
+    /*Timers of all the levels started just before the wrap*/
+    Test_Run(0xFFFFFC00U, Timeouts, Periods, TEST_TIMER_NUM);
+    /*The same timers started far from the wrap*/
+    Test_Run(0x12345678U, Timeouts, Periods, TEST_TIMER_NUM);
+    /*Started when the wheel time is a multiple of every level width*/
+    Test_Run(0U, Timeouts, Periods, TEST_TIMER_NUM);
+
+    printf("%s\n", (Test_Failures == 0U) ? "soft timer: OK" : "soft timer: FAILED");
+    return (Test_Failures == 0U) ? 0 : 1;
+}